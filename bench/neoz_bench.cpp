@@ -0,0 +1,452 @@
+/**
+ * neoz_bench - Microbenchmarks for the Neo-Z sensitivity stack
+ *
+ * Measures the hook-path building blocks in isolation and prints one JSON
+ * document (Google Benchmark style) so CI can diff runs:
+ *
+ *   neoz_bench [--filter=<substring>] [--min-time=<seconds>] [--out=<file.json>]
+ *
+ * Per benchmark:
+ *   ns_per_op      mean over all timed iterations
+ *   allocs_per_op  global operator new calls (aligned forms included) / iterations
+ *   p50/p99/p999   per-op latency, each sample averaging SAMPLE_OPS calls
+ *                  (steady_clock resolution is too coarse for single ~10 ns ops)
+ */
+
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include "core/aim/ReticleClassifier.h"
+#include "core/config/FastConfig.h"
+#include "core/ipc/MessageFraming.h"
+#include "core/perf/FastConf.hpp"
+#include "core/sensitivity/DRCS.h"
+#include "core/sensitivity/PipelineKernels.h"
+#include "core/sensitivity/SensitivityCalculator.h"
+#include "core/sensitivity/SensitivityPipeline.h"
+#include "core/sensitivity/VelocityCurve.h"
+#include "zereca/arbiter/ProbationLedger.h"
+#include "zereca/core/FlightRecorder.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// ========== ALLOCATION COUNTING ==========
+
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+}
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+// Over-aligned types (alignas > __STDCPP_DEFAULT_NEW_ALIGNMENT__, e.g. the
+// 64-byte PipelineParams) go through the align_val_t forms
+namespace {
+
+void* countedAlignedAlloc(std::size_t size, std::align_val_t align)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t alignment = static_cast<std::size_t>(align);
+#ifdef _WIN32
+    // Neither the MSVC nor the MinGW CRT has aligned_alloc
+    void* p = _aligned_malloc(size ? size : 1, alignment);
+#else
+    // aligned_alloc wants the size rounded up to the alignment
+    void* p = std::aligned_alloc(alignment, (std::max<std::size_t>(size, 1) + alignment - 1) / alignment * alignment);
+#endif
+    if (p) return p;
+    throw std::bad_alloc();
+}
+
+void alignedFree(void* p) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace
+
+void* operator new(std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+
+namespace {
+
+// ========== HARNESS ==========
+
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+using Clock = std::chrono::steady_clock;
+constexpr size_t SAMPLE_OPS = 16;
+constexpr size_t MAX_SAMPLES = 1 << 20;
+
+struct BenchResult {
+    QString name;
+    uint64_t iterations = 0;
+    double nsPerOp = 0.0;
+    double allocsPerOp = 0.0;
+    double p50 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+};
+
+struct Benchmark {
+    QString name;
+    std::function<void()> op;   // One operation
+};
+
+BenchResult runBenchmark(const Benchmark& bench, double minTimeSec)
+{
+    // Warm up caches, branch predictors and lazily built state
+    for (size_t i = 0; i < 10000; ++i) bench.op();
+
+    std::vector<double> samples;
+    samples.reserve(MAX_SAMPLES);
+
+    const auto budget = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(minTimeSec));
+    const uint64_t allocsBefore = g_allocations.load(std::memory_order_relaxed);
+    const auto start = Clock::now();
+    auto now = start;
+
+    while (now - start < budget && samples.size() < MAX_SAMPLES) {
+        const auto t0 = Clock::now();
+        for (size_t i = 0; i < SAMPLE_OPS; ++i) bench.op();
+        now = Clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(now - t0).count() / SAMPLE_OPS);
+    }
+
+    // The samples vector was reserved up front, so it contributes nothing
+    const uint64_t allocs = g_allocations.load(std::memory_order_relaxed) - allocsBefore;
+
+    BenchResult r;
+    r.name = bench.name;
+    r.iterations = samples.size() * SAMPLE_OPS;
+    double total = 0.0;
+    for (double s : samples) total += s;
+    r.nsPerOp = samples.empty() ? 0.0 : total / samples.size();
+    r.allocsPerOp = r.iterations ? static_cast<double>(allocs) / r.iterations : 0.0;
+
+    std::sort(samples.begin(), samples.end());
+    auto pct = [&](double p) {
+        if (samples.empty()) return 0.0;
+        size_t idx = std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+        return samples[idx];
+    };
+    r.p50 = pct(0.50);
+    r.p99 = pct(0.99);
+    r.p999 = pct(0.999);
+    return r;
+}
+
+QJsonObject toJson(const BenchResult& r)
+{
+    QJsonObject o;
+    o["name"] = r.name;
+    o["iterations"] = static_cast<qint64>(r.iterations);
+    o["ns_per_op"] = r.nsPerOp;
+    o["allocs_per_op"] = r.allocsPerOp;
+    o["p50_ns"] = r.p50;
+    o["p99_ns"] = r.p99;
+    o["p999_ns"] = r.p999;
+    o["time_unit"] = "ns";
+    return o;
+}
+
+// ========== INPUT FIXTURES ==========
+
+// Deterministic pseudo-random mouse deltas (LCG), 8 kHz timestamps
+struct DeltaStream {
+    static constexpr size_t SIZE = 4096;
+    std::array<NeoZ::InputState, SIZE> events;
+    size_t next = 0;
+    int64_t timestampNs = 1'000'000'000;
+
+    DeltaStream()
+    {
+        uint32_t seed = 12345;
+        for (auto& e : events) {
+            seed = seed * 1664525u + 1013904223u;
+            e.deltaX = static_cast<int>((seed >> 16) % 41) - 20;
+            seed = seed * 1664525u + 1013904223u;
+            e.deltaY = static_cast<int>((seed >> 16) % 41) - 20;
+            e.velocity = std::sqrt(e.deltaX * e.deltaX + e.deltaY * e.deltaY);
+        }
+    }
+
+    const NeoZ::InputState& take()
+    {
+        NeoZ::InputState& e = events[next++ & (SIZE - 1)];
+        timestampNs += 125'000;
+        e.timestamp = Clock::time_point(std::chrono::nanoseconds(timestampNs));
+        return e;
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QString filter;
+    double minTime = 0.5;
+    QString outPath;
+    for (const QString& arg : app.arguments().mid(1)) {
+        if (arg.startsWith("--filter=")) filter = arg.mid(9);
+        else if (arg.startsWith("--min-time=")) minTime = arg.mid(11).toDouble();
+        else if (arg.startsWith("--out=")) outPath = arg.mid(6);
+        else {
+            std::fprintf(stderr, "usage: neoz_bench [--filter=<substring>] [--min-time=<s>] [--out=<file>]\n");
+            return 2;
+        }
+    }
+
+    // Keep component logging out of the measurements
+    qInstallMessageHandler([](QtMsgType, const QMessageLogContext&, const QString&) {});
+
+    // ----- Fixtures -----
+    NeoZ::SensitivityPipeline pipeline;
+    pipeline.setInputAuthorityEnabled(true);
+    pipeline.setSmoothingMs(16.0);
+
+    NeoZ::SensitivityPipeline batchPipeline;
+    batchPipeline.setInputAuthorityEnabled(true);
+    batchPipeline.setSmoothingMs(16.0);
+    constexpr size_t BATCH = 64;
+    std::vector<NeoZ::InputState> batchIn(BATCH), batchOut(BATCH);
+
+    NeoZ::VelocityCurve curve;
+    curve.applyPreset(NeoZ::VelocityCurve::OneTap);
+    NeoZ::VelocityCurve lutCurve;
+    lutCurve.applyPreset(NeoZ::VelocityCurve::OneTap);
+    lutCurve.setLutEnabled(true);
+
+    DRCS drcs;
+    drcs.setEnabled(true);
+
+    NeoZ::SensitivityCalculator::Parameters calcParams;
+    calcParams.mouseDpi = 1600;
+
+    NeoZ::FastConf<float, 64> fastConf;
+    uint32_t hitSeed = 1;
+
+    QTemporaryDir tempDir;
+    NeoZ::FastConfig config(tempDir.filePath("bench.ini"));
+    config.setDouble("sensitivity/x", 1.25);
+    config.setString("profile/name", "bench");
+    config.flush();
+
+    DeltaStream stream;
+    double velocity = 0.0;
+
+    // 1080p frame, white reticle, scanned with the default 5x5 and a 33 px ring
+    QImage frame(1920, 1080, QImage::Format_RGB32);
+    frame.fill(qRgb(240, 240, 240));
+    NeoZ::ReticleClassifier squareRoi;
+    NeoZ::ReticleClassifier ringRoi;
+    ringRoi.setShape(NeoZ::ReticleClassifier::Style::Ring, 16, 3);
+
+    // Telemetry-sized IPC message, decoded from a reusable buffer
+    QJsonObject telemetry;
+    telemetry["type"] = "Telemetry";
+    telemetry["dx"] = 3;
+    telemetry["dy"] = -7;
+    telemetry["sensitivity"] = 1.25;
+    telemetry["velocity"] = 0.8125;
+    telemetry["aimAssist"] = true;
+    telemetry["timestampUs"] = static_cast<qint64>(1'700'000'000'000'000);
+    QByteArray wire;
+    QBuffer wireBuffer(&wire);
+    auto decode = [&](NeoZ::MessageFraming::Mode mode) {
+        wireBuffer.close();
+        wire = NeoZ::MessageFraming::encode(telemetry, mode);
+        wireBuffer.open(QIODevice::ReadOnly);
+        QJsonObject msg;
+        NeoZ::MessageFraming::read(&wireBuffer, &msg);
+        return msg;
+    };
+
+    // Audit ring, written from the reconciler / arbiter threads in the app
+    Zereca::FlightRecorder recorder;
+    Zereca::StateChangeRecord change;
+    change.timestamp = static_cast<uint64_t>(QDateTime::currentMSecsSinceEpoch());
+    change.component = Zereca::Component::TIMER_RESOLUTION;
+
+    // Probation gate checked by every arbiter evaluation
+    Zereca::ProbationLedger ledger(tempDir.path());
+    Zereca::SystemContext ledgerContext;
+    for (uint64_t hash = 0; hash < 256; hash += 2) {
+        ledger.addToProbation(hash, Zereca::Severity::MEDIUM, ledgerContext);
+    }
+    std::vector<uint64_t> candidates(64);
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        candidates[i] = i * 3;
+    }
+    uint64_t probeHash = 0;
+
+    const std::vector<Benchmark> benchmarks = {
+        {"SensitivityPipeline/process", [&] {
+            doNotOptimize(pipeline.process(stream.take()));
+        }},
+        {"SensitivityPipeline/processBatch64", [&] {
+            // One op = one event (batch cost / 64)
+            static size_t slot = 0;
+            batchIn[slot] = stream.take();
+            if (++slot == BATCH) {
+                batchPipeline.processBatch(batchIn, batchOut);
+                doNotOptimize(batchOut[BATCH - 1]);
+                slot = 0;
+            }
+        }},
+        {"VelocityCurve/apply", [&] {
+            velocity = velocity < 3.0 ? velocity + 0.0137 : 0.0;
+            doNotOptimize(curve.apply(velocity));
+        }},
+        {"VelocityCurve/apply_lut", [&] {
+            velocity = velocity < 3.0 ? velocity + 0.0137 : 0.0;
+            doNotOptimize(lutCurve.apply(velocity));
+        }},
+        {"DRCS/processInput", [&] {
+            const auto& e = stream.take();
+            doNotOptimize(drcs.processInput(e.deltaX, e.deltaY));
+        }},
+        {"SensitivityCalculator/calculate", [&] {
+            doNotOptimize(NeoZ::SensitivityCalculator::calculate(stream.take(), 1.1, calcParams));
+        }},
+        {"FastConf/add", [&] {
+            hitSeed = hitSeed * 1664525u + 1013904223u;
+            fastConf.add((hitSeed >> 31) != 0);
+        }},
+        {"FastConf/confidence", [&] {
+            doNotOptimize(fastConf.confidence());
+        }},
+        {"ReticleClassifier/square5", [&] {
+            doNotOptimize(squareRoi.classify(frame).red);
+        }},
+        {"ReticleClassifier/ring33", [&] {
+            doNotOptimize(ringRoi.classify(frame).red);
+        }},
+        {"MessageFraming/json_roundtrip", [&] {
+            doNotOptimize(decode(NeoZ::MessageFraming::Mode::Json));
+        }},
+        {"MessageFraming/cbor_roundtrip", [&] {
+            doNotOptimize(decode(NeoZ::MessageFraming::Mode::Cbor));
+        }},
+        {"FastConfig/get", [&] {
+            doNotOptimize(config.get("sensitivity/x", 1.0));
+        }},
+        {"FastConfig/getDouble", [&] {
+            doNotOptimize(config.getDouble("sensitivity/x", 1.0));
+        }},
+        {"FlightRecorder/record", [&] {
+            change.newVal++;
+            recorder.record(change);
+        }},
+        {"ProbationLedger/isOnProbation", [&] {
+            doNotOptimize(ledger.isOnProbation(probeHash++ & 255, ledgerContext));
+        }},
+        {"ProbationLedger/isOnProbationBatch64", [&] {
+            // One op = one candidate (batch cost / 64)
+            static size_t slot = 0;
+            if (++slot == candidates.size()) {
+                slot = 0;
+                doNotOptimize(ledger.isOnProbation(candidates, ledgerContext));
+            }
+        }},
+    };
+
+    QJsonArray results;
+    for (const auto& bench : benchmarks) {
+        if (!filter.isEmpty() && !bench.name.contains(filter)) continue;
+        BenchResult r = runBenchmark(bench, minTime);
+        results.append(toJson(r));
+        std::fprintf(stderr, "%-40s %10.2f ns/op %8.3f allocs/op  p50 %8.2f  p99 %8.2f  p999 %8.2f\n",
+                     qPrintable(r.name), r.nsPerOp, r.allocsPerOp, r.p50, r.p99, r.p999);
+    }
+
+    QJsonObject context;
+    context["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    context["executable"] = QCoreApplication::applicationFilePath();
+    context["num_cpus"] = QThread::idealThreadCount();
+    context["cpu_arch"] = QSysInfo::currentCpuArchitecture();
+    context["kernel_isa"] = QString::fromLatin1(NeoZ::PipelineKernels::isaName(NeoZ::PipelineKernels::activeIsa()));
+    context["sample_ops"] = static_cast<int>(SAMPLE_OPS);
+    context["min_time_s"] = minTime;
+#ifdef NDEBUG
+    context["build_type"] = "release";
+#else
+    context["build_type"] = "debug";
+#endif
+
+    QJsonObject root;
+    root["context"] = context;
+    root["benchmarks"] = results;
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+
+    if (outPath.isEmpty()) {
+        std::fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+    } else {
+        QFile out(outPath);
+        if (!out.open(QIODevice::WriteOnly)) {
+            std::fprintf(stderr, "cannot write %s\n", qPrintable(outPath));
+            return 1;
+        }
+        out.write(json);
+    }
+    return 0;
+}
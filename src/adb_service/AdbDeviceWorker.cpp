@@ -0,0 +1,272 @@
+#include "AdbDeviceWorker.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QRegularExpression>
+#include <memory>
+
+namespace NeoZ {
+
+AdbDeviceWorker::AdbDeviceWorker(const QString& deviceId, const QString& adbPath)
+    : m_deviceId(deviceId)
+    , m_adbPath(adbPath)
+{
+}
+
+AdbDeviceWorker::~AdbDeviceWorker()
+{
+    // Owned AdbConnection (and its shell) goes with us, on the worker thread
+    qDebug() << "[AdbDeviceWorker] Stopped worker for" << m_deviceId;
+}
+
+void AdbDeviceWorker::setAdbPath(const QString& path)
+{
+    m_adbPath = path;
+    if (m_connection) {
+        m_connection->setAdbPath(path);
+    }
+}
+
+AdbConnection* AdbDeviceWorker::connection()
+{
+    if (m_connection) {
+        if (m_connection->isConnected() || m_connection->connect(m_deviceId)) {
+            return m_connection;
+        }
+        // Failed, drop the stale connection
+        delete m_connection;
+        m_connection = nullptr;
+    }
+
+    auto* conn = new AdbConnection(this);
+    conn->setAdbPath(m_adbPath);
+    if (!conn->connect(m_deviceId)) {
+        delete conn;
+        return nullptr;
+    }
+
+    m_connection = conn;
+    return conn;
+}
+
+QJsonObject AdbDeviceWorker::errorResponse(const QString& message)
+{
+    QJsonObject error;
+    error["success"] = false;
+    error["error"] = message;
+    return error;
+}
+
+void AdbDeviceWorker::handleRequest(quint64 ticket, const QJsonObject& request)
+{
+    const QString type = request["type"].toString();
+
+    if (!connection()) {
+        emit requestFinished(ticket, errorResponse("Failed to connect to device"));
+        return;
+    }
+
+    if (type == "GetEmulatorState") {
+        handleGetEmulatorState(ticket);
+    } else if (type == "Execute") {
+        handleExecute(ticket, request);
+    } else if (type == "ExecuteBatch") {
+        handleExecuteBatch(ticket, request);
+    } else if (type == "IsFreeFireRunning") {
+        handleIsFreeFireRunning(ticket);
+    } else {
+        emit requestFinished(ticket, errorResponse("Unknown request type: " + type));
+    }
+}
+
+void AdbDeviceWorker::runCommands(const QStringList& commands, int timeoutMs, BatchCallback done)
+{
+    if (commands.isEmpty()) {
+        done({}, 0);
+        return;
+    }
+
+    AdbShellSession* session = m_connection->session();
+
+    if (!session->ensureRunning()) {
+        // No persistent shell: one-shot fallback, blocks this device only
+        QElapsedTimer timer;
+        timer.start();
+        auto batch = m_connection->executeBatch(commands, timeoutMs);
+        QList<CommandResult> results;
+        for (int i = 0; i < commands.size(); ++i) {
+            CommandResult r;
+            r.ok = batch.success && i < batch.results.size();
+            r.exitCode = r.ok ? 0 : -1;
+            r.output = r.ok ? batch.results[i] : QString();
+            results << r;
+        }
+        done(results, timer.elapsed());
+        return;
+    }
+
+    struct State {
+        QList<CommandResult> results;
+        int remaining = 0;
+        QElapsedTimer timer;
+        BatchCallback done;
+    };
+    auto state = std::make_shared<State>();
+    state->results.resize(commands.size());
+    state->remaining = static_cast<int>(commands.size());
+    state->done = std::move(done);
+    state->timer.start();
+
+    // The timeout is per command and only runs while it executes, so
+    // commands queued ahead of it by other clients don't eat into it
+    for (int i = 0; i < commands.size(); ++i) {
+        session->submit(commands[i], [state, i](const AdbShellSession::Result& r) {
+            CommandResult& out = state->results[i];
+            out.output = r.output.trimmed();
+            out.exitCode = r.exitCode;
+            out.ok = r.ok;
+            out.timedOut = r.timedOut;
+            if (--state->remaining == 0) {
+                state->done(state->results, state->timer.elapsed());
+            }
+        }, timeoutMs);
+    }
+}
+
+void AdbDeviceWorker::handleGetEmulatorState(quint64 ticket)
+{
+    // Served from the connection's cache, shared with IsFreeFireRunning;
+    // concurrent requests join the same fetches
+    const QList<QPair<QString, int>> queries = {
+        {AdbConnection::SCREEN_SIZE_COMMAND, AdbConnection::DISPLAY_TTL_MS},
+        {AdbConnection::DENSITY_COMMAND, AdbConnection::DISPLAY_TTL_MS},
+        {AdbConnection::FREEFIRE_PID_COMMAND, AdbConnection::PID_TTL_MS},
+        {AdbConnection::FOCUS_COMMAND, AdbConnection::FOCUS_TTL_MS}
+    };
+
+    struct State {
+        QList<CommandResult> results;
+        int remaining = 0;
+    };
+    auto state = std::make_shared<State>();
+    state->results.resize(queries.size());
+    state->remaining = static_cast<int>(queries.size());
+
+    auto finish = [this, ticket, state]() {
+        const QList<CommandResult>& results = state->results;
+        QJsonObject response;
+        bool success = true;
+        for (const CommandResult& r : results) {
+            success = success && r.ok;
+        }
+        response["success"] = success;
+
+        if (success) {
+            // Parse screen size
+            QRegularExpression sizeRx("(\\d+)x(\\d+)");
+            auto match = sizeRx.match(results[0].output);
+            if (match.hasMatch()) {
+                response["screenWidth"] = match.captured(1).toInt();
+                response["screenHeight"] = match.captured(2).toInt();
+            }
+
+            // Parse density
+            QRegularExpression densityRx("(\\d+)");
+            match = densityRx.match(results[1].output);
+            if (match.hasMatch()) {
+                response["density"] = match.captured(1).toInt();
+            }
+
+            // Free Fire running
+            response["freeFireRunning"] = !results[2].output.isEmpty();
+
+            // Current focus
+            response["currentFocus"] = results[3].output;
+        }
+
+        emit requestFinished(ticket, response);
+    };
+
+    for (int i = 0; i < queries.size(); ++i) {
+        m_connection->getCachedAsync(queries[i].first, queries[i].second,
+                                     [state, i, finish](const QString& value, bool ok) {
+            CommandResult& out = state->results[i];
+            out.output = value;
+            out.exitCode = ok ? 0 : -1;
+            out.ok = ok;
+            if (--state->remaining == 0) {
+                finish();
+            }
+        });
+    }
+}
+
+void AdbDeviceWorker::handleExecute(quint64 ticket, const QJsonObject& request)
+{
+    const QString command = request["command"].toString();
+    const int timeoutMs = request["timeoutMs"].toInt(DEFAULT_TIMEOUT_MS);
+
+    runCommands({command}, timeoutMs, [this, ticket](const QList<CommandResult>& results, qint64 elapsedMs) {
+        const CommandResult& r = results.first();
+        QJsonObject response;
+        response["success"] = !r.timedOut;
+        response["result"] = r.ok ? r.output : QString();
+        response["exitCode"] = r.exitCode;
+        response["timeMs"] = elapsedMs;
+        if (r.timedOut) {
+            response["error"] = QString("Command timed out");
+            response["timedOut"] = true;
+        }
+        emit requestFinished(ticket, response);
+    });
+}
+
+void AdbDeviceWorker::handleExecuteBatch(quint64 ticket, const QJsonObject& request)
+{
+    QStringList commands;
+    for (const auto& cmd : request["commands"].toArray()) {
+        commands << cmd.toString();
+    }
+    const int timeoutMs = request["timeoutMs"].toInt(DEFAULT_BATCH_TIMEOUT_MS);
+
+    runCommands(commands, timeoutMs, [this, ticket](const QList<CommandResult>& results, qint64 elapsedMs) {
+        QJsonObject response;
+        QJsonArray outputs;
+        QJsonArray exitCodes;
+        bool success = true;
+        bool timedOut = false;
+        for (const CommandResult& r : results) {
+            outputs.append(r.output);
+            exitCodes.append(r.exitCode);
+            success = success && r.ok;
+            timedOut = timedOut || r.timedOut;
+        }
+        response["success"] = success;
+        if (timedOut) {
+            response["error"] = QString("Command timed out");
+            response["timedOut"] = true;
+        }
+        response["totalTimeMs"] = elapsedMs;
+        response["results"] = outputs;
+        response["exitCodes"] = exitCodes;
+        emit requestFinished(ticket, response);
+    });
+}
+
+void AdbDeviceWorker::handleIsFreeFireRunning(quint64 ticket)
+{
+    // Served from the connection's 500 ms cache most of the time
+    m_connection->getCachedAsync(AdbConnection::FREEFIRE_PID_COMMAND, AdbConnection::PID_TTL_MS,
+                                 [this, ticket](const QString& pid, bool ok) {
+        // A failed fetch must not read as "not running"
+        QJsonObject response;
+        response["success"] = ok;
+        response["running"] = ok && !pid.isEmpty();
+        if (!ok) {
+            response["error"] = QString("Could not query the device");
+        }
+        emit requestFinished(ticket, response);
+    });
+}
+
+} // namespace NeoZ
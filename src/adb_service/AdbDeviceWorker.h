@@ -0,0 +1,78 @@
+#ifndef NEOZ_ADBDEVICEWORKER_H
+#define NEOZ_ADBDEVICEWORKER_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <QStringList>
+#include <functional>
+#include "../core/adb/AdbConnection.h"
+
+namespace NeoZ {
+
+/**
+ * @brief Executes AdbService requests for one device on its own thread.
+ *
+ * AdbService creates one worker (and QThread) per device, so a slow or
+ * wedged emulator never holds up requests for another one or the TCP
+ * event loop. Within a device, commands are pipelined on the connection's
+ * persistent shell session: handleRequest() queues the commands and
+ * returns, and requestFinished() fires when the last result arrives, so
+ * many requests can be in flight at once. GetEmulatorState and
+ * IsFreeFireRunning are answered from the connection's cache, so polling
+ * clients share fetches instead of each running the same commands.
+ *
+ * A request's timeoutMs applies to each of its commands while it runs on
+ * the shell; a command that overruns fails that request alone and the
+ * shared session keeps serving everyone else (see AdbShellSession).
+ *
+ * All slots must be invoked through the worker's thread (queued).
+ */
+class AdbDeviceWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    AdbDeviceWorker(const QString& deviceId, const QString& adbPath);
+    ~AdbDeviceWorker();
+
+    QString deviceId() const { return m_deviceId; }
+
+public slots:
+    void handleRequest(quint64 ticket, const QJsonObject& request);
+    void setAdbPath(const QString& path);
+
+signals:
+    void requestFinished(quint64 ticket, const QJsonObject& response);
+
+private:
+    struct CommandResult {
+        QString output;      // Trimmed stdout
+        int exitCode = -1;
+        bool ok = false;
+        bool timedOut = false;
+    };
+    using BatchCallback = std::function<void(const QList<CommandResult>&, qint64 elapsedMs)>;
+
+    AdbConnection* connection();
+
+    // Pipeline commands on the shell session (blocking fallback without one)
+    void runCommands(const QStringList& commands, int timeoutMs, BatchCallback done);
+
+    void handleGetEmulatorState(quint64 ticket);
+    void handleExecute(quint64 ticket, const QJsonObject& request);
+    void handleExecuteBatch(quint64 ticket, const QJsonObject& request);
+    void handleIsFreeFireRunning(quint64 ticket);
+
+    static QJsonObject errorResponse(const QString& message);
+
+    QString m_deviceId;
+    QString m_adbPath;
+    AdbConnection* m_connection = nullptr;
+
+    static constexpr int DEFAULT_TIMEOUT_MS = 5000;
+    static constexpr int DEFAULT_BATCH_TIMEOUT_MS = 10000;
+};
+
+} // namespace NeoZ
+
+#endif // NEOZ_ADBDEVICEWORKER_H
@@ -2,6 +2,7 @@
 #include <QDebug>
 #include <QJsonArray>
 #include <QProcess>
+#include <QThread>
 
 namespace NeoZ {
 
@@ -9,15 +10,14 @@ AdbService::AdbService(QObject* parent)
     : QObject(parent)
 {
     m_adbPath = "adb"; // Default to PATH
+    m_socketClient = std::make_unique<AdbSocketClient>(this);
+    m_hostPool.setMaxThreadCount(HOST_POOL_THREADS);
 }
 
 AdbService::~AdbService()
 {
     stop();
-    
-    // Cleanup device connections
-    qDeleteAll(m_deviceConnections);
-    m_deviceConnections.clear();
+    stopWorkers();
 }
 
 bool AdbService::start(quint16 port)
@@ -39,9 +39,10 @@ bool AdbService::start(quint16 port)
         return false;
     }
     
+    m_port = m_server->serverPort();   // Port 0 picks a free one
     connect(m_server, &QTcpServer::newConnection, this, &AdbService::onNewConnection);
     
-    qDebug() << "[AdbService] Listening on port" << port;
+    qDebug() << "[AdbService] Listening on port" << m_port;
     emit listeningChanged();
     return true;
 }
@@ -54,6 +55,7 @@ void AdbService::stop()
             client->deleteLater();
         }
         m_clients.clear();
+        m_clientFraming.clear();
         
         m_server->close();
         delete m_server;
@@ -67,8 +69,10 @@ void AdbService::stop()
 void AdbService::setAdbPath(const QString& path)
 {
     m_adbPath = path;
-    for (auto* conn : m_deviceConnections) {
-        conn->setAdbPath(path);
+    for (const DeviceWorker& w : m_workers) {
+        AdbDeviceWorker* worker = w.worker;
+        QMetaObject::invokeMethod(worker, [worker, path]() { worker->setAdbPath(path); },
+                                  Qt::QueuedConnection);
     }
 }
 
@@ -101,6 +105,7 @@ void AdbService::onClientDisconnected()
         }
     }
     
+    m_clientFraming.remove(client);
     client->deleteLater();
     qDebug() << "[AdbService] Client disconnected:" << clientId;
 }
@@ -110,35 +115,31 @@ void AdbService::onReadyRead()
     QTcpSocket* client = qobject_cast<QTcpSocket*>(sender());
     if (!client) return;
     
-    while (client->bytesAvailable() > 0) {
-        QByteArray data = client->readLine();
-        if (data.isEmpty()) continue;
-        
-        QJsonParseError error;
-        QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+    // Only complete frames; a partial request waits for the rest
+    for (;;) {
+        QJsonObject request;
+        QString error;
+        auto result = MessageFraming::read(client, &request, &error);
         
-        if (error.error != QJsonParseError::NoError) {
+        if (result == MessageFraming::ReadResult::Incomplete) {
+            break;
+        } else if (result == MessageFraming::ReadResult::Message) {
+            dispatchRequest(client, request);
+        } else if (result == MessageFraming::ReadResult::Malformed) {
+            if (error.isEmpty()) continue;  // Blank line
             QJsonObject errorResponse;
             errorResponse["success"] = false;
-            errorResponse["error"] = error.errorString();
-            client->write(QJsonDocument(errorResponse).toJson(QJsonDocument::Compact) + "\n");
-            continue;
-        }
-        
-        QJsonObject request = doc.object();
-        QJsonObject response = handleRequest(request);
-        
-        // Copy correlation ID
-        if (request.contains("id")) {
-            response["id"] = request["id"];
+            errorResponse["error"] = error;
+            sendResponse(client, QJsonValue(), errorResponse);
+        } else {
+            qWarning() << "[AdbService] Corrupt stream from client:" << error;
+            client->disconnectFromHost();
+            break;
         }
-        
-        client->write(QJsonDocument(response).toJson(QJsonDocument::Compact) + "\n");
-        client->flush();
     }
 }
 
-QJsonObject AdbService::handleRequest(const QJsonObject& request)
+void AdbService::dispatchRequest(QTcpSocket* client, const QJsonObject& request)
 {
     QString type = request["type"].toString();
     QString deviceId = request["deviceId"].toString();
@@ -146,244 +147,176 @@ QJsonObject AdbService::handleRequest(const QJsonObject& request)
     emit requestReceived(type, deviceId);
     
     if (type == "Ping") {
-        return handlePing(request);
-    } else if (type == "GetDevices") {
-        return handleGetDevices(request);
-    } else if (type == "GetEmulatorState") {
-        return handleGetEmulatorState(request);
-    } else if (type == "Execute") {
-        return handleExecute(request);
-    } else if (type == "ExecuteBatch") {
-        return handleExecuteBatch(request);
-    } else if (type == "IsFreeFireRunning") {
-        return handleIsFreeFireRunning(request);
+        sendResponse(client, request["id"], handlePing(request));
+        return;
     }
     
-    QJsonObject error;
-    error["success"] = false;
-    error["error"] = "Unknown request type: " + type;
-    return error;
-}
-
-QJsonObject AdbService::handlePing(const QJsonObject& request)
-{
-    Q_UNUSED(request)
-    QJsonObject response;
-    response["success"] = true;
-    response["type"] = "Pong";
-    return response;
-}
-
-QJsonObject AdbService::handleGetDevices(const QJsonObject& request)
-{
-    Q_UNUSED(request)
-    
-    QProcess proc;
-    proc.start(m_adbPath, {"devices"});
-    proc.waitForFinished(5000);
-    
-    QString output = QString::fromUtf8(proc.readAllStandardOutput());
-    QStringList lines = output.split('\n', Qt::SkipEmptyParts);
-    
-    QJsonArray devices;
-    for (int i = 1; i < lines.size(); ++i) {
-        QString line = lines[i].trimmed();
-        if (line.isEmpty()) continue;
-        
-        QStringList parts = line.split('\t');
-        if (parts.size() >= 2) {
-            QJsonObject device;
-            device["id"] = parts[0];
-            device["state"] = parts[1];
-            devices.append(device);
+    // Framing negotiation: the reply still uses the old framing
+    if (type == "SetFraming") {
+        MessageFraming::Mode mode;
+        QJsonObject response;
+        response["success"] = MessageFraming::modeFromName(request["framing"].toString(), &mode);
+        if (!response["success"].toBool()) {
+            response["error"] = "Unsupported framing: " + request["framing"].toString();
         }
+        sendResponse(client, request["id"], response);
+        if (response["success"].toBool()) {
+            m_clientFraming[client] = mode;
+        }
+        return;
     }
     
-    QJsonObject response;
-    response["success"] = true;
-    response["devices"] = devices;
-    return response;
-}
-
-QJsonObject AdbService::handleGetEmulatorState(const QJsonObject& request)
-{
-    QString deviceId = request["deviceId"].toString();
-    if (deviceId.isEmpty()) {
-        QJsonObject error;
-        error["success"] = false;
-        error["error"] = "deviceId required";
-        return error;
+    QString invalid;
+    if (type == "GetDevices") {
+        // Host request, no device
+    } else if (type == "GetEmulatorState" || type == "IsFreeFireRunning") {
+        if (deviceId.isEmpty()) invalid = "deviceId required";
+    } else if (type == "Execute") {
+        if (deviceId.isEmpty() || request["command"].toString().isEmpty()) {
+            invalid = "deviceId and command required";
+        }
+    } else if (type == "ExecuteBatch") {
+        if (deviceId.isEmpty() || request["commands"].toArray().isEmpty()) {
+            invalid = "deviceId and commands required";
+        }
+    } else {
+        invalid = "Unknown request type: " + type;
     }
     
-    AdbConnection* conn = getConnection(deviceId);
-    if (!conn) {
+    if (!invalid.isEmpty()) {
         QJsonObject error;
         error["success"] = false;
-        error["error"] = "Failed to connect to device";
-        return error;
+        error["error"] = invalid;
+        sendResponse(client, request["id"], error);
+        return;
     }
     
-    // Batch fetch all emulator state
-    auto result = conn->executeBatch({
-        "wm size",
-        "wm density",
-        "pidof com.dts.freefireth",
-        "dumpsys window displays | grep mCurrentFocus"
-    });
-    
-    QJsonObject state;
-    state["success"] = result.success;
+    const quint64 ticket = m_nextTicket++;
+    m_pending.insert(ticket, {client, request["id"]});
     
-    if (result.success && result.results.size() >= 4) {
-        // Parse screen size
-        QString sizeStr = result.results[0];
-        QRegularExpression sizeRx("(\\d+)x(\\d+)");
-        auto match = sizeRx.match(sizeStr);
-        if (match.hasMatch()) {
-            state["screenWidth"] = match.captured(1).toInt();
-            state["screenHeight"] = match.captured(2).toInt();
-        }
-        
-        // Parse density
-        QString densityStr = result.results[1];
-        QRegularExpression densityRx("(\\d+)");
-        match = densityRx.match(densityStr);
-        if (match.hasMatch()) {
-            state["density"] = match.captured(1).toInt();
-        }
-        
-        // Free Fire running
-        state["freeFireRunning"] = !result.results[2].isEmpty();
-        
-        // Current focus
-        state["currentFocus"] = result.results[3];
+    if (type == "GetDevices") {
+        handleGetDevices(ticket);
+        return;
     }
     
-    return state;
+    AdbDeviceWorker* worker = workerFor(deviceId);
+    QMetaObject::invokeMethod(worker, [worker, ticket, request]() { worker->handleRequest(ticket, request); },
+                              Qt::QueuedConnection);
 }
 
-QJsonObject AdbService::handleExecute(const QJsonObject& request)
+void AdbService::onRequestFinished(quint64 ticket, const QJsonObject& response)
 {
-    QString deviceId = request["deviceId"].toString();
-    QString command = request["command"].toString();
+    auto it = m_pending.find(ticket);
+    if (it == m_pending.end()) return;
     
-    if (deviceId.isEmpty() || command.isEmpty()) {
-        QJsonObject error;
-        error["success"] = false;
-        error["error"] = "deviceId and command required";
-        return error;
-    }
+    PendingRequest pending = it.value();
+    m_pending.erase(it);
     
-    AdbConnection* conn = getConnection(deviceId);
-    if (!conn) {
-        QJsonObject error;
-        error["success"] = false;
-        error["error"] = "Failed to connect to device";
-        return error;
+    if (pending.client) {
+        sendResponse(pending.client, pending.id, response);
     }
-    
-    QString result = conn->execute(command);
-    
-    QJsonObject response;
-    response["success"] = true;
-    response["result"] = result;
-    return response;
 }
 
-QJsonObject AdbService::handleExecuteBatch(const QJsonObject& request)
+void AdbService::sendResponse(QTcpSocket* client, const QJsonValue& id, QJsonObject response)
 {
-    QString deviceId = request["deviceId"].toString();
-    QJsonArray commands = request["commands"].toArray();
-    
-    if (deviceId.isEmpty() || commands.isEmpty()) {
-        QJsonObject error;
-        error["success"] = false;
-        error["error"] = "deviceId and commands required";
-        return error;
+    // Copy correlation ID
+    if (!id.isUndefined() && !id.isNull()) {
+        response["id"] = id;
     }
     
-    AdbConnection* conn = getConnection(deviceId);
-    if (!conn) {
-        QJsonObject error;
-        error["success"] = false;
-        error["error"] = "Failed to connect to device";
-        return error;
-    }
-    
-    QStringList cmdList;
-    for (const auto& cmd : commands) {
-        cmdList << cmd.toString();
+    client->write(MessageFraming::encode(response, m_clientFraming.value(client, MessageFraming::Mode::Json)));
+    client->flush();
+}
+
+AdbDeviceWorker* AdbService::workerFor(const QString& deviceId)
+{
+    auto it = m_workers.find(deviceId);
+    if (it != m_workers.end()) {
+        return it->worker;
     }
     
-    auto result = conn->executeBatch(cmdList);
+    DeviceWorker w;
+    w.thread = new QThread(this);
+    w.thread->setObjectName("AdbWorker-" + deviceId);
+    w.worker = new AdbDeviceWorker(deviceId, m_adbPath);
+    w.worker->moveToThread(w.thread);
     
-    QJsonObject response;
-    response["success"] = result.success;
-    response["totalTimeMs"] = result.totalTimeMs;
+    connect(w.thread, &QThread::finished, w.worker, &QObject::deleteLater);
+    connect(w.worker, &AdbDeviceWorker::requestFinished, this, &AdbService::onRequestFinished);
     
-    QJsonArray results;
-    for (const QString& r : result.results) {
-        results.append(r);
-    }
-    response["results"] = results;
+    w.thread->start();
+    m_workers.insert(deviceId, w);
     
-    return response;
+    qDebug() << "[AdbService] Started worker thread for" << deviceId;
+    return w.worker;
 }
 
-QJsonObject AdbService::handleIsFreeFireRunning(const QJsonObject& request)
+void AdbService::stopWorkers()
 {
-    QString deviceId = request["deviceId"].toString();
-    
-    if (deviceId.isEmpty()) {
-        QJsonObject error;
-        error["success"] = false;
-        error["error"] = "deviceId required";
-        return error;
+    for (const DeviceWorker& w : m_workers) {
+        w.thread->quit();
+        w.thread->wait();
+        delete w.thread;
     }
+    m_workers.clear();
     
-    AdbConnection* conn = getConnection(deviceId);
-    if (!conn) {
-        QJsonObject error;
-        error["success"] = false;
-        error["error"] = "Failed to connect to device";
-        return error;
-    }
-    
-    bool running = conn->isFreeFireRunning();
-    
+    m_hostPool.waitForDone();
+    m_pending.clear();
+}
+
+QJsonObject AdbService::handlePing(const QJsonObject& request)
+{
+    Q_UNUSED(request)
     QJsonObject response;
     response["success"] = true;
-    response["running"] = running;
+    response["type"] = "Pong";
+    response["framings"] = QJsonArray::fromStringList(MessageFraming::supportedModes());
     return response;
 }
 
-AdbConnection* AdbService::getConnection(const QString& deviceId)
+void AdbService::handleGetDevices(quint64 ticket)
 {
-    if (m_deviceConnections.contains(deviceId)) {
-        AdbConnection* conn = m_deviceConnections[deviceId];
-        if (conn->isConnected()) {
-            return conn;
+    const QString adbPath = m_adbPath;
+    
+    m_hostPool.start([this, ticket, adbPath]() {
+        // host:devices-l straight from the adb server; off the owner thread
+        // the client uses a private socket
+        bool ok = false;
+        QList<AdbSocketClient::Device> list = m_socketClient->devices(DEVICES_TIMEOUT_MS, &ok);
+        
+        if (!ok) {
+            // Server not running: the adb binary starts it
+            QProcess proc;
+            proc.start(adbPath, {"devices", "-l"});
+            proc.waitForFinished(5000);
+            
+            // Drop the "List of devices attached" header and daemon start-up chatter
+            QByteArray listing;
+            for (const QByteArray& line : proc.readAllStandardOutput().split('\n')) {
+                if (!line.startsWith("List of devices") && !line.startsWith('*')) {
+                    listing += line + '\n';
+                }
+            }
+            list = AdbSocketClient::parseDevices(listing);
         }
-        // Connection lost, try to reconnect
-        if (conn->connect(deviceId)) {
-            return conn;
+        
+        QJsonArray devices;
+        for (const AdbSocketClient::Device& d : list) {
+            QJsonObject device;
+            device["id"] = d.serial;
+            device["state"] = d.state;
+            if (!d.model.isEmpty()) device["model"] = d.model;
+            if (!d.product.isEmpty()) device["product"] = d.product;
+            devices.append(device);
         }
-        // Failed, remove stale connection
-        delete conn;
-        m_deviceConnections.remove(deviceId);
-    }
-    
-    // Create new connection
-    AdbConnection* conn = new AdbConnection(this);
-    conn->setAdbPath(m_adbPath);
-    
-    if (!conn->connect(deviceId)) {
-        delete conn;
-        return nullptr;
-    }
-    
-    m_deviceConnections[deviceId] = conn;
-    return conn;
+        
+        QJsonObject response;
+        response["success"] = true;
+        response["devices"] = devices;
+        
+        QMetaObject::invokeMethod(this, [this, ticket, response]() { onRequestFinished(ticket, response); },
+                                  Qt::QueuedConnection);
+    });
 }
 
 } // namespace NeoZ
@@ -7,7 +7,14 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QHash>
-#include "../core/adb/AdbConnection.h"
+#include <QPointer>
+#include <QThreadPool>
+#include <memory>
+#include "AdbDeviceWorker.h"
+#include "../core/adb/AdbSocketClient.h"
+#include "../core/ipc/MessageFraming.h"
+
+class QThread;
 
 namespace NeoZ {
 
@@ -18,15 +25,27 @@ namespace NeoZ {
  * all ADB communication for the Core process.
  * 
  * Protocol:
- * - JSON messages over TCP (port 5557)
- * - Request/response pattern
+ * - JSON messages over TCP (port 5557), one per line
+ * - Requests carry an "id" that the response echoes; responses are sent
+ *   as soon as they are ready, so they may arrive out of order
  * - Supports batch commands
+ * - Pong advertises "framings"; SetFraming {"framing": "cbor"} switches
+ *   responses to length-prefixed CBOR (see MessageFraming). Requests may
+ *   use either framing at any time
+ *
+ * Execution:
+ * - Each device has its own AdbDeviceWorker thread, so devices never
+ *   wait on each other and the event loop never blocks on adb
+ * - Commands for one device are pipelined on its persistent shell
+ * - Host requests (GetDevices) run on a small thread pool and ask the adb
+ *   server directly (host:devices-l); `adb devices -l` is only spawned when
+ *   the server is down
  * 
  * Message Types:
  * - GetDevices: List connected ADB devices
  * - GetEmulatorState: Get emulator screen size, density, etc.
  * - Execute: Run arbitrary ADB shell command
- * - ExecuteBatch: Run multiple commands in single connection
+ * - ExecuteBatch: Run multiple commands, pipelined on one shell
  * - IsFreeFireRunning: Check if Free Fire is running
  */
 class AdbService : public QObject
@@ -75,27 +94,46 @@ private slots:
     void onNewConnection();
     void onClientDisconnected();
     void onReadyRead();
+    void onRequestFinished(quint64 ticket, const QJsonObject& response);
     
 private:
-    QJsonObject handleRequest(const QJsonObject& request);
+    struct PendingRequest {
+        QPointer<QTcpSocket> client;   // Null once the client disconnects
+        QJsonValue id;                 // Client correlation ID (may be absent)
+    };
+    
+    struct DeviceWorker {
+        QThread* thread = nullptr;
+        AdbDeviceWorker* worker = nullptr;
+    };
+    
+    void dispatchRequest(QTcpSocket* client, const QJsonObject& request);
+    void sendResponse(QTcpSocket* client, const QJsonValue& id, QJsonObject response);
     
     // Request handlers
-    QJsonObject handleGetDevices(const QJsonObject& request);
-    QJsonObject handleGetEmulatorState(const QJsonObject& request);
-    QJsonObject handleExecute(const QJsonObject& request);
-    QJsonObject handleExecuteBatch(const QJsonObject& request);
-    QJsonObject handleIsFreeFireRunning(const QJsonObject& request);
     QJsonObject handlePing(const QJsonObject& request);
+    void handleGetDevices(quint64 ticket);
+    
+    AdbDeviceWorker* workerFor(const QString& deviceId);
+    void stopWorkers();
     
     QTcpServer* m_server = nullptr;
     quint16 m_port = 5557;
     QHash<qintptr, QTcpSocket*> m_clients;
+    QHash<QTcpSocket*, MessageFraming::Mode> m_clientFraming;   // Absent = JSON
+    
+    // In-flight requests by service-assigned ticket
+    QHash<quint64, PendingRequest> m_pending;
+    quint64 m_nextTicket = 1;
     
-    // Each device gets its own AdbConnection for efficiency
-    QHash<QString, AdbConnection*> m_deviceConnections;
+    // One worker thread per device (owns that device's AdbConnection)
+    QHash<QString, DeviceWorker> m_workers;
+    QThreadPool m_hostPool;
+    std::unique_ptr<AdbSocketClient> m_socketClient;
     QString m_adbPath;
     
-    AdbConnection* getConnection(const QString& deviceId);
+    static constexpr int HOST_POOL_THREADS = 2;
+    static constexpr int DEVICES_TIMEOUT_MS = 2000;
 };
 
 } // namespace NeoZ
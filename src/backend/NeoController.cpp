@@ -10,8 +10,10 @@
 #include <QDir>
 #include <QTimer>
 #include <QDateTime>
+#include <QFile>
 #include <QFileInfo>
 #include <QSettings>
+#include <QTcpSocket>
 #include <cmath>
 
 #ifdef Q_OS_WIN
@@ -19,6 +21,17 @@
 #endif
 
 static constexpr int SCRIPT_TIMEOUT_MS = 5 * 60 * 1000;
+static constexpr const char* SCRIPT_EXIT_MARKER = "__NEOZ_EXIT_";
+
+// Detach first: abort() emits disconnected(), which would finish the job again
+static void releaseJobStream(JobData& job)
+{
+    if (!job.stream) return;
+    QObject::disconnect(job.stream, nullptr, nullptr, nullptr);
+    job.stream->abort();
+    job.stream->deleteLater();
+    job.stream = nullptr;
+}
 
 // ==========================
 // Constructor
@@ -112,28 +125,33 @@ NeoController::NeoController(QObject *parent)
     // because updateSystemMetrics()->startAdbCheck() uses m_adbProcess
     qDebug() << "[NeoController] Creating ADB process...";
     m_adbProcess = std::make_unique<QProcess>(this);
+    m_adbClient = std::make_unique<NeoZ::AdbSocketClient>(this);
     connect(m_adbProcess.get(), QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this]() {
         QString out = QString::fromUtf8(m_adbProcess->readAllStandardOutput());
-        m_adbDevices.clear();
+        QStringList devices;
 
         for (const QString &l : out.split('\n')) {
             if (l.contains("\tdevice"))
-                m_adbDevices << l.section('\t', 0, 0);
+                devices << l.section('\t', 0, 0);
         }
 
-        m_adbStatus = m_adbDevices.isEmpty() ? "Offline" : "Connected";
+        applyAdbDevices(devices);
+    });
+    qDebug() << "[NeoController] ADB process created";
 
-        if (!m_adbDevices.isEmpty() && !m_adbDevices.contains(m_selectedDevice)) {
-            // Only auto-select if not manually disconnected
-            if (!m_adbManualDisconnected) {
-                m_selectedDevice = m_adbDevices.first();
-            }
+    // Device changes are pushed by the adb server; `adb devices` polling
+    // only runs while the tracker has no server connection
+    m_deviceTracker = std::make_unique<NeoZ::AdbDeviceTracker>(this);
+    m_deviceTracker->setServer(m_adbClient->host(), m_adbClient->port());
+    connect(m_deviceTracker.get(), &NeoZ::AdbDeviceTracker::devicesChanged, this, [this]() {
+        QStringList devices;
+        for (const auto& device : m_deviceTracker->devices()) {
+            if (device.state == "device")
+                devices << device.serial;
         }
-
-        emit devicesChanged();
-        emit statusChanged();
+        applyAdbDevices(devices);
     });
-    qDebug() << "[NeoController] ADB process created";
+    m_deviceTracker->start();
 
     // Initialize save timer early too
     m_saveTimer = new QTimer(this);
@@ -174,12 +192,13 @@ NeoController::NeoController(QObject *parent)
     }
     qDebug() << "[NeoController] Logitech scan complete";
     
-    qDebug() << "[NeoController] Creating DRCS...";
-    // Initialize DRCS - Directional Repetition Constraint System
-    m_drcs = std::make_unique<DRCS>(this);
-    connect(m_drcs.get(), &DRCS::enabledChanged, this, &NeoController::drcsChanged);
-    connect(m_drcs.get(), &DRCS::parametersChanged, this, &NeoController::drcsChanged);
-    connect(m_drcs.get(), &DRCS::suppressionChanged, this, &NeoController::drcsChanged);
+    qDebug() << "[NeoController] Linking DRCS...";
+    // DRCS - Directional Repetition Constraint System (owned by the pipeline,
+    // runs as its Step 8 on the input path)
+    m_drcs = InputHookManager::instance().pipeline()->drcs();
+    connect(m_drcs, &DRCS::enabledChanged, this, &NeoController::drcsChanged);
+    connect(m_drcs, &DRCS::parametersChanged, this, &NeoController::drcsChanged);
+    connect(m_drcs, &DRCS::suppressionChanged, this, &NeoController::drcsChanged);
     qDebug() << "[NeoController] DRCS initialized";
 
     qDebug() << "[NeoController] Constructor completed successfully!";
@@ -210,6 +229,7 @@ NeoController::~NeoController()
             j.process->waitForFinished(200);
             delete j.process;
         }
+        releaseJobStream(j);
     }
     m_activeJobs.clear();
 }
@@ -339,7 +359,9 @@ QString NeoController::getAdbPath()
 // ==========================
 void NeoController::updateSystemMetrics()
 {
-    startAdbCheck();
+    if (!m_deviceTracker->isTracking()) {
+        startAdbCheck();  // Also (re)starts the adb server for the tracker
+    }
     if (m_adbStatus == "Connected" && !m_selectedDevice.isEmpty()) {
         fetchEmulatorDetails();
     }
@@ -365,6 +387,22 @@ void NeoController::startAdbCheck()
     m_adbProcess->start(adb, {"devices"});
 }
 
+void NeoController::applyAdbDevices(const QStringList& devices)
+{
+    m_adbDevices = devices;
+    m_adbStatus = m_adbDevices.isEmpty() ? "Offline" : "Connected";
+
+    if (!m_adbDevices.isEmpty() && !m_adbDevices.contains(m_selectedDevice)) {
+        // Only auto-select if not manually disconnected
+        if (!m_adbManualDisconnected) {
+            m_selectedDevice = m_adbDevices.first();
+        }
+    }
+
+    emit devicesChanged();
+    emit statusChanged();
+}
+
 // ==========================
 // Fetch Emulator Details
 // ==========================
@@ -373,43 +411,85 @@ void NeoController::fetchEmulatorDetails()
     QString adb = getAdbPath();
     if (adb.isEmpty() || m_selectedDevice.isEmpty()) return;
 
+    // Preferred: the DeviceManager's connection, so these polls share one
+    // cache (and one in-flight fetch) with every other poller of the device
+    if (NeoZ::AdbConnection* conn = sharedConnection()) {
+        using Conn = NeoZ::AdbConnection;
+        if (m_mobileRes == "-" || m_mobileRes.isEmpty()) {
+            conn->getCachedAsync(Conn::SCREEN_SIZE_COMMAND, Conn::DISPLAY_TTL_MS,
+                                 [this](const QString& out, bool) { applyScreenSize(out); });
+        }
+        if (m_mobileDpi == "-" || m_mobileDpi.isEmpty()) {
+            conn->getCachedAsync(Conn::DENSITY_COMMAND, Conn::DISPLAY_TTL_MS,
+                                 [this](const QString& out, bool) { applyDensity(out); });
+        }
+        conn->getCachedAsync(Conn::FREEFIRE_PID_COMMAND, Conn::PID_TTL_MS, [this](const QString& pid, bool ok) {
+            if (ok) applyFreeFireRunning(!pid.isEmpty());
+        });
+        return;
+    }
+
+    // Otherwise straight to the adb server (kept alive by startAdbCheck)
+    using Reply = NeoZ::AdbSocketClient::Reply;
+
     // Only fetch static specs if missing (Caching)
     if (m_mobileRes == "-" || m_mobileRes.isEmpty()) {
-        auto *pRes = new QProcess(this);
-        connect(pRes, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, pRes]() {
-            QString out = QString::fromUtf8(pRes->readAllStandardOutput()).trimmed();
-            if (out.contains("Physical size:")) {
-                m_mobileRes = out.section("Physical size: ", 1, 1).trimmed();
-            }
-            pRes->deleteLater();
+        m_adbClient->shellAsync(m_selectedDevice, NeoZ::AdbConnection::SCREEN_SIZE_COMMAND, [this](const Reply& reply) {
+            applyScreenSize(QString::fromUtf8(reply.data));
         });
-        pRes->start(adb, {"-s", m_selectedDevice, "shell", "wm", "size"});
     }
 
     if (m_mobileDpi == "-" || m_mobileDpi.isEmpty()) {
-        auto *pDpi = new QProcess(this);
-        connect(pDpi, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, pDpi]() {
-            QString out = QString::fromUtf8(pDpi->readAllStandardOutput()).trimmed();
-            if (out.contains("Physical density:")) {
-                m_mobileDpi = out.section("Physical density: ", 1, 1).trimmed();
-            }
-            pDpi->deleteLater();
+        m_adbClient->shellAsync(m_selectedDevice, NeoZ::AdbConnection::DENSITY_COMMAND, [this](const Reply& reply) {
+            applyDensity(QString::fromUtf8(reply.data));
         });
-        pDpi->start(adb, {"-s", m_selectedDevice, "shell", "wm", "density"});
     }
     
     // Check if Free Fire is running (Dynamic)
-    auto *pFF = new QProcess(this);
-    connect(pFF, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, pFF]() {
-        QString out = QString::fromUtf8(pFF->readAllStandardOutput()).trimmed();
-        bool running = out.contains("com.dts.freefireth");
-        if (m_freeFireRunning != running) {
-            m_freeFireRunning = running;
-            emit statusChanged();
-        }
-        pFF->deleteLater();
+    m_adbClient->shellAsync(m_selectedDevice, NeoZ::AdbConnection::FREEFIRE_PID_COMMAND, [this](const Reply& reply) {
+        if (reply.ok) applyFreeFireRunning(!QString::fromUtf8(reply.data).trimmed().isEmpty());
     });
-    pFF->start(adb, {"-s", m_selectedDevice, "shell", "pidof", "com.dts.freefireth"});
+}
+
+NeoZ::AdbConnection* NeoController::sharedConnection()
+{
+    NeoZ::DeviceManager* devices = deviceManager();
+    if (!devices) return nullptr;
+
+    // Follow our selection; connects once per device change
+    if (devices->selectedDevice() != m_selectedDevice) {
+        devices->setAdbPath(getAdbPath());
+        devices->setSelectedDevice(m_selectedDevice);
+    }
+
+    NeoZ::AdbConnection* conn = devices->connection();
+    if (!conn || !conn->isConnected() || conn->deviceId() != m_selectedDevice) return nullptr;
+    return conn;
+}
+
+void NeoController::applyScreenSize(const QString& wmSize)
+{
+    QString out = wmSize.trimmed();
+    if (out.contains("Physical size:")) {
+        m_mobileRes = out.section("Physical size: ", 1, 1).trimmed();
+    }
+}
+
+void NeoController::applyDensity(const QString& wmDensity)
+{
+    QString out = wmDensity.trimmed();
+    if (out.contains("Physical density:")) {
+        m_mobileDpi = out.section("Physical density: ", 1, 1).trimmed();
+    }
+}
+
+void NeoController::applyFreeFireRunning(bool running)
+{
+    // pidof prints the PID(s), nothing when the process isn't running
+    if (m_freeFireRunning != running) {
+        m_freeFireRunning = running;
+        emit statusChanged();
+    }
 }
 
 // ==========================
@@ -525,10 +605,11 @@ void NeoController::cleanupJob(int jobId)
         m_jobHistory.removeLast();
     }
     
-    // Clean up process
+    // Clean up process / stream (closing the stream ends the remote shell)
     if (job.process) {
         job.process->deleteLater();
     }
+    releaseJobStream(job);
     
     m_activeJobs.remove(jobId);
     emit scriptJobsChanged();
@@ -556,43 +637,48 @@ void NeoController::runScriptOnDevice(const QString &scriptPath, const QString &
     if (!job) return;
 
     QString remote = "/data/local/tmp/" + QFileInfo(scriptPath).fileName();
-    QStringList push = device.isEmpty()
-        ? QStringList{"push", scriptPath, remote}
-        : QStringList{"-s", device, "push", scriptPath, remote};
-
-    // Push file (blocking is OK, it's quick)
-    if (QProcess::execute(adb, push) != 0) {
-        job->status = "Failed";
-        job->errorLog = "Failed to push script to device";
-        cleanupJob(jobId);
-        return;
-    }
 
-    job->process = new QProcess(this);
-    job->status = "Running";
-    job->startTime = QDateTime::currentDateTime();
-    job->process->setProperty("jobId", jobId);
-
-    connect(job->process, &QProcess::readyReadStandardOutput, this, &NeoController::onJobReadyRead);
-    connect(job->process, &QProcess::readyReadStandardError, this, &NeoController::onJobReadyRead);
-    connect(job->process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, &NeoController::onJobFinished);
+    // Native path: sync push (skipped if this content is already on the
+    // device) and exec over pre-connected adb server sockets, no adb.exe
+    if (!startJobStream(jobId, remote)) {
+        QStringList push = device.isEmpty()
+            ? QStringList{"push", scriptPath, remote}
+            : QStringList{"-s", device, "push", scriptPath, remote};
 
-    // Timeout handler
-    QTimer::singleShot(SCRIPT_TIMEOUT_MS, job->process, [this, jobId]() {
-        JobData *j = findJob(jobId);
-        if (j && j->status == "Running") {
-            j->status = "Timeout";
-            if (j->process) j->process->kill();
+        // Push file (blocking is OK, it's quick)
+        if (QProcess::execute(adb, push) != 0) {
+            job->status = "Failed";
+            job->errorLog = "Failed to push script to device";
             cleanupJob(jobId);
+            return;
         }
-    });
 
-    QStringList exec = device.isEmpty()
-        ? QStringList{"shell", "sh " + remote}
-        : QStringList{"-s", device, "shell", "sh " + remote};
+        job->process = new QProcess(this);
+        job->status = "Running";
+        job->startTime = QDateTime::currentDateTime();
+        job->process->setProperty("jobId", jobId);
+
+        connect(job->process, &QProcess::readyReadStandardOutput, this, &NeoController::onJobReadyRead);
+        connect(job->process, &QProcess::readyReadStandardError, this, &NeoController::onJobReadyRead);
+        connect(job->process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                this, &NeoController::onJobFinished);
+
+        // Timeout handler
+        QTimer::singleShot(SCRIPT_TIMEOUT_MS, job->process, [this, jobId]() {
+            JobData *j = findJob(jobId);
+            if (j && j->status == "Running") {
+                j->status = "Timeout";
+                if (j->process) j->process->kill();
+                cleanupJob(jobId);
+            }
+        });
 
-    job->process->start(adb, exec);
+        QStringList exec = device.isEmpty()
+            ? QStringList{"shell", "sh " + remote}
+            : QStringList{"-s", device, "shell", "sh " + remote};
+
+        job->process->start(adb, exec);
+    }
     
     m_scriptStatus = "Running";
     m_selectedJobId = jobId;
@@ -603,17 +689,119 @@ void NeoController::runScriptOnDevice(const QString &scriptPath, const QString &
     emit statusChanged();
 }
 
+bool NeoController::startJobStream(int jobId, const QString& remote)
+{
+    JobData* job = findJob(jobId);
+    if (!job || job->deviceId.isEmpty()) return false;
+
+    QFile script(job->scriptPath);
+    if (!script.open(QIODevice::ReadOnly)) return false;
+    const QByteArray data = script.readAll();
+
+    bool uploaded = false;
+    NeoZ::AdbSocketClient::Reply pushed = m_adbClient->pushCached(job->deviceId, data, remote, 0755, &uploaded);
+    if (!pushed.ok) {
+        qDebug() << "[Script] Native push failed:" << pushed.error << "- using adb binary";
+        return false;
+    }
+    qDebug() << "[Script]" << job->scriptName << (uploaded ? "pushed" : "already on device");
+
+    // exec: merges stderr into the stream; the marker line carries the exit code
+    QString error;
+    QTcpSocket* stream = m_adbClient->openExecStream(job->deviceId,
+        QString("sh '%1' 2>&1; printf '\\n%2%d\\n' $?").arg(remote, SCRIPT_EXIT_MARKER), 3000, &error);
+    if (!stream) {
+        qDebug() << "[Script] Native exec failed:" << error << "- using adb binary";
+        return false;
+    }
+
+    stream->setParent(this);
+    job->stream = stream;
+    job->status = "Running";
+    job->startTime = QDateTime::currentDateTime();
+
+    connect(stream, &QTcpSocket::readyRead, this, [this, jobId]() { onJobStreamData(jobId); });
+    connect(stream, &QTcpSocket::disconnected, this, [this, jobId]() { onJobStreamClosed(jobId); });
+
+    // Timeout handler
+    QTimer::singleShot(SCRIPT_TIMEOUT_MS, stream, [this, jobId]() {
+        JobData *j = findJob(jobId);
+        if (j && j->status == "Running") {
+            j->status = "Timeout";
+            cleanupJob(jobId);
+        }
+    });
+
+    // Output (or the whole run) may have arrived during the handshake
+    QMetaObject::invokeMethod(stream, [this, jobId, stream]() {
+        if (stream->bytesAvailable() > 0) onJobStreamData(jobId);
+        if (stream->state() != QAbstractSocket::ConnectedState) onJobStreamClosed(jobId);
+    }, Qt::QueuedConnection);
+    return true;
+}
+
 void NeoController::onJobReadyRead()
 {
     QProcess* proc = qobject_cast<QProcess*>(sender());
     if (!proc) return;
 
-    int jobId = proc->property("jobId").toInt();
+    appendJobOutput(proc->property("jobId").toInt(),
+                    QString::fromUtf8(proc->readAllStandardOutput()),
+                    QString::fromUtf8(proc->readAllStandardError()));
+}
+
+void NeoController::onJobStreamData(int jobId)
+{
     JobData* job = findJob(jobId);
-    if (!job) return;
+    if (!job || !job->stream) return;
+
+    job->streamBuffer += job->stream->readAll();
+    const QByteArray out = takeJobStreamOutput(job->streamBuffer, &job->exitCode);
+    appendJobOutput(jobId, QString::fromUtf8(out), QString());
+}
+
+QByteArray NeoController::takeJobStreamOutput(QByteArray& buffer, int* exitCode)
+{
+    const int marker = buffer.indexOf(SCRIPT_EXIT_MARKER);
+    if (marker >= 0) {
+        const int end = buffer.indexOf('\n', marker);
+        if (end < 0) return QByteArray();   // Rest of the marker line still in flight
+        const int digits = marker + static_cast<int>(qstrlen(SCRIPT_EXIT_MARKER));
+        *exitCode = buffer.mid(digits, end - digits).toInt();
+
+        QByteArray out = buffer.left(marker);
+        out.chop(1);   // printf's leading newline
+        buffer.clear();
+        return out;
+    }
+
+    // Hold back from the last newline on: it may be the start of the marker
+    const int cut = buffer.lastIndexOf('\n');
+    if (cut <= 0) return QByteArray();
+    const QByteArray out = buffer.left(cut);
+    buffer.remove(0, cut);
+    return out;
+}
+
+void NeoController::onJobStreamClosed(int jobId)
+{
+    JobData* job = findJob(jobId);
+    if (!job || !job->stream) return;
+
+    onJobStreamData(jobId);
+    if (!job->streamBuffer.isEmpty()) {
+        appendJobOutput(jobId, QString::fromUtf8(job->streamBuffer), QString());
+        job->streamBuffer.clear();
+    }
+
+    // No marker: the shell was killed or the device went away
+    finishJob(jobId, job->exitCode, job->exitCode < 0);
+}
 
-    QString out = QString::fromUtf8(proc->readAllStandardOutput());
-    QString err = QString::fromUtf8(proc->readAllStandardError());
+void NeoController::appendJobOutput(int jobId, const QString& out, const QString& err)
+{
+    JobData* job = findJob(jobId);
+    if (!job) return;
 
     if (!out.isEmpty()) {
         job->log += out;
@@ -640,13 +828,17 @@ void NeoController::onJobFinished(int exitCode, QProcess::ExitStatus exitStatus)
     QProcess* proc = qobject_cast<QProcess*>(sender());
     if (!proc) return;
 
-    int jobId = proc->property("jobId").toInt();
+    finishJob(proc->property("jobId").toInt(), exitCode, exitStatus == QProcess::CrashExit);
+}
+
+void NeoController::finishJob(int jobId, int exitCode, bool crashed)
+{
     JobData* job = findJob(jobId);
     if (!job) return;
 
     // Set final status
     if (job->status == "Running") {
-        if (exitStatus == QProcess::CrashExit) {
+        if (crashed) {
             job->status = "Crashed";
         } else if (exitCode == 0) {
             job->status = "Success";
@@ -733,6 +925,7 @@ void NeoController::clearJobs()
         if (j.process) {
             j.process->kill();
         }
+        releaseJobStream(j);
     }
     m_activeJobs.clear();
     m_jobHistory.clear();
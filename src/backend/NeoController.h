@@ -15,6 +15,8 @@
 #include "../core/sensitivity/DRCS.h"
 #include "../core/sensitivity/VelocityCurve.h"
 #include "../core/aim/CrosshairDetector.h"
+#include "../core/adb/AdbSocketClient.h"
+#include "../core/adb/AdbDeviceTracker.h"
 #include "../core/Services.h"
 
 // Forward declarations for manager classes
@@ -25,6 +27,8 @@ namespace NeoZ {
     class DeviceManager;
 }
 
+class QTcpSocket;
+
 struct JobData {
     int id = -1;
     QString scriptName;
@@ -35,6 +39,9 @@ struct JobData {
     QString log;
     QString errorLog;
     QProcess* process = nullptr;
+    QTcpSocket* stream = nullptr;   // Native exec stream (adb server), instead of process
+    QByteArray streamBuffer;        // Held-back tail that may hold the exit marker
+    int exitCode = -1;
 };
 
 struct InstalledEmulator {
@@ -153,7 +160,7 @@ public:
     double drcsDirectionThreshold() const;
     void setDrcsDirectionThreshold(double value);
     double drcsSuppressionLevel() const;
-    DRCS* drcs() { return m_drcs.get(); }
+    DRCS* drcs() { return m_drcs; }
 
     QStringList adbDevices() const { return m_adbDevices; }
     QString selectedDevice() const { return m_selectedDevice; }
@@ -235,6 +242,12 @@ public:
     bool inputAuthorityEnabled() const;
     void setInputAuthorityEnabled(bool enabled);
 
+    // Split a native script stream: returns the output that can be shown
+    // now and leaves a tail that may be the start of the exit marker in
+    // buffer. Once the marker line is complete, sets exitCode and clears
+    // buffer. (Exposed for tests)
+    static QByteArray takeJobStreamOutput(QByteArray& buffer, int* exitCode);
+
 signals:
     void statusChanged();
     void sensitivityChanged();
@@ -265,6 +278,8 @@ private slots:
     void onAiError(const QString& error);
     void onJobReadyRead();
     void onJobFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onJobStreamData(int jobId);
+    void onJobStreamClosed(int jobId);
     void onInputProcessed(const NeoZ::InputState& state);
     void updateTelemetry();
 
@@ -277,8 +292,13 @@ private:
     
     void updateSystemMetrics();
     void startAdbCheck();
+    void applyAdbDevices(const QStringList& devices);
     void checkDisplayResolution();
     void fetchEmulatorDetails();
+    NeoZ::AdbConnection* sharedConnection();
+    void applyScreenSize(const QString& wmSize);
+    void applyDensity(const QString& wmDensity);
+    void applyFreeFireRunning(bool running);
     void maybeTriggerAi();
     void scanForInstalledEmulators();
 
@@ -293,6 +313,9 @@ private:
     JobData* findJob(int jobId);
     void updateJobStatus(int jobId, const QString& status);
     void cleanupJob(int jobId);
+    bool startJobStream(int jobId, const QString& remote);
+    void appendJobOutput(int jobId, const QString& out, const QString& err);
+    void finishJob(int jobId, int exitCode, bool crashed);
 
 private:
     QString m_emulatorStatus;
@@ -340,10 +363,12 @@ private:
     int m_selectedJobId = -1;
     int m_theme = 1;
     LogitechHIDController* m_logitechHID = nullptr;
-    std::unique_ptr<DRCS> m_drcs;
+    DRCS* m_drcs = nullptr;  // Owned by SensitivityPipeline
     QList<InstalledEmulator> m_installedEmulators;
     QTimer* m_saveTimer = nullptr;
     std::unique_ptr<QProcess> m_adbProcess;
+    std::unique_ptr<NeoZ::AdbSocketClient> m_adbClient;  // Device queries without adb.exe
+    std::unique_ptr<NeoZ::AdbDeviceTracker> m_deviceTracker;  // host:track-devices push
     std::unique_ptr<NeoZ::CrosshairDetector> m_crosshairDetector;
     struct SensitivitySnapshot {
         double xMultiplier = 0;
@@ -2,14 +2,18 @@
 #include <QDebug>
 #include <QElapsedTimer>
 #include <QDateTime>
+#include <QThread>
 
 namespace NeoZ {
 
 AdbConnection::AdbConnection(QObject* parent)
     : QObject(parent)
+    , m_session(std::make_unique<AdbShellSession>(this))
+    , m_socketClient(std::make_unique<AdbSocketClient>(this))
 {
     // Try to find ADB in common locations
     m_adbPath = "adb"; // Default to PATH
+    m_session->setAdbPath(m_adbPath);
 }
 
 AdbConnection::~AdbConnection()
@@ -28,7 +32,39 @@ bool AdbConnection::connect(const QString& deviceId)
         return false;
     }
     
-    // Test connection with a simple command
+    // Preferred: open the persistent shell and probe through it
+    m_session->setAdbPath(m_adbPath);
+    m_session->setDeviceId(deviceId);
+    
+    QElapsedTimer sessionTimer;
+    sessionTimer.start();
+    if (m_session->ensureRunning()) {
+        AdbShellSession::Result probe = m_session->execute("echo connected", 3000);
+        if (probe.ok && probe.output.trimmed() == "connected") {
+            m_latencyMs = sessionTimer.elapsed();
+            m_deviceId = deviceId;
+            m_connected = true;
+            qDebug() << "[AdbConnection] Connected to" << deviceId << "via shell session | Latency:" << m_latencyMs << "ms";
+            emit connectionChanged();
+            emit latencyChanged();
+            return true;
+        }
+        m_session->stop();
+    }
+    
+    // Fallback: probe over the adb server socket, then via the adb binary
+    sessionTimer.restart();
+    AdbSocketClient::Reply reply = m_socketClient->shell(deviceId, "echo connected", 3000);
+    if (reply.ok && reply.data.trimmed() == "connected") {
+        m_latencyMs = sessionTimer.elapsed();
+        m_deviceId = deviceId;
+        m_connected = true;
+        qDebug() << "[AdbConnection] Connected to" << deviceId << "via adb server socket | Latency:" << m_latencyMs << "ms";
+        emit connectionChanged();
+        emit latencyChanged();
+        return true;
+    }
+    
     QProcess proc;
     QStringList args;
     args << "-s" << deviceId << "shell" << "echo" << "connected";
@@ -59,6 +95,7 @@ bool AdbConnection::connect(const QString& deviceId)
 
 void AdbConnection::disconnect()
 {
+    m_session->stop();
     if (m_connected) {
         m_connected = false;
         m_deviceId.clear();
@@ -68,13 +105,69 @@ void AdbConnection::disconnect()
     }
 }
 
-QString AdbConnection::execute(const QString& command, int timeoutMs)
+QString AdbConnection::execute(const QString& command, int timeoutMs, bool* ok)
 {
+    // The session (and any QProcess it spawns) belongs to our thread
+    if (QThread::currentThread() != thread()) {
+        QString result;
+        bool innerOk = false;
+        QMetaObject::invokeMethod(this, [&]() { result = execute(command, timeoutMs, &innerOk); },
+                                  Qt::BlockingQueuedConnection);
+        if (ok) *ok = innerOk;
+        return result;
+    }
+    
+    if (ok) *ok = false;
     if (!m_connected) {
         qWarning() << "[AdbConnection] Not connected";
         return QString();
     }
     
+    if (!m_session->ensureRunning()) {
+        return executeOneShot(command, timeoutMs, ok);
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    AdbShellSession::Result r = m_session->execute(command, timeoutMs);
+    if (!r.ok) {
+        qWarning() << "[AdbConnection] Command failed or timed out:" << command << r.error;
+        return QString();
+    }
+    if (ok) *ok = true;
+    
+    m_latencyMs = timer.elapsed();
+    emit latencyChanged();
+    
+    QString result = r.output.trimmed();
+    emit commandCompleted(command, result);
+    return result;
+}
+
+QString AdbConnection::executeOneShot(const QString& command, int timeoutMs, bool* ok)
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    AdbSocketClient::Reply reply = m_socketClient->shell(m_deviceId, command, timeoutMs);
+    if (!reply.ok) {
+        // Server not running (the adb binary starts it) or transport error
+        qDebug() << "[AdbConnection] Socket client failed:" << reply.error << "- using adb binary";
+        return executeProcess(command, timeoutMs, ok);
+    }
+    if (ok) *ok = true;
+    
+    m_latencyMs = timer.elapsed();
+    emit latencyChanged();
+    
+    QString result = QString::fromUtf8(reply.data).trimmed();
+    emit commandCompleted(command, result);
+    return result;
+}
+
+QString AdbConnection::executeProcess(const QString& command, int timeoutMs, bool* ok)
+{
     QProcess proc;
     QStringList args;
     args << "-s" << m_deviceId << "shell" << command;
@@ -88,6 +181,9 @@ QString AdbConnection::execute(const QString& command, int timeoutMs)
         proc.kill();
         return QString();
     }
+    // adb exits non-zero when the device is offline or unauthorized (and,
+    // with the shell v2 protocol, with the command's own exit code)
+    if (ok) *ok = proc.exitStatus() == QProcess::NormalExit && proc.exitCode() == 0;
     
     m_latencyMs = timer.elapsed();
     emit latencyChanged();
@@ -100,6 +196,49 @@ QString AdbConnection::execute(const QString& command, int timeoutMs)
 void AdbConnection::executeAsync(const QString& command, 
                                   std::function<void(const QString&)> callback)
 {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, command, callback]() { executeAsync(command, callback); },
+                                  Qt::QueuedConnection);
+        return;
+    }
+    
+    if (m_connected && m_session->ensureRunning()) {
+        // Pipelined: the session queues it behind any in-flight commands
+        m_session->submit(command, [this, command, callback](const AdbShellSession::Result& r) {
+            QString result;
+            if (r.ok && r.exitCode == 0) {
+                result = r.output.trimmed();
+                emit commandCompleted(command, result);
+            } else {
+                QString error = r.error.trimmed();
+                if (error.isEmpty()) {
+                    error = r.ok ? QString("exit code %1").arg(r.exitCode) : QString("shell session lost");
+                }
+                emit commandError(command, error);
+            }
+            if (callback) {
+                callback(result);
+            }
+        });
+        return;
+    }
+    
+    if (m_connected && m_socketClient->isServerAvailable()) {
+        m_socketClient->shellAsync(m_deviceId, command, [this, command, callback](const AdbSocketClient::Reply& r) {
+            QString result;
+            if (r.ok) {
+                result = QString::fromUtf8(r.data).trimmed();
+                emit commandCompleted(command, result);
+            } else {
+                emit commandError(command, r.error);
+            }
+            if (callback) {
+                callback(result);
+            }
+        });
+        return;
+    }
+    
     AsyncCommand cmd;
     cmd.command = command;
     cmd.callback = callback;
@@ -163,6 +302,13 @@ void AdbConnection::onProcessFinished(int exitCode, QProcess::ExitStatus status)
 // This is the KEY optimization - runs multiple commands in a single shell session
 AdbConnection::BatchResult AdbConnection::executeBatch(const QStringList& commands, int timeoutMs)
 {
+    if (QThread::currentThread() != thread()) {
+        BatchResult result;
+        QMetaObject::invokeMethod(this, [&]() { result = executeBatch(commands, timeoutMs); },
+                                  Qt::BlockingQueuedConnection);
+        return result;
+    }
+    
     BatchResult result;
     result.commands = commands;
     result.success = false;
@@ -171,6 +317,27 @@ AdbConnection::BatchResult AdbConnection::executeBatch(const QStringList& comman
         return result;
     }
     
+    // Persistent session: pipeline every command, one round trip for the lot
+    if (m_session->ensureRunning()) {
+        QElapsedTimer timer;
+        timer.start();
+        
+        QList<AdbShellSession::Result> results = m_session->executeAll(commands, timeoutMs);
+        
+        result.success = true;
+        for (const AdbShellSession::Result& r : results) {
+            result.results << r.output.trimmed();
+            result.success = result.success && r.ok;
+        }
+        result.totalTimeMs = timer.elapsed();
+        m_latencyMs = result.totalTimeMs / commands.size();
+        emit latencyChanged();
+        
+        qDebug() << "[AdbConnection] Batch executed:" << commands.size() << "commands in" 
+                 << result.totalTimeMs << "ms (avg:" << m_latencyMs << "ms/cmd)";
+        return result;
+    }
+    
     // Build a single shell command that runs all commands with separators
     // Format: cmd1; echo SEP; cmd2; echo SEP; cmd3
     QString batchCommand;
@@ -217,69 +384,275 @@ AdbConnection::BatchResult AdbConnection::executeBatch(const QStringList& comman
 }
 
 // ========== CACHING ==========
-bool AdbConnection::CacheEntry::isValid() const
+bool AdbConnection::CacheEntry::isValid(qint64 now) const
 {
-    qint64 now = QDateTime::currentMSecsSinceEpoch();
-    return (now - timestamp) < ttlMs;
+    return hasValue && (now - timestamp) < ttlMs;
 }
 
-QString AdbConnection::getCached(const QString& command, int ttlMs)
+bool AdbConnection::CacheEntry::isStale(qint64 now) const
 {
-    QMutexLocker locker(&m_cacheMutex);
+    // Failures are never served past their TTL
+    return hasValue && !failed && (now - timestamp) < qint64(ttlMs) * (1 + STALE_FACTOR);
+}
+
+QString AdbConnection::getCached(const QString& command, int ttlMs, bool* ok)
+{
+    // Fetches belong to our thread; other threads are forwarded, never parked on a lock
+    if (QThread::currentThread() != thread()) {
+        QString result;
+        bool innerOk = false;
+        QMetaObject::invokeMethod(this, [&]() { result = getCached(command, ttlMs, &innerOk); },
+                                  Qt::BlockingQueuedConnection);
+        if (ok) *ok = innerOk;
+        return result;
+    }
+    
+    QString value;
+    bool valueOk = false;
+    if (serveCached(command, ttlMs, &value, &valueOk)) {
+        if (ok) *ok = valueOk;
+        return value;
+    }
     
-    if (m_cache.contains(command)) {
-        CacheEntry& entry = m_cache[command];
-        if (entry.isValid()) {
-            return entry.value;
+    // Cache miss - start the fetch, or join the one already running
+    quint64 generation = 0;
+    quint64 token = 0;
+    if (beginFetch(command, &generation, &token)) {
+        runFetch(command, ttlMs, generation, token, true);
+    } else {
+        QMutexLocker locker(&m_cacheMutex);
+        m_cacheStats.coalesced++;
+    }
+    
+    quint64 fetchId = 0;
+    quint64 queuedToken = 0;
+    {
+        QMutexLocker locker(&m_cacheMutex);
+        auto it = m_cache.constFind(command);
+        if (it != m_cache.cend() && it->inFlight) {
+            fetchId = it->fetchId;
+            queuedToken = it->fetchId ? 0 : it->fetchToken;
+            generation = m_cacheGeneration;
         }
     }
+    if (fetchId) {
+        // Pipelined on our session: pumping it delivers the result
+        m_session->waitFor(fetchId, CACHE_FETCH_TIMEOUT_MS);
+    } else if (queuedToken) {
+        // A queued one-shot refresh: run it now rather than wait for the event loop
+        runFetch(command, ttlMs, generation, queuedToken, true);
+    }
     
-    // Cache miss - execute and store
+    QMutexLocker locker(&m_cacheMutex);
+    const CacheEntry entry = m_cache.value(command);
+    if (ok) *ok = entry.hasValue && !entry.failed;
+    return entry.value;
+}
+
+void AdbConnection::getCachedAsync(const QString& command, int ttlMs, CachedCallback callback)
+{
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, command, ttlMs, callback]() {
+            getCachedAsync(command, ttlMs, callback);
+        }, Qt::QueuedConnection);
+        return;
+    }
+    
+    QString value;
+    bool ok = false;
+    if (serveCached(command, ttlMs, &value, &ok)) {
+        if (callback) callback(value, ok);
+        return;
+    }
+    
+    // Registered before the fetch starts: a failed submit() completes it synchronously
+    quint64 generation = 0;
+    quint64 token = 0;
+    const bool started = beginFetch(command, &generation, &token);
+    {
+        QMutexLocker locker(&m_cacheMutex);
+        if (!started) m_cacheStats.coalesced++;
+        if (callback) m_cache[command].waiters.append(std::move(callback));
+    }
+    if (started) {
+        runFetch(command, ttlMs, generation, token, false);
+    }
+}
+
+bool AdbConnection::serveCached(const QString& command, int ttlMs, QString* value, bool* ok)
+{
+    QMutexLocker locker(&m_cacheMutex);
+    
+    auto it = m_cache.constFind(command);
+    if (it == m_cache.cend()) return false;
+    
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (it->isValid(now)) {
+        m_cacheStats.hits++;
+        *value = it->value;
+        *ok = !it->failed;
+        return true;
+    }
+    if (!it->isStale(now)) return false;
+    
+    // Stale-while-revalidate: answer now, refresh off the caller's path
+    m_cacheStats.staleHits++;
+    *value = it->value;
+    *ok = true;
+    const bool refresh = !it->inFlight;
     locker.unlock();
-    QString result = execute(command);
     
-    locker.relock();
-    CacheEntry entry;
-    entry.value = result;
-    entry.timestamp = QDateTime::currentMSecsSinceEpoch();
-    entry.ttlMs = ttlMs;
-    m_cache[command] = entry;
+    quint64 generation = 0;
+    quint64 token = 0;
+    if (refresh && beginFetch(command, &generation, &token)) {
+        runFetch(command, ttlMs, generation, token, false);
+    }
+    return true;
+}
+
+bool AdbConnection::beginFetch(const QString& command, quint64* generation, quint64* token)
+{
+    QMutexLocker locker(&m_cacheMutex);
+    
+    CacheEntry& entry = m_cache[command];
+    if (entry.inFlight) return false;
     
-    return result;
+    entry.inFlight = true;
+    entry.fetchId = 0;
+    entry.fetchToken = m_nextFetchToken++;
+    m_cacheStats.misses++;
+    *generation = m_cacheGeneration;
+    *token = entry.fetchToken;
+    return true;
+}
+
+void AdbConnection::runFetch(const QString& command, int ttlMs, quint64 generation, quint64 token, bool blocking)
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    if (m_connected && m_session->ensureRunning()) {
+        // Pipelined behind whatever the session is doing; no blocking here
+        const quint64 id = m_session->submit(command, [this, command, ttlMs, generation, timer](const AdbShellSession::Result& r) {
+            storeCached(command, r.output.trimmed(), r.ok, ttlMs, generation, timer.elapsed());
+        }, CACHE_FETCH_TIMEOUT_MS);
+        
+        QMutexLocker locker(&m_cacheMutex);
+        auto it = m_cache.find(command);
+        if (it != m_cache.end() && it->inFlight && it->fetchToken == token) {
+            it->fetchId = id;   // Unless submit() already failed it
+        }
+        return;
+    }
+    
+    if (!blocking) {
+        // One-shot fallback blocks; keep it off the caller's path
+        QMetaObject::invokeMethod(this, [this, command, ttlMs, generation, token]() {
+            {
+                QMutexLocker locker(&m_cacheMutex);
+                auto it = m_cache.constFind(command);
+                if (it == m_cache.cend() || !it->inFlight || it->fetchToken != token) {
+                    return;   // A blocking getCached() already ran it
+                }
+            }
+            runFetch(command, ttlMs, generation, token, true);
+        }, Qt::QueuedConnection);
+        return;
+    }
+    
+    bool ok = false;
+    QString result = execute(command, CACHE_FETCH_TIMEOUT_MS, &ok);
+    storeCached(command, result, ok, ttlMs, generation, timer.elapsed());
+}
+
+void AdbConnection::storeCached(const QString& command, const QString& value, bool ok,
+                                int ttlMs, quint64 generation, qint64 fetchMs)
+{
+    QList<CachedCallback> waiters;
+    {
+        QMutexLocker locker(&m_cacheMutex);
+        
+        m_cacheStats.fetchTimeMs += fetchMs;
+        m_cacheStats.maxFetchMs = qMax(m_cacheStats.maxFetchMs, fetchMs);
+        if (!ok) m_cacheStats.failures++;
+        
+        auto it = m_cache.find(command);
+        if (it == m_cache.end()) return;
+        
+        it->inFlight = false;
+        it->fetchId = 0;
+        waiters.swap(it->waiters);
+        
+        // Results that started before an invalidation are dropped
+        if (generation == m_cacheGeneration) {
+            it->value = value;
+            it->timestamp = QDateTime::currentMSecsSinceEpoch();
+            it->ttlMs = ok ? ttlMs : qMin(ttlMs, NEGATIVE_TTL_MS);
+            it->hasValue = true;
+            it->failed = !ok;
+        }
+    }
+    
+    // Outside the lock: a waiter may ask the cache again
+    for (const CachedCallback& waiter : waiters) {
+        waiter(value, ok);
+    }
 }
 
 void AdbConnection::invalidateCache(const QString& command)
 {
     QMutexLocker locker(&m_cacheMutex);
     
+    m_cacheGeneration++;
     if (command.isEmpty()) {
-        m_cache.clear();
+        // In-flight entries stay so their waiters are released by storeCached()
+        for (auto it = m_cache.begin(); it != m_cache.end();) {
+            if (it->inFlight) {
+                it->hasValue = false;
+                ++it;
+            } else {
+                it = m_cache.erase(it);
+            }
+        }
         qDebug() << "[AdbConnection] Cache cleared";
     } else {
-        m_cache.remove(command);
+        auto it = m_cache.find(command);
+        if (it != m_cache.end()) {
+            if (it->inFlight) {
+                it->hasValue = false;
+            } else {
+                m_cache.erase(it);
+            }
+        }
     }
 }
 
+AdbConnection::CacheStats AdbConnection::cacheStats() const
+{
+    QMutexLocker locker(&m_cacheMutex);
+    return m_cacheStats;
+}
+
 // ========== FREE FIRE SHORTCUTS ==========
 QString AdbConnection::getScreenSize()
 {
-    return getCached("wm size", 5000); // Cache for 5 seconds (rarely changes)
+    return getCached(SCREEN_SIZE_COMMAND, DISPLAY_TTL_MS);
 }
 
 QString AdbConnection::getDensity()
 {
-    return getCached("wm density", 5000);
+    return getCached(DENSITY_COMMAND, DISPLAY_TTL_MS);
 }
 
 bool AdbConnection::isFreeFireRunning()
 {
-    QString pid = getCached("pidof com.dts.freefireth", 500); // Cache for 500ms
+    QString pid = getCached(FREEFIRE_PID_COMMAND, PID_TTL_MS);
     return !pid.isEmpty();
 }
 
 QString AdbConnection::getCurrentFocus()
 {
-    return getCached("dumpsys window displays | grep mCurrentFocus", 200);
+    return getCached(FOCUS_COMMAND, FOCUS_TTL_MS);
 }
 
 } // namespace NeoZ
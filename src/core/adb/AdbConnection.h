@@ -9,6 +9,8 @@
 #include <QQueue>
 #include <memory>
 #include <functional>
+#include "AdbShellSession.h"
+#include "AdbSocketClient.h"
 
 namespace NeoZ {
 
@@ -16,9 +18,18 @@ namespace NeoZ {
  * @brief
  * Features:
  * - Command batching: Combines multiple commands into single shell session
- * - Caching: Short-lived cache for frequently polled values
+ * - Caching: Short-lived cache for frequently polled values, shared by all
+ *   callers of this connection (concurrent misses coalesce into one fetch,
+ *   recently expired values are served while a refresh runs, failures are
+ *   cached briefly). Fetches run on this object's thread, pipelined on the
+ *   session; getCached() from another thread is forwarded there, and
+ *   getCachedAsync() callers are notified when the fetch lands
  * - Async execution: Non-blocking command execution
  * - Connection pooling: Reuses ADB connection when possible
+ * - Persistent shell: commands go through one multiplexed AdbShellSession
+ *   (sub-ms round trips)
+ * - Native fallback: one-shot commands use the adb server's socket protocol
+ *   (AdbSocketClient); the adb binary is only spawned if the server is down
  */
 class AdbConnection : public QObject
 {
@@ -40,13 +51,14 @@ public:
     int latencyMs() const { return m_latencyMs; }
     
     // Set ADB path
-    void setAdbPath(const QString& path) { m_adbPath = path; }
+    void setAdbPath(const QString& path) { m_adbPath = path; m_session->setAdbPath(path); }
     QString adbPath() const { return m_adbPath; }
     
-    // Synchronous execution (blocking)
-    QString execute(const QString& command, int timeoutMs = 5000);
+    // Synchronous execution (blocking); *ok is false if the command could not run.
+    // Callable from any thread: forwarded to ours with a blocking queued call
+    QString execute(const QString& command, int timeoutMs = 5000, bool* ok = nullptr);
     
-    // Asynchronous execution
+    // Asynchronous execution; the callback runs on this object's thread
     void executeAsync(const QString& command, 
                       std::function<void(const QString&)> callback = nullptr);
     
@@ -59,16 +71,46 @@ public:
     };
     BatchResult executeBatch(const QStringList& commands, int timeoutMs = 10000);
     
-    // Cached getters - uses internal cache with TTL
-    QString getCached(const QString& command, int ttlMs = 500);
+    // Cached getters - uses internal cache with TTL. *ok / the callback's ok
+    // is false for a (negatively cached) failed fetch
+    using CachedCallback = std::function<void(const QString& value, bool ok)>;
+    QString getCached(const QString& command, int ttlMs = 500, bool* ok = nullptr);
+    // Non-blocking; the callback runs on this object's thread, immediately on a hit
+    void getCachedAsync(const QString& command, int ttlMs, CachedCallback callback);
     void invalidateCache(const QString& command = QString());
     
+    struct CacheStats {
+        quint64 hits = 0;         // Fresh value returned
+        quint64 staleHits = 0;    // Expired value returned, refresh started
+        quint64 coalesced = 0;    // Joined a fetch already in flight
+        quint64 misses = 0;       // Fetches started (incl. background refreshes)
+        quint64 failures = 0;     // Fetches that failed (negatively cached)
+        qint64 fetchTimeMs = 0;   // Sum over all fetches
+        qint64 maxFetchMs = 0;
+        
+        double avgFetchMs() const { return misses ? double(fetchTimeMs) / misses : 0.0; }
+    };
+    CacheStats cacheStats() const;
+    
+    // Polled commands and their TTLs; async pollers use these so they share
+    // the shortcuts' cache entries
+    static constexpr const char* SCREEN_SIZE_COMMAND = "wm size";
+    static constexpr const char* DENSITY_COMMAND = "wm density";
+    static constexpr const char* FREEFIRE_PID_COMMAND = "pidof com.dts.freefireth";
+    static constexpr const char* FOCUS_COMMAND = "dumpsys window displays | grep mCurrentFocus";
+    static constexpr int DISPLAY_TTL_MS = 5000;      // Screen size, density: rarely change
+    static constexpr int PID_TTL_MS = 500;
+    static constexpr int FOCUS_TTL_MS = 200;
+    
     // Free Fire specific shortcuts
     QString getScreenSize();
     QString getDensity();
     bool isFreeFireRunning();
     QString getCurrentFocus();
     
+    // Persistent multiplexed shell for the connected device
+    AdbShellSession* session() const { return m_session.get(); }
+    
 signals:
     void connectionChanged();
     void latencyChanged();
@@ -82,12 +124,32 @@ private slots:
 private:
     struct CacheEntry {
         QString value;
-        qint64 timestamp;
-        int ttlMs;
+        qint64 timestamp = 0;
+        int ttlMs = 0;
+        bool hasValue = false;
+        bool failed = false;              // Negative entry: command did not run
+        bool inFlight = false;            // A fetch is running; others join it
+        quint64 fetchId = 0;              // Session command id of that fetch (0 = one-shot)
+        quint64 fetchToken = 0;           // Identifies the fetch a queued one-shot belongs to
+        QList<CachedCallback> waiters;    // getCachedAsync() callers waiting for it
         
-        bool isValid() const;
+        bool isValid(qint64 now) const;   // Within TTL
+        bool isStale(qint64 now) const;   // Past TTL but still servable
     };
     
+    // Fresh or stale value under the lock (stale starts a refresh); false on a miss
+    bool serveCached(const QString& command, int ttlMs, QString* value, bool* ok);
+    // Marks the entry in flight; returns false if a fetch is already running
+    bool beginFetch(const QString& command, quint64* generation, quint64* token);
+    // Starts the fetch: pipelined on the session, else one-shot (now, or queued)
+    void runFetch(const QString& command, int ttlMs, quint64 generation, quint64 token, bool blocking);
+    void storeCached(const QString& command, const QString& value, bool ok,
+                     int ttlMs, quint64 generation, qint64 fetchMs);
+    
+    // Fallback when the persistent session cannot run
+    QString executeOneShot(const QString& command, int timeoutMs, bool* ok = nullptr);
+    QString executeProcess(const QString& command, int timeoutMs, bool* ok = nullptr);
+    
     struct AsyncCommand {
         QString command;
         std::function<void(const QString&)> callback;
@@ -98,17 +160,31 @@ private:
     bool m_connected = false;
     int m_latencyMs = 0;
     
-    // Command cache
+    // Command cache. Only touched on this object's thread; the mutex lets
+    // cacheStats() be read from anywhere and is never held across a fetch
     QHash<QString, CacheEntry> m_cache;
-    QMutex m_cacheMutex;
+    mutable QMutex m_cacheMutex;
+    quint64 m_cacheGeneration = 0;        // Bumped by invalidateCache()
+    quint64 m_nextFetchToken = 1;
+    CacheStats m_cacheStats;
+    
+    // Multiplexed shell (primary path)
+    std::unique_ptr<AdbShellSession> m_session;
     
-    // Async queue
+    // adb server socket protocol (no adb.exe per command)
+    std::unique_ptr<AdbSocketClient> m_socketClient;
+    
+    // Async queue (one-shot fallback)
     QQueue<AsyncCommand> m_asyncQueue;
     std::unique_ptr<QProcess> m_asyncProcess;
     bool m_asyncBusy = false;
     
     // Batch separator for combining commands
     static constexpr const char* BATCH_SEPARATOR = "---NEOZ_BATCH_SEP---";
+    
+    static constexpr int CACHE_FETCH_TIMEOUT_MS = 5000;
+    static constexpr int NEGATIVE_TTL_MS = 1000;     // Cap for failed fetches
+    static constexpr int STALE_FACTOR = 2;           // Serve stale up to ttl * STALE_FACTOR past expiry
 };
 
 } // namespace NeoZ
@@ -7,13 +7,31 @@
 AdbConnector::AdbConnector(QObject *parent)
     : QObject(parent),
       m_scanTimer(new QTimer(this)),
-      m_adbProcess(std::make_unique<QProcess>(this))
+      m_adbProcess(std::make_unique<QProcess>(this)),
+      m_socketClient(std::make_unique<NeoZ::AdbSocketClient>(this)),
+      m_deviceTracker(std::make_unique<NeoZ::AdbDeviceTracker>(this))
 {
     detectAdbPath();
     
     connect(m_scanTimer, &QTimer::timeout, this, &AdbConnector::onScanTimeout);
     connect(m_adbProcess.get(), QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
             this, &AdbConnector::processScanResult);
+    
+    // Plug/unplug and offline/online transitions are pushed by the server,
+    // so the list stays current between scans
+    auto onTracked = [this](const QString& serial) {
+        NeoZ::AdbDeviceTracker::Device tracked = m_deviceTracker->device(serial);
+        if (tracked.state == "device") {
+            addTrackedDevice(tracked);
+        } else {
+            removeDevice(serial);
+        }
+    };
+    connect(m_deviceTracker.get(), &NeoZ::AdbDeviceTracker::deviceAdded, this, onTracked);
+    connect(m_deviceTracker.get(), &NeoZ::AdbDeviceTracker::deviceStateChanged, this, onTracked);
+    connect(m_deviceTracker.get(), &NeoZ::AdbDeviceTracker::deviceRemoved, this, &AdbConnector::removeDevice);
+    m_deviceTracker->setServer(m_socketClient->host(), m_socketClient->port());
+    m_deviceTracker->start();
 }
 
 AdbConnector::~AdbConnector()
@@ -169,11 +187,20 @@ void AdbConnector::processScanResult()
 
 void AdbConnector::updateDeviceList()
 {
-    QProcess devicesProcess;
-    devicesProcess.start(m_adbPath, QStringList() << "devices" << "-l");
-    
-    if (devicesProcess.waitForFinished(3000)) {
-        parseDevices(devicesProcess.readAllStandardOutput());
+    if (m_deviceTracker->isTracking()) {
+        // Tracker already holds the server's list; no adb process needed
+        for (const auto& tracked : m_deviceTracker->devices()) {
+            if (tracked.state == "device") {
+                addTrackedDevice(tracked);
+            }
+        }
+    } else {
+        QProcess devicesProcess;
+        devicesProcess.start(m_adbPath, QStringList() << "devices" << "-l");
+        
+        if (devicesProcess.waitForFinished(3000)) {
+            parseDevices(devicesProcess.readAllStandardOutput());
+        }
     }
     
     // Scan complete
@@ -202,16 +229,7 @@ void AdbConnector::parseDevices(const QString& output)
             QString deviceId = parts[0];
             QString status = parts[1];
             
-            // Check if already in list
-            bool found = false;
-            for (const EmulatorDevice& d : m_devices) {
-                if (d.id == deviceId) {
-                    found = true;
-                    break;
-                }
-            }
-            
-            if (!found && status == "device") {
+            if (!hasDevice(deviceId) && status == "device") {
                 EmulatorDevice device;
                 device.id = deviceId;
                 device.status = status;
@@ -236,6 +254,52 @@ void AdbConnector::parseDevices(const QString& output)
     }
 }
 
+bool AdbConnector::hasDevice(const QString& deviceId) const
+{
+    for (const EmulatorDevice& d : m_devices) {
+        if (d.id == deviceId) return true;
+    }
+    return false;
+}
+
+void AdbConnector::addTrackedDevice(const NeoZ::AdbDeviceTracker::Device& tracked)
+{
+    if (hasDevice(tracked.serial)) return;
+    
+    EmulatorDevice device;
+    device.id = tracked.serial;
+    device.status = tracked.state;
+    device.isConnected = true;
+    device.name = tracked.model.isEmpty() ? QString("Android Device")
+                                          : QString(tracked.model).replace("_", " ");
+    
+    m_devices.append(device);
+    m_deviceList.append(QString("%1 (%2)").arg(device.name, device.id));
+    emit deviceListChanged();
+    emit deviceFound(device.id, device.name);
+}
+
+void AdbConnector::removeDevice(const QString& deviceId)
+{
+    for (int i = 0; i < m_devices.size(); ++i) {
+        if (m_devices[i].id != deviceId) continue;
+        
+        qDebug() << "[AdbConnector] Device gone:" << deviceId;
+        m_deviceList.removeOne(QString("%1 (%2)").arg(m_devices[i].name, deviceId));
+        m_devices.removeAt(i);
+        emit deviceListChanged();
+        break;
+    }
+    
+    if (deviceId == m_selectedDevice) {
+        m_selectedDevice.clear();
+        m_connectionStatus = "Disconnected";
+        emit selectedDeviceChanged();
+        emit connectionStatusChanged();
+        emit deviceDisconnected();
+    }
+}
+
 void AdbConnector::onScanTimeout()
 {
     qDebug() << "[AdbConnector] Scan timeout";
@@ -305,6 +369,15 @@ QString AdbConnector::executeCommand(const QString& command, int timeoutMs)
         return QString();
     }
     
+    // Native path: no adb process, just a socket to the running adb server
+    NeoZ::AdbSocketClient::Reply reply = m_socketClient->shell(m_selectedDevice, command, timeoutMs);
+    if (reply.ok) {
+        QString output = QString::fromUtf8(reply.data).trimmed();
+        qDebug() << "[AdbConnector] Command output:" << output;
+        return output;
+    }
+    qDebug() << "[AdbConnector] Socket client failed:" << reply.error << "- using adb binary";
+    
     QProcess adbProcess;
     QStringList args;
     args << "-s" << m_selectedDevice << "shell" << command;
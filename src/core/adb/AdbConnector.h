@@ -7,6 +7,8 @@
 #include <QProcess>
 #include <QTimer>
 #include <memory>
+#include "AdbSocketClient.h"
+#include "AdbDeviceTracker.h"
 
 // Represents a detected emulator device
 struct EmulatorDevice {
@@ -75,6 +77,9 @@ private:
     void tryConnectPort(const QString& port);
     void updateDeviceList();
     void parseDevices(const QString& output);
+    bool hasDevice(const QString& deviceId) const;
+    void addTrackedDevice(const NeoZ::AdbDeviceTracker::Device& tracked);
+    void removeDevice(const QString& deviceId);
 
     bool m_isScanning = false;
     QString m_selectedDevice;
@@ -84,6 +89,8 @@ private:
     
     QTimer* m_scanTimer;
     std::unique_ptr<QProcess> m_adbProcess;
+    std::unique_ptr<NeoZ::AdbSocketClient> m_socketClient;  // Native adb server protocol
+    std::unique_ptr<NeoZ::AdbDeviceTracker> m_deviceTracker;  // Live device list from the server
     QStringList m_commonPorts = {"5555", "5556", "5554", "62001", "21503"};
     int m_currentPortIndex = 0;
     
@@ -0,0 +1,206 @@
+#include "AdbDeviceTracker.h"
+#include <QDebug>
+#include <QTcpSocket>
+#include <QTimer>
+
+namespace NeoZ {
+
+AdbDeviceTracker::AdbDeviceTracker(QObject* parent)
+    : QObject(parent)
+{
+    bool ok = false;
+    int envPort = qEnvironmentVariableIntValue("ANDROID_ADB_SERVER_PORT", &ok);
+    if (ok && envPort > 0 && envPort < 65536) {
+        m_port = static_cast<quint16>(envPort);
+    }
+
+    m_retryTimer = new QTimer(this);
+    m_retryTimer->setSingleShot(true);
+    connect(m_retryTimer, &QTimer::timeout, this, &AdbDeviceTracker::connectToServer);
+}
+
+AdbDeviceTracker::~AdbDeviceTracker()
+{
+    stop();
+}
+
+void AdbDeviceTracker::setServer(const QString& host, quint16 port)
+{
+    m_host = host;
+    m_port = port;
+    if (m_running) {
+        stop();
+        start();
+    }
+}
+
+void AdbDeviceTracker::start()
+{
+    if (m_running) return;
+    m_running = true;
+    m_retryDelayMs = INITIAL_RETRY_MS;
+    connectToServer();
+}
+
+void AdbDeviceTracker::stop()
+{
+    m_running = false;
+    m_retryTimer->stop();
+    if (m_socket) {
+        QObject::disconnect(m_socket, nullptr, this, nullptr);
+        m_socket->abort();
+        m_socket->deleteLater();
+        m_socket = nullptr;
+    }
+    m_buffer.clear();
+    setTracking(false);
+}
+
+void AdbDeviceTracker::connectToServer()
+{
+    if (!m_running) return;
+
+    if (m_socket) {
+        QObject::disconnect(m_socket, nullptr, this, nullptr);
+        m_socket->deleteLater();
+    }
+    m_buffer.clear();
+
+    m_socket = new QTcpSocket(this);
+    connect(m_socket, &QTcpSocket::connected, this, &AdbDeviceTracker::onConnected);
+    connect(m_socket, &QTcpSocket::readyRead, this, &AdbDeviceTracker::onReadyRead);
+    connect(m_socket, &QTcpSocket::disconnected, this, &AdbDeviceTracker::onDisconnected);
+    connect(m_socket, &QTcpSocket::errorOccurred, this, [this](QAbstractSocket::SocketError) {
+        // Refused (server down) never reaches disconnected()
+        if (m_socket && m_socket->state() != QAbstractSocket::ConnectedState) {
+            onDisconnected();
+        }
+    });
+    m_socket->connectToHost(m_host, m_port);
+}
+
+void AdbDeviceTracker::onConnected()
+{
+    m_socket->write(AdbSocketClient::encodeRequest("host:track-devices-l"));
+}
+
+void AdbDeviceTracker::onReadyRead()
+{
+    m_buffer += m_socket->readAll();
+
+    if (!m_tracking) {
+        if (m_buffer.size() < 4) return;
+        if (!m_buffer.startsWith("OKAY")) {
+            // FAIL + length + message; retry later
+            qWarning() << "[AdbDeviceTracker] Server refused track-devices:" << m_buffer.mid(8);
+            dropConnection("refused");
+            return;
+        }
+        m_buffer.remove(0, 4);
+        m_retryDelayMs = INITIAL_RETRY_MS;
+        setTracking(true);
+        qDebug() << "[AdbDeviceTracker] Tracking devices on" << m_host << ":" << m_port;
+    }
+
+    // Each message is a complete snapshot; only the newest matters
+    QByteArray latest;
+    bool haveSnapshot = false;
+    while (m_buffer.size() >= 4) {
+        bool ok = false;
+        int length = m_buffer.left(4).toInt(&ok, 16);
+        if (!ok) {
+            qWarning() << "[AdbDeviceTracker] Bad length prefix - reconnecting";
+            dropConnection("bad length prefix");
+            return;
+        }
+        if (m_buffer.size() < 4 + length) break;
+        latest = m_buffer.mid(4, length);
+        m_buffer.remove(0, 4 + length);
+        haveSnapshot = true;
+    }
+
+    if (haveSnapshot) {
+        applySnapshot(parseDeviceList(latest));
+    }
+}
+
+void AdbDeviceTracker::dropConnection(const char* reason)
+{
+    // Detach first: abort() would report the disconnect again through
+    // disconnected() and schedule a second, longer backoff step
+    qDebug() << "[AdbDeviceTracker] Dropping connection:" << reason;
+    QObject::disconnect(m_socket, nullptr, this, nullptr);
+    m_socket->abort();
+    m_socket->deleteLater();
+    m_socket = nullptr;
+    m_buffer.clear();
+    onDisconnected();
+}
+
+void AdbDeviceTracker::onDisconnected()
+{
+    if (m_tracking) {
+        qDebug() << "[AdbDeviceTracker] Lost adb server connection";
+    }
+    setTracking(false);
+    scheduleReconnect();
+}
+
+void AdbDeviceTracker::scheduleReconnect()
+{
+    if (!m_running || m_retryTimer->isActive()) return;
+    m_retryTimer->start(m_retryDelayMs);
+    m_retryDelayMs = qMin(m_retryDelayMs * 2, MAX_RETRY_MS);
+}
+
+void AdbDeviceTracker::setTracking(bool tracking)
+{
+    if (m_tracking == tracking) return;
+    m_tracking = tracking;
+    emit trackingChanged();
+}
+
+QMap<QString, AdbDeviceTracker::Device> AdbDeviceTracker::parseDeviceList(const QByteArray& payload)
+{
+    // Same format as `host:devices-l`, states with spaces included
+    QMap<QString, Device> devices;
+    for (const Device& device : AdbSocketClient::parseDevices(payload)) {
+        devices.insert(device.serial, device);
+    }
+    return devices;
+}
+
+void AdbDeviceTracker::applySnapshot(const QMap<QString, Device>& next)
+{
+    const QMap<QString, Device> previous = m_devices;
+    m_devices = next;
+
+    bool changed = false;
+    for (auto it = previous.cbegin(); it != previous.cend(); ++it) {
+        if (!next.contains(it.key())) {
+            qDebug() << "[AdbDeviceTracker] Removed:" << it.key();
+            emit deviceRemoved(it.key());
+            changed = true;
+        }
+    }
+    for (auto it = next.cbegin(); it != next.cend(); ++it) {
+        auto old = previous.constFind(it.key());
+        if (old == previous.cend()) {
+            qDebug() << "[AdbDeviceTracker] Added:" << it.key() << it->state;
+            emit deviceAdded(it.key(), it->state);
+            changed = true;
+        } else if (old->state != it->state) {
+            qDebug() << "[AdbDeviceTracker]" << it.key() << ":" << old->state << "->" << it->state;
+            emit deviceStateChanged(it.key(), old->state, it->state);
+            changed = true;
+        } else if (old->model != it->model) {
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        emit devicesChanged();
+    }
+}
+
+} // namespace NeoZ
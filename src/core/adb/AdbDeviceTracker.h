@@ -0,0 +1,91 @@
+#ifndef NEOZ_ADBDEVICETRACKER_H
+#define NEOZ_ADBDEVICETRACKER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include "AdbSocketClient.h"
+
+class QTcpSocket;
+class QTimer;
+
+namespace NeoZ {
+
+/**
+ * @brief Push-based device list from the adb server (host:track-devices-l).
+ *
+ * Keeps one socket open to the adb server. The server answers OKAY and
+ * then writes the full device list (4 hex digits length + text) every
+ * time anything changes, so connects, disconnects and state changes
+ * (offline -> device, unauthorized, ...) arrive within milliseconds with
+ * no polling. Each snapshot is diffed against the previous one and
+ * emitted as add / remove / state-change events.
+ *
+ * If the server is not running or goes away (kill-server), the tracker
+ * reconnects with exponential backoff; isTracking() is false meanwhile so
+ * owners can fall back to `adb devices` (which also starts the server).
+ */
+class AdbDeviceTracker : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool tracking READ isTracking NOTIFY trackingChanged)
+
+public:
+    // Same fields as `adb devices -l`
+    using Device = AdbSocketClient::Device;
+
+    explicit AdbDeviceTracker(QObject* parent = nullptr);
+    ~AdbDeviceTracker();
+
+    void setServer(const QString& host, quint16 port);
+
+    void start();
+    void stop();
+    bool isTracking() const { return m_tracking; }
+
+    // Latest snapshot, by serial
+    QList<Device> devices() const { return m_devices.values(); }
+    bool contains(const QString& serial) const { return m_devices.contains(serial); }
+    Device device(const QString& serial) const { return m_devices.value(serial); }
+
+    // Parse one track-devices-l payload
+    static QMap<QString, Device> parseDeviceList(const QByteArray& payload);
+
+signals:
+    void trackingChanged();
+    void deviceAdded(const QString& serial, const QString& state);
+    void deviceRemoved(const QString& serial);
+    void deviceStateChanged(const QString& serial, const QString& oldState, const QString& newState);
+    void devicesChanged();
+
+private slots:
+    void onConnected();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    void connectToServer();
+    void dropConnection(const char* reason);
+    void scheduleReconnect();
+    void setTracking(bool tracking);
+    void applySnapshot(const QMap<QString, Device>& next);
+
+    QString m_host = "127.0.0.1";
+    quint16 m_port = 5037;
+    QTcpSocket* m_socket = nullptr;
+    QTimer* m_retryTimer = nullptr;
+    QByteArray m_buffer;
+    bool m_running = false;
+    bool m_tracking = false;        // OKAY received on the current socket
+    int m_retryDelayMs = INITIAL_RETRY_MS;
+    QMap<QString, Device> m_devices;
+
+    static constexpr int INITIAL_RETRY_MS = 250;
+    static constexpr int MAX_RETRY_MS = 4000;
+};
+
+} // namespace NeoZ
+
+#endif // NEOZ_ADBDEVICETRACKER_H
@@ -0,0 +1,460 @@
+#include "AdbShellSession.h"
+#include <QDebug>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QThread>
+#include <algorithm>
+
+namespace NeoZ {
+
+AdbShellSession::AdbShellSession(QObject* parent)
+    : QObject(parent)
+    , m_watchdog(new QTimer(this))
+{
+    m_watchdog->setSingleShot(true);
+    QObject::connect(m_watchdog, &QTimer::timeout, this, [this]() { checkDeadlines(); });
+}
+
+AdbShellSession::~AdbShellSession()
+{
+    stop();
+}
+
+void AdbShellSession::setDeviceId(const QString& deviceId)
+{
+    if (m_deviceId == deviceId) return;
+    stop();
+    m_deviceId = deviceId;
+    m_lastStartMs = 0;
+}
+
+bool AdbShellSession::isRunning() const
+{
+    return m_process && m_process->state() == QProcess::Running;
+}
+
+bool AdbShellSession::ensureRunning(int timeoutMs)
+{
+    if (isRunning()) return true;
+    if (m_deviceId.isEmpty()) return false;
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (m_lastStartMs != 0 && now - m_lastStartMs < RECONNECT_BACKOFF_MS) {
+        return false;
+    }
+    if (m_lastStartMs != 0) {
+        ++m_restarts;
+    }
+    m_lastStartMs = now;
+
+    if (!m_process) {
+        m_process = new QProcess(this);
+        m_process->setReadChannel(QProcess::StandardOutput);
+        QObject::connect(m_process, &QProcess::readyReadStandardOutput,
+                         this, &AdbShellSession::onReadyRead);
+        QObject::connect(m_process, &QProcess::readyReadStandardError,
+                         this, &AdbShellSession::onReadyReadError);
+        QObject::connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                         this, &AdbShellSession::onFinished);
+    }
+
+    m_buffer.clear();
+    m_errBuffer.clear();
+    m_process->start(m_adbPath, {"-s", m_deviceId, "shell", "sh"});
+    if (!m_process->waitForStarted(timeoutMs)) {
+        qWarning() << "[AdbShellSession] Failed to start shell for" << m_deviceId
+                   << ":" << m_process->errorString();
+        return false;
+    }
+
+    // Older adbd allocates a PTY; turn off echo so frames don't leak into
+    // output. The first framed no-op absorbs anything printed before it,
+    // on both channels.
+    m_process->write("stty -echo 2>/dev/null\n");
+    m_pending.push_back({m_nextId, nullptr, false});
+    startHead();
+    m_process->write(QStringLiteral("printf '\\n%1%3__\\n' >&2; printf '\\n%2%3_%d__\\n' 0\n")
+                         .arg(QLatin1String(ERR_MARKER), QLatin1String(END_MARKER))
+                         .arg(m_nextId).toUtf8());
+    ++m_nextId;
+
+    qDebug() << "[AdbShellSession] Shell session started for" << m_deviceId;
+    emit sessionStarted();
+    return true;
+}
+
+void AdbShellSession::stop()
+{
+    if (!m_process) return;
+
+    if (m_process->state() != QProcess::NotRunning) {
+        m_process->write("exit\n");
+        m_process->closeWriteChannel();
+        if (!m_process->waitForFinished(500)) {
+            m_process->kill();
+            m_process->waitForFinished(1000);
+        }
+    }
+    failAll(QStringLiteral("session stopped"));
+    m_buffer.clear();
+    m_errBuffer.clear();
+    m_lastStartMs = 0;  // A deliberate stop is not a failure to back off from
+}
+
+void AdbShellSession::restart(const QString& reason)
+{
+    qWarning() << "[AdbShellSession] Restarting session:" << reason;
+    if (m_process && m_process->state() != QProcess::NotRunning) {
+        m_process->kill();
+        m_process->waitForFinished(1000);
+    }
+    failAll(reason);
+    m_buffer.clear();
+    m_errBuffer.clear();
+    m_lastStartMs = 0;  // Allow an immediate reconnect
+}
+
+quint64 AdbShellSession::submit(const QString& command, Callback callback, int timeoutMs)
+{
+    return enqueue(command, std::move(callback), false, timeoutMs);
+}
+
+quint64 AdbShellSession::enqueue(const QString& command, Callback callback, bool sync, int timeoutMs)
+{
+    const quint64 id = m_nextId++;
+
+    if (!ensureRunning()) {
+        Result failed;
+        failed.error = QStringLiteral("shell session unavailable");
+        if (sync) {
+            m_syncResults.insert(id, failed);
+        } else if (callback) {
+            callback(failed);
+        }
+        return id;
+    }
+
+    // Command stdin is /dev/null so it can never eat the frames queued behind it.
+    // An empty group is a syntax error that would kill the shell.
+    // Concatenated rather than arg()'d so '%N' inside the command survives.
+    const QString tag = QString::number(id);
+    QString body = command.trimmed().isEmpty() ? QStringLiteral(":") : command;
+    QString frame = "{ " + body + "\n} </dev/null; __neoz_rc=$?; printf '\\n"
+                    + QLatin1String(ERR_MARKER) + tag + "__\\n' >&2; printf '\\n"
+                    + QLatin1String(END_MARKER) + tag + "_%d__\\n' $__neoz_rc\n";
+    Pending pending{id, std::move(callback), sync};
+    pending.timeoutMs = timeoutMs;
+    m_pending.push_back(std::move(pending));
+    m_process->write(frame.toUtf8());
+    startHead();
+    return id;
+}
+
+void AdbShellSession::onReadyRead()
+{
+    m_buffer += m_process->readAllStandardOutput();
+    m_buffer.replace('\r', QByteArray());  // PTY sessions translate \n to \r\n
+
+    const QByteArray marker = QByteArray("\n") + END_MARKER;
+    const QByteArray errMarker = QByteArray("\n") + ERR_MARKER;
+
+    while (!m_pending.empty()) {
+        int pos = m_buffer.indexOf(marker);
+        if (pos < 0) break;
+        int lineEnd = m_buffer.indexOf('\n', pos + marker.size());
+        if (lineEnd < 0) break;
+
+        // "<id>_<exit>__"
+        QByteArray tag = m_buffer.mid(pos + marker.size(), lineEnd - pos - marker.size());
+        QList<QByteArray> parts = tag.left(tag.size() - 2).split('_');
+        bool idOk = false;
+        bool codeOk = false;
+        quint64 id = parts.size() == 2 ? parts[0].toULongLong(&idOk) : 0;
+        int exitCode = parts.size() == 2 ? parts[1].toInt(&codeOk) : -1;
+
+        QByteArray output = m_buffer.left(pos);
+        m_buffer.remove(0, lineEnd + 1);
+        if (!idOk) continue;
+
+        // PTY sessions merge stderr into stdout, its marker included
+        int errPos = output.lastIndexOf(errMarker);
+        if (errPos >= 0) {
+            output.truncate(errPos);
+            markError(id, QString());
+        }
+
+        Result result;
+        result.output = QString::fromUtf8(output);
+        result.exitCode = codeOk ? exitCode : -1;
+        result.ok = codeOk;
+        markOutput(id, result);
+    }
+    deliverCompleted();
+}
+
+void AdbShellSession::onReadyReadError()
+{
+    m_errBuffer += m_process->readAllStandardError();
+    m_errBuffer.replace('\r', QByteArray());
+
+    const QByteArray marker = QByteArray("\n") + ERR_MARKER;
+
+    for (;;) {
+        int pos = m_errBuffer.indexOf(marker);
+        if (pos < 0) break;
+        int lineEnd = m_errBuffer.indexOf('\n', pos + marker.size());
+        if (lineEnd < 0) break;
+
+        // "<id>__"
+        QByteArray tag = m_errBuffer.mid(pos + marker.size(), lineEnd - pos - marker.size());
+        bool idOk = false;
+        quint64 id = tag.left(tag.size() - 2).toULongLong(&idOk);
+        QString error = QString::fromUtf8(m_errBuffer.constData(), pos);
+        m_errBuffer.remove(0, lineEnd + 1);
+
+        if (idOk) {
+            markError(id, error);
+        }
+    }
+    deliverCompleted();
+}
+
+void AdbShellSession::markOutput(quint64 id, const Result& result)
+{
+    for (Pending& p : m_pending) {
+        if (p.id > id) break;
+        if (p.outDone) continue;
+        p.outDone = true;
+        if (p.id < id) {
+            // Older than this marker: its frame was lost, fail it
+            p.errDone = true;
+            continue;
+        }
+        p.result.output = result.output;
+        p.result.exitCode = result.exitCode;
+        p.result.ok = result.ok;
+    }
+}
+
+void AdbShellSession::markError(quint64 id, const QString& error)
+{
+    for (Pending& p : m_pending) {
+        if (p.id > id) break;
+        if (p.errDone) continue;
+        p.errDone = true;
+        if (p.id == id) {
+            p.result.error = error;
+        }
+    }
+}
+
+void AdbShellSession::deliverCompleted()
+{
+    // In order: a result waits until everything queued before it is delivered
+    while (!m_pending.empty() && m_pending.front().outDone && m_pending.front().errDone) {
+        Pending done = std::move(m_pending.front());
+        m_pending.pop_front();
+        if (done.sync) {
+            m_syncResults.insert(done.id, done.result);
+        } else if (done.callback) {
+            done.callback(done.result);  // May re-enter execute()
+        }
+    }
+    startHead();
+}
+
+void AdbShellSession::startHead()
+{
+    if (m_pending.empty()) {
+        m_watchdog->stop();
+        return;
+    }
+    // The shell runs one command at a time: the head's clock starts now
+    Pending& head = m_pending.front();
+    if (head.startedMs == 0) {
+        head.startedMs = QDateTime::currentMSecsSinceEpoch();
+        checkDeadlines();
+    }
+}
+
+int AdbShellSession::checkDeadlines()
+{
+    m_watchdog->stop();
+    if (m_pending.empty()) return -1;
+
+    Pending& head = m_pending.front();
+    if (head.timeoutMs <= 0 || head.startedMs == 0) return -1;
+
+    const qint64 elapsed = QDateTime::currentMSecsSinceEpoch() - head.startedMs;
+    if (!head.expired && elapsed >= head.timeoutMs) {
+        // Fail this command only; its marker is still consumed when it arrives
+        qWarning() << "[AdbShellSession] Command" << head.id << "timed out after" << elapsed << "ms";
+        head.expired = true;
+        Result timedOut;
+        timedOut.error = QStringLiteral("command timed out");
+        timedOut.timedOut = true;
+        if (head.sync) {
+            head.sync = false;
+            m_syncResults.insert(head.id, timedOut);
+        }
+        Callback callback = std::move(head.callback);
+        head.callback = nullptr;
+        if (callback) {
+            callback(timedOut);  // May re-enter; the head may have moved on
+        }
+        return checkDeadlines();
+    }
+
+    if (head.expired && elapsed >= head.timeoutMs + WEDGED_GRACE_MS) {
+        // Still running long after its deadline: nothing queued behind it can complete
+        restart(QStringLiteral("shell wedged on command %1").arg(head.id));
+        return -1;
+    }
+
+    const qint64 deadline = head.expired ? head.timeoutMs + WEDGED_GRACE_MS : head.timeoutMs;
+    const int wait = static_cast<int>(deadline - elapsed);
+    m_watchdog->start(wait);
+    return wait;
+}
+
+void AdbShellSession::onFinished(int exitCode, QProcess::ExitStatus status)
+{
+    m_errBuffer += m_process->readAllStandardError();
+    QString reason = QString::fromUtf8(m_errBuffer).trimmed();
+    m_errBuffer.clear();
+    if (reason.isEmpty()) {
+        reason = status == QProcess::CrashExit
+                     ? QStringLiteral("adb crashed")
+                     : QStringLiteral("shell exited with code %1").arg(exitCode);
+    }
+    if (!m_pending.empty()) {
+        qWarning() << "[AdbShellSession] Session lost:" << reason;
+    }
+    failAll(reason);
+    emit sessionLost(reason);
+}
+
+void AdbShellSession::failAll(const QString& reason)
+{
+    Result failed;
+    failed.error = reason;
+
+    m_watchdog->stop();
+    std::deque<Pending> pending;
+    pending.swap(m_pending);
+    for (Pending& p : pending) {
+        if (p.sync) {
+            m_syncResults.insert(p.id, failed);
+        } else if (p.callback) {
+            p.callback(failed);
+        }
+    }
+}
+
+void AdbShellSession::pump(int timeoutMs)
+{
+    // Blocking here starves the watchdog: wake up for the head's deadline
+    if (m_watchdog->isActive()) {
+        timeoutMs = std::min(timeoutMs, std::max(1, m_watchdog->remainingTime()));
+    }
+    // Once the head has its stdout, only its stderr marker can unblock us
+    const bool needError = !m_pending.empty() && m_pending.front().outDone;
+    m_process->setReadChannel(needError ? QProcess::StandardError : QProcess::StandardOutput);
+    m_process->waitForReadyRead(timeoutMs);
+    m_process->setReadChannel(QProcess::StandardOutput);
+}
+
+bool AdbShellSession::waitFor(quint64 id, int timeoutMs)
+{
+    if (QThread::currentThread() != thread()) return false;
+
+    // An expired command has had its callback already
+    auto queued = [&]() {
+        return std::any_of(m_pending.cbegin(), m_pending.cend(),
+                           [id](const Pending& p) { return p.id == id && !p.expired; });
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+    while (queued()) {
+        int remaining = timeoutMs - static_cast<int>(timer.elapsed());
+        if (remaining <= 0 || !isRunning()) break;
+        pump(remaining);
+        checkDeadlines();
+    }
+    return !queued();
+}
+
+bool AdbShellSession::waitForIds(const QList<quint64>& ids, int timeoutMs)
+{
+    auto allDone = [&]() {
+        for (quint64 id : ids) {
+            if (!m_syncResults.contains(id)) return false;
+        }
+        return true;
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!allDone()) {
+        int remaining = timeoutMs - static_cast<int>(timer.elapsed());
+        if (remaining <= 0 || !isRunning()) break;
+        pump(remaining);
+        checkDeadlines();
+    }
+
+    if (allDone()) return true;
+
+    // Still queued behind other commands: give up on ours without touching
+    // the session; the results are dropped when their markers arrive
+    Result timedOut;
+    timedOut.error = QStringLiteral("command timed out");
+    timedOut.timedOut = true;
+    for (Pending& p : m_pending) {
+        if (p.sync && ids.contains(p.id)) {
+            p.sync = false;
+            m_syncResults.insert(p.id, timedOut);
+        }
+    }
+    return false;
+}
+
+AdbShellSession::Result AdbShellSession::execute(const QString& command, int timeoutMs)
+{
+    if (QThread::currentThread() != thread()) {
+        Result result;
+        QMetaObject::invokeMethod(this, [&]() { result = execute(command, timeoutMs); },
+                                  Qt::BlockingQueuedConnection);
+        return result;
+    }
+
+    quint64 id = enqueue(command, nullptr, true, timeoutMs);
+    waitForIds({id}, timeoutMs);
+    return m_syncResults.take(id);
+}
+
+QList<AdbShellSession::Result> AdbShellSession::executeAll(const QStringList& commands, int timeoutMs)
+{
+    if (QThread::currentThread() != thread()) {
+        QList<Result> results;
+        QMetaObject::invokeMethod(this, [&]() { results = executeAll(commands, timeoutMs); },
+                                  Qt::BlockingQueuedConnection);
+        return results;
+    }
+
+    QList<quint64> ids;
+    ids.reserve(commands.size());
+    for (const QString& command : commands) {
+        ids.append(enqueue(command, nullptr, true, timeoutMs));
+    }
+    waitForIds(ids, timeoutMs);
+
+    QList<Result> results;
+    results.reserve(ids.size());
+    for (quint64 id : ids) {
+        results.append(m_syncResults.take(id));
+    }
+    return results;
+}
+
+} // namespace NeoZ
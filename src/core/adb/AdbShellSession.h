@@ -0,0 +1,143 @@
+#ifndef NEOZ_ADBSHELLSESSION_H
+#define NEOZ_ADBSHELLSESSION_H
+
+#include <QObject>
+#include <QProcess>
+#include <QTimer>
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <deque>
+#include <functional>
+
+namespace NeoZ {
+
+/**
+ * @brief Long-lived `adb shell` session that multiplexes many commands.
+ *
+ * Spawning `adb -s <id> shell <cmd>` per command costs tens of ms of
+ * fork/exec and adb-server handshake. This keeps one `sh` running on the
+ * device and writes each command to its stdin, framed as:
+ *
+ *   { <cmd>
+ *   } </dev/null; __neoz_rc=$?; printf '\n__NEOZ_ERR_<id>__\n' >&2;
+ *   printf '\n__NEOZ_END_<id>_%d__\n' $__neoz_rc
+ *
+ * The shell runs commands in order, so responses are matched FIFO and the
+ * id in the end marker is used as a consistency check. stderr is framed the
+ * same way on its own channel and a result completes once both markers are
+ * in; on PTY sessions (older adbd) stderr arrives merged into stdout, so
+ * Result::error stays empty and the text is part of Result::output. Commands may be
+ * pipelined (submit() does not wait), and synchronous callers only pump
+ * the session until their own marker arrives.
+ *
+ * A command's timeout counts from when it reaches the head of the queue,
+ * not from submit(), so waiting behind other clients' commands never
+ * expires it. An expired command fails alone (Result::timedOut) and stays
+ * queued until its marker arrives; only if it is still running
+ * WEDGED_GRACE_MS later is the shell considered wedged and restarted,
+ * failing everything in flight. If the shell dies, in-flight requests fail
+ * and the next submit() restarts the session, rate-limited by
+ * RECONNECT_BACKOFF_MS.
+ *
+ * Commands must be self-contained shell snippets: no heredocs or
+ * interactive programs. Lives on one thread; execute() from another thread
+ * is forwarded with a blocking queued call.
+ */
+class AdbShellSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Result {
+        QString output;      // stdout, without the framing newline
+        QString error;       // stderr, or why the session failed if !ok
+        int exitCode = -1;
+        bool ok = false;     // false if the session failed before the marker
+        bool timedOut = false;
+    };
+
+    using Callback = std::function<void(const Result&)>;
+
+    explicit AdbShellSession(QObject* parent = nullptr);
+    ~AdbShellSession();
+
+    void setAdbPath(const QString& path) { m_adbPath = path; }
+    void setDeviceId(const QString& deviceId);
+
+    // Starts the shell if needed (respects the reconnect backoff)
+    bool ensureRunning(int timeoutMs = 3000);
+    void stop();
+    bool isRunning() const;
+
+    // Queue a command; the callback runs on the session's thread.
+    // timeoutMs <= 0: no limit
+    quint64 submit(const QString& command, Callback callback = nullptr, int timeoutMs = 0);
+
+    // Blocking round trip
+    Result execute(const QString& command, int timeoutMs = 5000);
+
+    // Pipeline all commands, then wait for every result (in order)
+    QList<Result> executeAll(const QStringList& commands, int timeoutMs = 10000);
+
+    // Pump the session until a submit()ted command has been delivered
+    bool waitFor(quint64 id, int timeoutMs);
+
+    int pendingCount() const { return static_cast<int>(m_pending.size()); }
+    quint64 restartCount() const { return m_restarts; }
+
+signals:
+    void sessionStarted();
+    void sessionLost(const QString& reason);
+
+private slots:
+    void onReadyRead();
+    void onReadyReadError();
+    void onFinished(int exitCode, QProcess::ExitStatus status);
+
+private:
+    struct Pending {
+        quint64 id;
+        Callback callback;
+        bool sync;           // Result goes to m_syncResults instead of a callback
+        Result result;
+        bool outDone = false;   // stdout end marker seen
+        bool errDone = false;   // stderr marker seen (or merged into stdout)
+        int timeoutMs = 0;
+        qint64 startedMs = 0;   // When it reached the head of the queue
+        bool expired = false;   // Timed out and failed; waits for its marker
+    };
+
+    quint64 enqueue(const QString& command, Callback callback, bool sync, int timeoutMs);
+    void startHead();
+    int checkDeadlines();
+    void markOutput(quint64 id, const Result& result);
+    void markError(quint64 id, const QString& error);
+    void deliverCompleted();
+    void pump(int timeoutMs);
+    bool waitForIds(const QList<quint64>& ids, int timeoutMs);
+    void failAll(const QString& reason);
+    void restart(const QString& reason);
+
+    QString m_adbPath = "adb";
+    QString m_deviceId;
+    QProcess* m_process = nullptr;
+    QTimer* m_watchdog = nullptr;
+    QByteArray m_buffer;
+    QByteArray m_errBuffer;
+    std::deque<Pending> m_pending;
+    QHash<quint64, Result> m_syncResults;   // Completed results awaited by execute*()
+    quint64 m_nextId = 1;
+    quint64 m_restarts = 0;
+    qint64 m_lastStartMs = 0;
+
+    static constexpr int RECONNECT_BACKOFF_MS = 1000;
+    static constexpr int WEDGED_GRACE_MS = 5000;
+    static constexpr const char* END_MARKER = "__NEOZ_END_";
+    static constexpr const char* ERR_MARKER = "__NEOZ_ERR_";
+};
+
+} // namespace NeoZ
+
+#endif // NEOZ_ADBSHELLSESSION_H
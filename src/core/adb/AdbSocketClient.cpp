@@ -0,0 +1,689 @@
+#include "AdbSocketClient.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <memory>
+
+namespace NeoZ {
+
+namespace {
+
+using SocketPtr = std::unique_ptr<QTcpSocket>;
+
+int remainingMs(const QElapsedTimer& timer, int timeoutMs)
+{
+    return qMax(0, timeoutMs - static_cast<int>(timer.elapsed()));
+}
+
+// Block until `n` bytes are buffered, then take them
+bool readExact(QTcpSocket* socket, qint64 n, QByteArray& out,
+               const QElapsedTimer& timer, int timeoutMs)
+{
+    while (socket->bytesAvailable() < n) {
+        int remaining = remainingMs(timer, timeoutMs);
+        if (remaining == 0 || !socket->waitForReadyRead(remaining)) {
+            return false;
+        }
+    }
+    out = socket->read(n);
+    return true;
+}
+
+// Stream services end when the server closes the socket
+bool readToEnd(QTcpSocket* socket, QByteArray& out, const QElapsedTimer& timer, int timeoutMs)
+{
+    while (socket->state() == QAbstractSocket::ConnectedState) {
+        int remaining = remainingMs(timer, timeoutMs);
+        if (remaining == 0) return false;
+        socket->waitForReadyRead(remaining);
+        out += socket->readAll();
+    }
+    out += socket->readAll();
+    return true;
+}
+
+bool writeAll(QTcpSocket* socket, const QByteArray& data, const QElapsedTimer& timer, int timeoutMs)
+{
+    if (socket->write(data) != data.size()) return false;
+    while (socket->bytesToWrite() > 0) {
+        int remaining = remainingMs(timer, timeoutMs);
+        if (remaining == 0 || !socket->waitForBytesWritten(remaining)) return false;
+    }
+    return true;
+}
+
+// "OKAY", or "FAIL" + hex length + message
+bool readStatus(QTcpSocket* socket, AdbSocketClient::Reply& reply,
+                const QElapsedTimer& timer, int timeoutMs)
+{
+    QByteArray status;
+    if (!readExact(socket, 4, status, timer, timeoutMs)) {
+        reply.error = QStringLiteral("No response from adb server");
+        return false;
+    }
+    if (status == "OKAY") return true;
+
+    if (status == "FAIL") {
+        QByteArray lenHex;
+        QByteArray message;
+        if (readExact(socket, 4, lenHex, timer, timeoutMs)
+            && readExact(socket, lenHex.toInt(nullptr, 16), message, timer, timeoutMs)) {
+            reply.error = QString::fromUtf8(message);
+        } else {
+            reply.error = QStringLiteral("FAIL (truncated message)");
+        }
+        return false;
+    }
+
+    reply.error = QStringLiteral("Unexpected adb response: ") + QString::fromLatin1(status.toHex());
+    return false;
+}
+
+void putLE32(QByteArray& out, quint32 value)
+{
+    for (int i = 0; i < 4; ++i) {
+        out.append(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+quint32 getLE32(const char* p)
+{
+    const auto* u = reinterpret_cast<const uchar*>(p);
+    return quint32(u[0]) | quint32(u[1]) << 8 | quint32(u[2]) << 16 | quint32(u[3]) << 24;
+}
+
+QByteArray syncPacket(const char id[4], const QByteArray& payload)
+{
+    QByteArray packet(id, 4);
+    putLE32(packet, static_cast<quint32>(payload.size()));
+    packet += payload;
+    return packet;
+}
+
+} // namespace
+
+AdbSocketClient::AdbSocketClient(QObject* parent)
+    : QObject(parent)
+{
+    bool ok = false;
+    int envPort = qEnvironmentVariableIntValue("ANDROID_ADB_SERVER_PORT", &ok);
+    if (ok && envPort > 0 && envPort < 65536) {
+        m_port = static_cast<quint16>(envPort);
+    }
+}
+
+AdbSocketClient::~AdbSocketClient()
+{
+    // In-flight async requests die silently; their owners are going away too
+    for (QTcpSocket* socket : findChildren<QTcpSocket*>(Qt::FindDirectChildrenOnly)) {
+        QObject::disconnect(socket, nullptr, nullptr, nullptr);
+    }
+    qDeleteAll(m_idle);
+}
+
+void AdbSocketClient::setServer(const QString& host, quint16 port)
+{
+    if (m_host == host && m_port == port) return;
+    m_host = host;
+    m_port = port;
+    qDeleteAll(m_idle);
+    m_idle.clear();
+    m_serverCheckedMs.store(0, std::memory_order_release);
+}
+
+QByteArray AdbSocketClient::encodeRequest(const QByteArray& service)
+{
+    return QByteArray::number(service.size(), 16).rightJustified(4, '0') + service;
+}
+
+// ========== SOCKET POOL ==========
+
+QTcpSocket* AdbSocketClient::acquireSocket(int timeoutMs, QString* error)
+{
+    const bool ownerThread = QThread::currentThread() == thread();
+
+    QTcpSocket* socket = nullptr;
+    while (ownerThread && !m_idle.isEmpty()) {
+        QTcpSocket* candidate = m_idle.takeFirst();
+        if (candidate->state() == QAbstractSocket::ConnectedState
+            || (candidate->state() == QAbstractSocket::ConnectingState
+                && candidate->waitForConnected(timeoutMs))) {
+            candidate->setParent(nullptr);
+            socket = candidate;
+            break;
+        }
+        delete candidate;  // Server went away since it was pooled
+    }
+
+    if (!socket) {
+        socket = new QTcpSocket();
+        socket->connectToHost(m_host, m_port);
+        if (!socket->waitForConnected(timeoutMs)) {
+            if (error) *error = QStringLiteral("adb server unreachable: ") + socket->errorString();
+            delete socket;
+            noteServer(false);
+            return nullptr;
+        }
+    }
+
+    if (ownerThread) {
+        QMetaObject::invokeMethod(this, &AdbSocketClient::refillPool, Qt::QueuedConnection);
+    }
+    return socket;
+}
+
+void AdbSocketClient::refillPool()
+{
+    m_idle.removeIf([](QTcpSocket* s) {
+        if (s->state() != QAbstractSocket::UnconnectedState) return false;
+        s->deleteLater();
+        return true;
+    });
+    while (m_idle.size() < POOL_SIZE) {
+        auto* socket = new QTcpSocket(this);
+        socket->connectToHost(m_host, m_port);   // Completes in the background
+        m_idle.append(socket);
+    }
+}
+
+// ========== HOST SERVICES ==========
+
+AdbSocketClient::Reply AdbSocketClient::query(const QString& service, int timeoutMs)
+{
+    Reply reply;
+    QElapsedTimer timer;
+    timer.start();
+
+    SocketPtr socket(acquireSocket(timeoutMs, &reply.error));
+    if (!socket) return reply;
+
+    if (!writeAll(socket.get(), encodeRequest(service.toUtf8()), timer, timeoutMs)) {
+        reply.error = QStringLiteral("Write to adb server failed");
+        return reply;
+    }
+    if (!readStatus(socket.get(), reply, timer, timeoutMs)) {
+        return reply;
+    }
+
+    QByteArray lenHex;
+    if (!readExact(socket.get(), 4, lenHex, timer, timeoutMs)
+        || !readExact(socket.get(), lenHex.toInt(nullptr, 16), reply.data, timer, timeoutMs)) {
+        reply.error = QStringLiteral("Truncated reply to ") + service;
+        return reply;
+    }
+    reply.ok = true;
+    noteServer(true);
+    return reply;
+}
+
+bool AdbSocketClient::isServerAvailable(int timeoutMs)
+{
+    // Callers ask before every command; a dead server would cost them the full timeout each time
+    const qint64 checked = m_serverCheckedMs.load(std::memory_order_acquire);
+    if (checked != 0 && QDateTime::currentMSecsSinceEpoch() - checked < SERVER_CHECK_TTL_MS) {
+        return m_serverAvailable.load(std::memory_order_relaxed);
+    }
+    const bool available = serverVersion(timeoutMs) > 0;
+    noteServer(available);
+    return available;
+}
+
+void AdbSocketClient::noteServer(bool available)
+{
+    m_serverAvailable.store(available, std::memory_order_relaxed);
+    m_serverCheckedMs.store(QDateTime::currentMSecsSinceEpoch(), std::memory_order_release);
+}
+
+int AdbSocketClient::serverVersion(int timeoutMs)
+{
+    Reply reply = query(QStringLiteral("host:version"), timeoutMs);
+    return reply.ok ? reply.data.toInt(nullptr, 16) : -1;
+}
+
+QList<AdbSocketClient::Device> AdbSocketClient::devices(int timeoutMs, bool* ok)
+{
+    Reply reply = query(QStringLiteral("host:devices-l"), timeoutMs);
+    if (ok) *ok = reply.ok;
+    return reply.ok ? parseDevices(reply.data) : QList<Device>();
+}
+
+QList<AdbSocketClient::Device> AdbSocketClient::parseDevices(const QByteArray& listing)
+{
+    // "<serial>\t<state>" or, long form, "<serial>  <state> usb:x product:y model:z device:w transport_id:n".
+    // The state may itself contain spaces ("no permissions (...); see [...]"),
+    // so it runs up to the first key:value field.
+    static const QRegularExpression fieldRx("^(usb|product|model|device|transport_id|features):");
+
+    QList<Device> devices;
+    for (const QByteArray& rawLine : listing.split('\n')) {
+        const QString line = QString::fromUtf8(rawLine).trimmed();
+        if (line.isEmpty()) continue;
+
+        const QStringList parts = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+        if (parts.size() < 2) continue;
+
+        Device device;
+        device.serial = parts[0];
+        int i = 1;
+        QStringList state;
+        while (i < parts.size() && !fieldRx.match(parts[i]).hasMatch()) {
+            state << parts[i++];
+        }
+        device.state = state.join(' ');
+        for (; i < parts.size(); ++i) {
+            const QString& field = parts[i];
+            if (field.startsWith("model:")) device.model = field.mid(6);
+            else if (field.startsWith("product:")) device.product = field.mid(8);
+            else if (field.startsWith("transport_id:")) device.transportId = field.mid(13);
+        }
+        if (!device.state.isEmpty()) {
+            devices.append(device);
+        }
+    }
+    return devices;
+}
+
+// ========== DEVICE SERVICES ==========
+
+AdbSocketClient::Reply AdbSocketClient::openDeviceService(QTcpSocket* socket, const QString& serial,
+                                                          const QByteArray& service, int timeoutMs)
+{
+    Reply reply;
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!writeAll(socket, encodeRequest("host:transport:" + serial.toUtf8()), timer, timeoutMs)
+        || !readStatus(socket, reply, timer, timeoutMs)) {
+        if (reply.error.isEmpty()) reply.error = QStringLiteral("Transport request failed");
+        return reply;
+    }
+    if (!writeAll(socket, encodeRequest(service), timer, timeoutMs)
+        || !readStatus(socket, reply, timer, timeoutMs)) {
+        if (reply.error.isEmpty()) reply.error = QStringLiteral("Service request failed");
+        return reply;
+    }
+    reply.ok = true;
+    return reply;
+}
+
+AdbSocketClient::Reply AdbSocketClient::runStreamService(const QString& serial,
+                                                         const QByteArray& service, int timeoutMs)
+{
+    Reply reply;
+    QElapsedTimer timer;
+    timer.start();
+
+    SocketPtr socket(acquireSocket(timeoutMs, &reply.error));
+    if (!socket) return reply;
+
+    reply = openDeviceService(socket.get(), serial, service, timeoutMs);
+    if (!reply.ok) return reply;
+
+    if (!readToEnd(socket.get(), reply.data, timer, timeoutMs)) {
+        reply.ok = false;
+        reply.error = QStringLiteral("Timed out reading ") + QString::fromUtf8(service);
+    }
+    return reply;
+}
+
+AdbSocketClient::Reply AdbSocketClient::shell(const QString& serial, const QString& command, int timeoutMs)
+{
+    return runStreamService(serial, "shell:" + command.toUtf8(), timeoutMs);
+}
+
+AdbSocketClient::Reply AdbSocketClient::exec(const QString& serial, const QString& command, int timeoutMs)
+{
+    return runStreamService(serial, "exec:" + command.toUtf8(), timeoutMs);
+}
+
+QTcpSocket* AdbSocketClient::openExecStream(const QString& serial, const QString& command,
+                                            int timeoutMs, QString* error)
+{
+    QString connectError;
+    SocketPtr socket(acquireSocket(timeoutMs, &connectError));
+    if (!socket) {
+        if (error) *error = connectError;
+        return nullptr;
+    }
+
+    Reply reply = openDeviceService(socket.get(), serial, "exec:" + command.toUtf8(), timeoutMs);
+    if (!reply.ok) {
+        if (error) *error = reply.error;
+        return nullptr;
+    }
+    return socket.release();
+}
+
+void AdbSocketClient::shellAsync(const QString& serial, const QString& command,
+                                 ReplyCallback callback, int timeoutMs)
+{
+    startAsync(serial, "shell:" + command.toUtf8(), std::move(callback), timeoutMs);
+}
+
+void AdbSocketClient::execAsync(const QString& serial, const QString& command,
+                                ReplyCallback callback, int timeoutMs)
+{
+    startAsync(serial, "exec:" + command.toUtf8(), std::move(callback), timeoutMs);
+}
+
+void AdbSocketClient::startAsync(const QString& serial, const QByteArray& service,
+                                 ReplyCallback callback, int timeoutMs)
+{
+    // Take a pooled socket without blocking; otherwise connect in the background
+    QTcpSocket* socket = nullptr;
+    while (!m_idle.isEmpty() && !socket) {
+        QTcpSocket* candidate = m_idle.takeFirst();
+        if (candidate->state() == QAbstractSocket::UnconnectedState) {
+            candidate->deleteLater();
+            continue;
+        }
+        socket = candidate;
+    }
+    if (!socket) {
+        socket = new QTcpSocket(this);
+        socket->connectToHost(m_host, m_port);
+    }
+    QMetaObject::invokeMethod(this, &AdbSocketClient::refillPool, Qt::QueuedConnection);
+
+    enum Phase { Transport, Service, Stream, Done };
+    struct AsyncOp {
+        QTcpSocket* socket;
+        QTimer timer;
+        QByteArray buffer;
+        Phase phase = Transport;
+        ReplyCallback callback;
+    };
+    auto op = std::make_shared<AsyncOp>();
+    op->socket = socket;
+    op->callback = std::move(callback);
+
+    auto finish = [op](Reply reply) {
+        if (op->phase == Done) return;
+        op->phase = Done;
+        op->timer.stop();
+        // Drop every connection so the lambdas release `op`
+        QObject::disconnect(&op->timer, nullptr, nullptr, nullptr);
+        QObject::disconnect(op->socket, nullptr, nullptr, nullptr);
+        op->socket->abort();
+        op->socket->deleteLater();
+        if (op->callback) op->callback(reply);
+    };
+
+    auto sendTransport = [op, serial]() {
+        op->socket->write(encodeRequest("host:transport:" + serial.toUtf8()));
+    };
+
+    QObject::connect(op->socket, &QTcpSocket::readyRead, this, [op, service, finish]() {
+        op->buffer += op->socket->readAll();
+        while (op->phase == Transport || op->phase == Service) {
+            if (op->buffer.size() < 4) return;
+            if (op->buffer.startsWith("OKAY")) {
+                op->buffer.remove(0, 4);
+                if (op->phase == Transport) {
+                    op->phase = Service;
+                    op->socket->write(encodeRequest(service));
+                } else {
+                    op->phase = Stream;
+                }
+                continue;
+            }
+            Reply reply;
+            if (op->buffer.startsWith("FAIL")) {
+                if (op->buffer.size() < 8) return;
+                int len = op->buffer.mid(4, 4).toInt(nullptr, 16);
+                if (op->buffer.size() < 8 + len) return;
+                reply.error = QString::fromUtf8(op->buffer.mid(8, len));
+            } else {
+                reply.error = QStringLiteral("Unexpected adb response");
+            }
+            finish(reply);
+            return;
+        }
+    });
+
+    QObject::connect(op->socket, &QTcpSocket::disconnected, this, [op, finish]() {
+        Reply reply;
+        op->buffer += op->socket->readAll();
+        if (op->phase == Stream) {
+            reply.ok = true;
+            reply.data = op->buffer;
+        } else {
+            reply.error = QStringLiteral("adb server closed the connection");
+        }
+        finish(reply);
+    });
+
+    QObject::connect(op->socket, &QTcpSocket::errorOccurred, this,
+                     [op, finish](QAbstractSocket::SocketError error) {
+        if (error == QAbstractSocket::RemoteHostClosedError) return;  // disconnected() handles it
+        Reply reply;
+        reply.error = op->socket->errorString();
+        finish(reply);
+    });
+
+    op->timer.setSingleShot(true);
+    QObject::connect(&op->timer, &QTimer::timeout, this, [finish]() {
+        Reply reply;
+        reply.error = QStringLiteral("Timed out");
+        finish(reply);
+    });
+    op->timer.start(timeoutMs);
+
+    if (socket->state() == QAbstractSocket::ConnectedState) {
+        sendTransport();
+    } else {
+        QObject::connect(op->socket, &QTcpSocket::connected, this, sendTransport);
+    }
+}
+
+// ========== SYNC SERVICE ==========
+
+AdbSocketClient::FileStat AdbSocketClient::stat(const QString& serial, const QString& remotePath, int timeoutMs)
+{
+    FileStat result;
+    QElapsedTimer timer;
+    timer.start();
+
+    QString error;
+    SocketPtr socket(acquireSocket(timeoutMs, &error));
+    if (!socket || !openDeviceService(socket.get(), serial, "sync:", timeoutMs).ok) {
+        return result;
+    }
+
+    QByteArray response;
+    if (!writeAll(socket.get(), syncPacket("STAT", remotePath.toUtf8()), timer, timeoutMs)
+        || !readExact(socket.get(), 16, response, timer, timeoutMs)
+        || !response.startsWith("STAT")) {
+        return result;
+    }
+
+    result.ok = true;
+    result.mode = getLE32(response.constData() + 4);
+    result.size = getLE32(response.constData() + 8);
+    result.mtime = getLE32(response.constData() + 12);
+    writeAll(socket.get(), syncPacket("QUIT", QByteArray()), timer, timeoutMs);
+    return result;
+}
+
+AdbSocketClient::Reply AdbSocketClient::pull(const QString& serial, const QString& remotePath, int timeoutMs)
+{
+    Reply reply;
+    QElapsedTimer timer;
+    timer.start();
+
+    SocketPtr socket(acquireSocket(timeoutMs, &reply.error));
+    if (!socket) return reply;
+    reply = openDeviceService(socket.get(), serial, "sync:", timeoutMs);
+    if (!reply.ok) return reply;
+    reply.ok = false;
+
+    if (!writeAll(socket.get(), syncPacket("RECV", remotePath.toUtf8()), timer, timeoutMs)) {
+        reply.error = QStringLiteral("Write failed");
+        return reply;
+    }
+
+    while (true) {
+        QByteArray header;
+        if (!readExact(socket.get(), 8, header, timer, timeoutMs)) {
+            reply.error = QStringLiteral("Timed out pulling ") + remotePath;
+            return reply;
+        }
+        const quint32 len = getLE32(header.constData() + 4);
+        if (header.startsWith("DONE")) break;
+        if (len > static_cast<quint32>(SYNC_CHUNK)) {
+            // Corrupt stream: never size a read from it
+            socket->abort();
+            reply.error = QStringLiteral("Oversized sync packet (%1 bytes)").arg(len);
+            return reply;
+        }
+
+        QByteArray payload;
+        if (!readExact(socket.get(), len, payload, timer, timeoutMs)) {
+            reply.error = QStringLiteral("Truncated DATA packet");
+            return reply;
+        }
+        if (header.startsWith("FAIL")) {
+            reply.error = QString::fromUtf8(payload);
+            return reply;
+        }
+        if (!header.startsWith("DATA")) {
+            reply.error = QStringLiteral("Unexpected sync packet");
+            return reply;
+        }
+        reply.data += payload;
+    }
+
+    reply.ok = true;
+    writeAll(socket.get(), syncPacket("QUIT", QByteArray()), timer, timeoutMs);
+    return reply;
+}
+
+AdbSocketClient::Reply AdbSocketClient::push(const QString& serial, const QByteArray& data,
+                                             const QString& remotePath, quint32 mode,
+                                             quint32 mtime, int timeoutMs)
+{
+    Reply reply;
+    QElapsedTimer timer;
+    timer.start();
+
+    SocketPtr socket(acquireSocket(timeoutMs, &reply.error));
+    if (!socket) return reply;
+    reply = openDeviceService(socket.get(), serial, "sync:", timeoutMs);
+    if (!reply.ok) return reply;
+
+    reply = sendFile(socket.get(), data, remotePath, mode, mtime, remainingMs(timer, timeoutMs));
+    writeAll(socket.get(), syncPacket("QUIT", QByteArray()), timer, timeoutMs);
+    return reply;
+}
+
+AdbSocketClient::Reply AdbSocketClient::pushCached(const QString& serial, const QByteArray& data,
+                                                   const QString& remotePath, quint32 mode,
+                                                   bool* uploaded, int timeoutMs)
+{
+    if (uploaded) *uploaded = false;
+
+    Reply reply;
+    QElapsedTimer timer;
+    timer.start();
+
+    const QString key = serial + ':' + remotePath;
+    const QByteArray sha256 = QCryptographicHash::hash(data, QCryptographicHash::Sha256);
+    PushedFile known;
+    {
+        QMutexLocker locker(&m_pushedMutex);
+        known = m_pushed.value(key);
+    }
+
+    SocketPtr socket(acquireSocket(timeoutMs, &reply.error));
+    if (!socket) return reply;
+    reply = openDeviceService(socket.get(), serial, "sync:", timeoutMs);
+    if (!reply.ok) return reply;
+
+    if (known.sha256 == sha256 && known.mode == mode) {
+        // Same content and mode as last time: trust it if the device copy is untouched
+        QByteArray response;
+        if (writeAll(socket.get(), syncPacket("STAT", remotePath.toUtf8()), timer, timeoutMs)
+            && readExact(socket.get(), 16, response, timer, timeoutMs)
+            && response.startsWith("STAT")
+            && getLE32(response.constData() + 4) != 0
+            && getLE32(response.constData() + 8) == known.size
+            && getLE32(response.constData() + 12) == known.mtime) {
+            writeAll(socket.get(), syncPacket("QUIT", QByteArray()), timer, timeoutMs);
+            return reply;
+        }
+    }
+
+    const quint32 mtime = static_cast<quint32>(QDateTime::currentSecsSinceEpoch());
+    reply = sendFile(socket.get(), data, remotePath, mode, mtime, remainingMs(timer, timeoutMs));
+    writeAll(socket.get(), syncPacket("QUIT", QByteArray()), timer, timeoutMs);
+
+    QMutexLocker locker(&m_pushedMutex);
+    if (reply.ok) {
+        m_pushed.insert(key, {sha256, mode, static_cast<quint32>(data.size()), mtime});
+        if (uploaded) *uploaded = true;
+    } else {
+        m_pushed.remove(key);
+    }
+    return reply;
+}
+
+void AdbSocketClient::forgetPushed(const QString& serial)
+{
+    QMutexLocker locker(&m_pushedMutex);
+    if (serial.isEmpty()) {
+        m_pushed.clear();
+        return;
+    }
+    const QString prefix = serial + ':';
+    for (auto it = m_pushed.begin(); it != m_pushed.end();) {
+        it = it.key().startsWith(prefix) ? m_pushed.erase(it) : std::next(it);
+    }
+}
+
+AdbSocketClient::Reply AdbSocketClient::sendFile(QTcpSocket* socket, const QByteArray& data,
+                                                 const QString& remotePath, quint32 mode,
+                                                 quint32 mtime, int timeoutMs)
+{
+    Reply reply;
+    QElapsedTimer timer;
+    timer.start();
+
+    // SEND "<path>,<mode>" then DATA chunks then DONE(mtime)
+    QByteArray request = syncPacket("SEND", remotePath.toUtf8() + ',' + QByteArray::number(mode | 0100000));
+    for (qsizetype off = 0; off < data.size(); off += SYNC_CHUNK) {
+        request += syncPacket("DATA", data.mid(off, SYNC_CHUNK));
+    }
+    if (mtime == 0) {
+        mtime = static_cast<quint32>(QDateTime::currentSecsSinceEpoch());
+    }
+    request += QByteArray("DONE", 4);
+    putLE32(request, mtime);
+
+    if (!writeAll(socket, request, timer, timeoutMs)) {
+        reply.error = QStringLiteral("Write failed");
+        return reply;
+    }
+
+    QByteArray status;
+    if (!readExact(socket, 8, status, timer, timeoutMs)) {
+        reply.error = QStringLiteral("Timed out pushing ") + remotePath;
+        return reply;
+    }
+    if (status.startsWith("FAIL")) {
+        QByteArray message;
+        readExact(socket, getLE32(status.constData() + 4), message, timer, timeoutMs);
+        reply.error = QString::fromUtf8(message);
+        return reply;
+    }
+
+    reply.ok = status.startsWith("OKAY");
+    if (!reply.ok) reply.error = QStringLiteral("Unexpected sync response");
+    return reply;
+}
+
+} // namespace NeoZ
@@ -0,0 +1,159 @@
+#ifndef NEOZ_ADBSOCKETCLIENT_H
+#define NEOZ_ADBSOCKETCLIENT_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <functional>
+
+class QTcpSocket;
+
+namespace NeoZ {
+
+/**
+ * @brief Native client for the adb server's smart-socket protocol.
+ *
+ * Talks to the adb server (localhost:5037, or ANDROID_ADB_SERVER_PORT)
+ * directly instead of spawning adb.exe per command:
+ *
+ *   request  = 4 hex digits length + service string   ("000chost:version")
+ *   response = "OKAY" | "FAIL" + 4 hex length + message
+ *
+ * Device services first bind the socket with host:transport:<serial>, then
+ * open shell:<cmd> / exec:<cmd> (stream until close) or sync: (file
+ * transfer packets: 4-byte id + little-endian uint32 length + payload).
+ *
+ * The server closes a socket once a device service ends, so sockets are
+ * not reused across commands. Instead the client keeps a few pre-connected
+ * idle sockets so a command never waits on the TCP handshake.
+ *
+ * Blocking calls use the owner thread's pool; calls from other threads
+ * open a private socket. Async calls must come from the owner thread.
+ *
+ * pushCached() remembers the SHA-256 of what it pushed to each device path
+ * and skips the upload when the same content is pushed again with the same
+ * mode and the file on the device still has the size and mtime it was given.
+ */
+class AdbSocketClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr quint16 DEFAULT_PORT = 5037;
+
+    struct Reply {
+        bool ok = false;
+        QByteArray data;     // Service payload or stream contents
+        QString error;       // FAIL message or socket error
+    };
+
+    struct Device {
+        QString serial;
+        QString state;       // "device", "offline", "unauthorized", "no permissions (...)", ...
+        QString model;       // Long listing only, '_' kept as sent
+        QString product;
+        QString transportId;
+    };
+
+    struct FileStat {
+        bool ok = false;
+        quint32 mode = 0;    // 0 if the path does not exist
+        quint32 size = 0;
+        quint32 mtime = 0;
+    };
+
+    using ReplyCallback = std::function<void(const Reply&)>;
+
+    explicit AdbSocketClient(QObject* parent = nullptr);
+    ~AdbSocketClient();
+
+    void setServer(const QString& host, quint16 port);
+    QString host() const { return m_host; }
+    quint16 port() const { return m_port; }
+
+    // ========== HOST SERVICES ==========
+
+    // host:* request with a length-prefixed reply (host:version, host:devices, ...)
+    Reply query(const QString& service, int timeoutMs = 2000);
+
+    // True if an adb server answers host:version. Cached for
+    // SERVER_CHECK_TTL_MS, refreshed by every connection attempt
+    bool isServerAvailable(int timeoutMs = 500);
+    int serverVersion(int timeoutMs = 1000);
+
+    // host:devices-l; *ok is false if the server could not be asked
+    QList<Device> devices(int timeoutMs = 2000, bool* ok = nullptr);
+
+    // Parse a host:devices(-l) / `adb devices -l` listing
+    static QList<Device> parseDevices(const QByteArray& listing);
+
+    // ========== DEVICE SERVICES (blocking) ==========
+
+    Reply shell(const QString& serial, const QString& command, int timeoutMs = 5000);
+    Reply exec(const QString& serial, const QString& command, int timeoutMs = 5000);
+
+    // ========== DEVICE SERVICES (async, owner thread) ==========
+
+    void shellAsync(const QString& serial, const QString& command,
+                    ReplyCallback callback, int timeoutMs = 5000);
+    void execAsync(const QString& serial, const QString& command,
+                   ReplyCallback callback, int timeoutMs = 5000);
+
+    // Open exec:<cmd> and hand back the socket positioned at the start of
+    // the stream (caller owns it). For long-running producers like screenrecord.
+    QTcpSocket* openExecStream(const QString& serial, const QString& command,
+                               int timeoutMs = 3000, QString* error = nullptr);
+
+    // ========== SYNC SERVICE ==========
+
+    FileStat stat(const QString& serial, const QString& remotePath, int timeoutMs = 3000);
+    Reply pull(const QString& serial, const QString& remotePath, int timeoutMs = 30000);
+    Reply push(const QString& serial, const QByteArray& data, const QString& remotePath,
+               quint32 mode = 0644, quint32 mtime = 0, int timeoutMs = 30000);
+
+    // Push unless this exact content and mode are already there (STAT + SEND on one sync socket)
+    Reply pushCached(const QString& serial, const QByteArray& data, const QString& remotePath,
+                     quint32 mode = 0644, bool* uploaded = nullptr, int timeoutMs = 30000);
+    void forgetPushed(const QString& serial = QString());
+
+    static QByteArray encodeRequest(const QByteArray& service);
+
+private:
+    QTcpSocket* acquireSocket(int timeoutMs, QString* error);
+    void noteServer(bool available);
+    void refillPool();
+    Reply openDeviceService(QTcpSocket* socket, const QString& serial,
+                            const QByteArray& service, int timeoutMs);
+    Reply runStreamService(const QString& serial, const QByteArray& service, int timeoutMs);
+    void startAsync(const QString& serial, const QByteArray& service,
+                    ReplyCallback callback, int timeoutMs);
+    Reply sendFile(QTcpSocket* socket, const QByteArray& data, const QString& remotePath,
+                   quint32 mode, quint32 mtime, int timeoutMs);
+
+    struct PushedFile {
+        QByteArray sha256;
+        quint32 mode = 0;
+        quint32 size = 0;
+        quint32 mtime = 0;
+    };
+
+    QString m_host = "127.0.0.1";
+    quint16 m_port = DEFAULT_PORT;
+    QList<QTcpSocket*> m_idle;
+    std::atomic<bool> m_serverAvailable{false};
+    std::atomic<qint64> m_serverCheckedMs{0};   // 0 = never checked
+    QHash<QString, PushedFile> m_pushed;   // "<serial>:<path>" -> last upload
+    QMutex m_pushedMutex;
+
+    static constexpr int POOL_SIZE = 3;
+    static constexpr int SERVER_CHECK_TTL_MS = 2000;
+    static constexpr int SYNC_CHUNK = 64 * 1024;   // Max DATA payload per packet
+};
+
+} // namespace NeoZ
+
+#endif // NEOZ_ADBSOCKETCLIENT_H
@@ -1,19 +1,46 @@
 #include "CrosshairDetector.h"
 #include <QDebug>
 #include <QBuffer>
-#include <QColor>
+#include <algorithm>
+#include <chrono>
 
 namespace NeoZ {
 
+namespace {
+
+inline qint64 steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
 CrosshairDetector::CrosshairDetector(QObject* parent)
     : QObject(parent)
 {
     m_samplingTimer = new QTimer(this);
     connect(m_samplingTimer, &QTimer::timeout, this, &CrosshairDetector::performSample);
     
-    m_screencapProcess = std::make_unique<QProcess>(this);
-    connect(m_screencapProcess.get(), QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, &CrosshairDetector::onScreencapFinished);
+    m_adbClient = std::make_unique<AdbSocketClient>(this);
+    
+    m_stream = std::make_unique<CrosshairStream>(this);
+    m_stream->setCropSize(m_classifier.extent());
+    connect(m_stream.get(), &CrosshairStream::cropReady, this, &CrosshairDetector::onStreamCrop);
+    connect(m_stream.get(), &CrosshairStream::streamEnded, this, &CrosshairDetector::onStreamEnded);
+    connect(m_stream.get(), &CrosshairStream::streamError, this, &CrosshairDetector::onStreamFailed);
+    
+    m_streamRetryTimer = new QTimer(this);
+    m_streamRetryTimer->setSingleShot(true);
+    connect(m_streamRetryTimer, &QTimer::timeout, this, [this]() {
+        if (!m_videoStreamEnabled) return;
+        if (startVideoStream()) {
+            m_samplingTimer->stop();
+            qDebug() << "[CrosshairDetector] Video stream reopened";
+        } else {
+            retryVideoStream(QStringLiteral("cannot open stream"));
+        }
+    });
     
     qDebug() << "[CrosshairDetector] Initialized - sampling at" << m_samplingIntervalMs << "ms";
 }
@@ -39,18 +66,28 @@ void CrosshairDetector::setEnabled(bool enabled)
 
 void CrosshairDetector::setSamplingIntervalMs(int ms)
 {
-    ms = qBound(30, ms, 200);  // 30-200ms range
+    ms = qBound(MIN_INTERVAL_MS, ms, 200);  // 16-200ms range (below 30ms needs raw capture)
     if (m_samplingIntervalMs == ms) return;
     m_samplingIntervalMs = ms;
-    
-    if (m_samplingTimer->isActive()) {
-        m_samplingTimer->setInterval(ms);
-    }
+    applySamplingInterval();
     
     qDebug() << "[CrosshairDetector] Sampling interval:" << ms << "ms";
     emit settingsChanged();
 }
 
+int CrosshairDetector::effectiveSamplingIntervalMs() const
+{
+    const bool raw = m_rawCaptureEnabled && !m_rawUnsupported;
+    return raw ? m_samplingIntervalMs : qMax(m_samplingIntervalMs, PNG_MIN_INTERVAL_MS);
+}
+
+void CrosshairDetector::applySamplingInterval()
+{
+    if (m_samplingTimer->isActive()) {
+        m_samplingTimer->setInterval(effectiveSamplingIntervalMs());
+    }
+}
+
 void CrosshairDetector::setYReductionAlpha(double alpha)
 {
     alpha = qBound(0.05, alpha, 0.5);  // 5-50% reduction
@@ -61,6 +98,60 @@ void CrosshairDetector::setYReductionAlpha(double alpha)
     emit settingsChanged();
 }
 
+void CrosshairDetector::setRawCaptureEnabled(bool enabled)
+{
+    if (m_rawCaptureEnabled == enabled) return;
+    m_rawCaptureEnabled = enabled;
+    applySamplingInterval();
+    
+    qDebug() << "[CrosshairDetector] Raw capture:" << (enabled ? "ON" : "OFF (PNG)");
+    emit settingsChanged();
+}
+
+void CrosshairDetector::setVideoStreamEnabled(bool enabled)
+{
+    if (m_videoStreamEnabled == enabled) return;
+    m_videoStreamEnabled = enabled;
+    
+    // Switch backends on the fly if detection is running
+    if (m_samplingTimer->isActive() || m_stream->isRunning()) {
+        stopDetection();
+        startDetection();
+    }
+    
+    qDebug() << "[CrosshairDetector] Video stream:" << (enabled ? "ON" : "OFF (polling)");
+    emit settingsChanged();
+}
+
+void CrosshairDetector::setReticleStyle(const QString& style)
+{
+    applyRoi(ReticleClassifier::styleFromName(style), m_classifier.radius(), m_classifier.thickness());
+}
+
+void CrosshairDetector::setRoiRadius(int radius)
+{
+    applyRoi(m_classifier.style(), qBound(0, radius, 64), m_classifier.thickness());
+}
+
+void CrosshairDetector::setRoiThickness(int thickness)
+{
+    applyRoi(m_classifier.style(), m_classifier.radius(), thickness);
+}
+
+void CrosshairDetector::applyRoi(ReticleClassifier::Style style, int radius, int thickness)
+{
+    if (style == m_classifier.style() && radius == m_classifier.radius()
+        && thickness == m_classifier.thickness()) {
+        return;
+    }
+    m_classifier.setShape(style, radius, thickness);
+    m_stream->setCropSize(m_classifier.extent());
+    
+    qDebug() << "[CrosshairDetector] ROI:" << reticleStyle() << "r=" << m_classifier.radius()
+             << "|" << m_classifier.maskPixels() << "px";
+    emit settingsChanged();
+}
+
 void CrosshairDetector::setAdbPath(const QString& path)
 {
     m_adbPath = path;
@@ -69,6 +160,9 @@ void CrosshairDetector::setAdbPath(const QString& path)
 void CrosshairDetector::setDeviceId(const QString& deviceId)
 {
     m_deviceId = deviceId;
+    m_rawLayout = RawLayout();
+    m_rawUnsupported = false;
+    applySamplingInterval();
     qDebug() << "[CrosshairDetector] Device set:" << deviceId;
 }
 
@@ -80,13 +174,22 @@ void CrosshairDetector::startDetection()
         return;
     }
     
-    m_samplingTimer->start(m_samplingIntervalMs);
+    if (m_videoStreamEnabled && startVideoStream()) {
+        qDebug() << "[CrosshairDetector] Detection STARTED (video stream)";
+        return;
+    }
+    
+    m_samplingTimer->start(effectiveSamplingIntervalMs());
     qDebug() << "[CrosshairDetector] Detection STARTED";
 }
 
 void CrosshairDetector::stopDetection()
 {
     m_samplingTimer->stop();
+    m_streamRetryTimer->stop();
+    m_streamFailures = 0;
+    m_streamFromDevice = false;
+    m_stream->stop();
     
     if (m_aimAssistActive) {
         m_aimAssistActive = false;
@@ -96,6 +199,123 @@ void CrosshairDetector::stopDetection()
     qDebug() << "[CrosshairDetector] Detection STOPPED";
 }
 
+bool CrosshairDetector::startStreamFromFile(const QString& path)
+{
+    stopDetection();
+    m_streamFromDevice = false;
+    m_streamStartNs = steadyNowNs();
+    m_streamFirstFrameUs = -1;
+    m_metricsWindowStartNs = m_streamStartNs;
+    m_metricsWindowFrames = 0;
+    m_classifyLatencyCount = 0;
+    return m_stream->startFile(path);
+}
+
+bool CrosshairDetector::startVideoStream()
+{
+    m_streamFromDevice = false;   // Open failures are reported by our return value
+    m_streamStartNs = steadyNowNs();
+    m_streamOpenedNs = m_streamStartNs;
+    m_streamFirstFrameUs = -1;
+    m_metricsWindowStartNs = m_streamStartNs;
+    m_metricsWindowFrames = 0;
+    m_classifyLatencyCount = 0;
+    
+    m_streamFromDevice = m_stream->startDevice(m_adbClient.get(), m_deviceId);
+    if (!m_streamFromDevice) {
+        qWarning() << "[CrosshairDetector] Video stream unavailable - falling back to polling";
+    }
+    return m_streamFromDevice;
+}
+
+void CrosshairDetector::onStreamEnded()
+{
+    if (!m_streamFromDevice || !m_videoStreamEnabled) return;
+    
+    // screenrecord stops at its time limit; reopen while detection is on.
+    // Ending much sooner means the device can't keep the stream up.
+    const qint64 uptimeMs = (steadyNowNs() - m_streamOpenedNs) / 1'000'000;
+    if (uptimeMs < MIN_STREAM_UPTIME_MS) {
+        onStreamFailed(QStringLiteral("stream ended after %1 ms").arg(uptimeMs));
+        return;
+    }
+    
+    qDebug() << "[CrosshairDetector] Video stream ended - restarting";
+    m_streamFailures = 0;
+    if (!startVideoStream()) {
+        retryVideoStream(QStringLiteral("cannot reopen stream"));
+    }
+}
+
+void CrosshairDetector::onStreamFailed(const QString& error)
+{
+    if (!m_streamFromDevice || !m_videoStreamEnabled) return;
+    m_streamFromDevice = false;
+    m_stream->stop();
+    retryVideoStream(error);
+}
+
+void CrosshairDetector::retryVideoStream(const QString& reason)
+{
+    // Poll while the stream is down
+    if (!m_samplingTimer->isActive()) {
+        m_samplingTimer->start(effectiveSamplingIntervalMs());
+    }
+    
+    if (++m_streamFailures >= MAX_STREAM_FAILURES) {
+        qWarning() << "[CrosshairDetector] Video stream failed" << m_streamFailures
+                   << "times (" << reason << ") - staying on polling";
+        emit detectionError("Video stream unavailable: " + reason);
+        return;
+    }
+    
+    const int delayMs = STREAM_RETRY_BASE_MS << (m_streamFailures - 1);
+    qWarning() << "[CrosshairDetector] Video stream failed (" << reason << ") - retrying in" << delayMs << "ms";
+    m_streamRetryTimer->start(delayMs);
+}
+
+void CrosshairDetector::onStreamCrop(const QImage& crop, qint64 frameStartUs, qint64 receivedNs)
+{
+    updateAimAssistState(analyzeImage(crop));
+    
+    const qint64 nowNs = steadyNowNs();
+    m_classifyLatencyNs[m_classifyLatencyCount++ % m_classifyLatencyNs.size()] = nowNs - receivedNs;
+    ++m_metricsWindowFrames;
+    
+    // Stream timestamps assume a fixed frame rate: lag = wall time since the
+    // first frame minus media time since the first frame
+    if (frameStartUs >= 0) {
+        if (m_streamFirstFrameUs < 0) {
+            m_streamFirstFrameUs = frameStartUs;
+            m_streamStartNs = receivedNs;
+        }
+        const qint64 wallUs = (receivedNs - m_streamStartNs) / 1000;
+        m_frameLagMs = qMax<qint64>(0, wallUs - (frameStartUs - m_streamFirstFrameUs)) / 1000.0;
+    }
+    
+    if (nowNs - m_metricsWindowStartNs >= METRICS_INTERVAL_NS) {
+        publishStreamMetrics();
+    }
+}
+
+void CrosshairDetector::publishStreamMetrics()
+{
+    const qint64 nowNs = steadyNowNs();
+    m_streamFps = m_metricsWindowFrames * 1e9 / qMax<qint64>(1, nowNs - m_metricsWindowStartNs);
+    m_metricsWindowStartNs = nowNs;
+    m_metricsWindowFrames = 0;
+    
+    // Median of the recent decision latencies
+    const size_t n = qMin(m_classifyLatencyCount, m_classifyLatencyNs.size());
+    if (n > 0) {
+        std::array<qint64, 256> sorted = m_classifyLatencyNs;
+        std::nth_element(sorted.begin(), sorted.begin() + n / 2, sorted.begin() + n);
+        m_classifyLatencyUs = sorted[n / 2] / 1000.0;
+    }
+    
+    emit streamMetricsChanged();
+}
+
 void CrosshairDetector::performSample()
 {
     if (m_sampleInProgress) return;  // Skip if previous sample still running
@@ -103,20 +323,144 @@ void CrosshairDetector::performSample()
     
     m_sampleInProgress = true;
     
-    // Run ADB screencap and pipe to stdout as PNG
-    // adb -s <device> exec-out screencap -p
-    m_screencapProcess->start(m_adbPath, {"-s", m_deviceId, "exec-out", "screencap", "-p"});
+    if (!m_rawCaptureEnabled || m_rawUnsupported) {
+        samplePng();
+    } else if (!m_rawLayout.isValid() || m_samplesSinceCalibration >= RECALIBRATE_SAMPLES) {
+        calibrateRaw();
+    } else {
+        sampleRawStrip();
+    }
+}
+
+void CrosshairDetector::samplePng()
+{
+    // Equivalent of `adb -s <device> exec-out screencap -p`, raw PNG bytes
+    m_adbClient->execAsync(m_deviceId, "screencap -p",
+                           [this](const AdbSocketClient::Reply& reply) { onScreencap(reply); },
+                           2000);
+}
+
+void CrosshairDetector::sampleRawStrip()
+{
+    ++m_samplesSinceCalibration;
+    
+    // Crop on the device: skip the header and the rows above the patch, keep
+    // the ROI's rows. head exiting stops screencap early with SIGPIPE.
+    const RawLayout layout = m_rawLayout;
+    const int rows = m_classifier.extent();
+    const qint64 rowBytes = qint64(layout.width) * layout.bytesPerPixel;
+    const qint64 firstRow = layout.height / 2 - rows / 2;
+    const qint64 offset = layout.headerSize + firstRow * rowBytes;
+    const qint64 length = rows * rowBytes;
+    
+    QString command = QString("screencap | tail -c +%1 | head -c %2").arg(offset + 1).arg(length);
+    m_adbClient->execAsync(m_deviceId, command,
+                           [this, layout, rows](const AdbSocketClient::Reply& reply) { onRawStrip(reply, layout, rows); },
+                           1000);
+}
+
+CrosshairDetector::RawLayout CrosshairDetector::parseRawHeader(const QByteArray& header)
+{
+    RawLayout layout;
+    if (header.size() < 12) return layout;
+    
+    auto le32 = [&](int at) {
+        const auto* u = reinterpret_cast<const uchar*>(header.constData() + at);
+        return quint32(u[0]) | quint32(u[1]) << 8 | quint32(u[2]) << 16 | quint32(u[3]) << 24;
+    };
+    const quint32 width = le32(0);
+    const quint32 height = le32(4);
+    if (width > 16384 || height > 16384) return layout;
+    
+    switch (le32(8)) {  // android PixelFormat
+    case 1: layout.format = QImage::Format_RGBA8888; layout.bytesPerPixel = 4; break;  // RGBA_8888
+    case 2: layout.format = QImage::Format_RGBX8888; layout.bytesPerPixel = 4; break;  // RGBX_8888
+    case 5: layout.format = QImage::Format_ARGB32;   layout.bytesPerPixel = 4; break;  // BGRA_8888
+    default: return layout;
+    }
+    layout.width = static_cast<int>(width);
+    layout.height = static_cast<int>(height);
+    return layout;
+}
+
+int CrosshairDetector::rawHeaderSize(const RawLayout& layout, qint64 totalBytes)
+{
+    const qint64 pixels = qint64(layout.width) * layout.height * layout.bytesPerPixel;
+    const qint64 headerSize = totalBytes - pixels;
+    return (headerSize == 12 || headerSize == 16) ? static_cast<int>(headerSize) : 0;
+}
+
+void CrosshairDetector::calibrateRaw()
+{
+    // 1) width, height, format from the header  2) total size -> header length
+    m_adbClient->execAsync(m_deviceId, "screencap | head -c 16", [this](const AdbSocketClient::Reply& header) {
+        if (!header.ok || header.data.size() < 12) {
+            m_sampleInProgress = false;
+            return;  // Retry on next sample
+        }
+        
+        RawLayout layout = parseRawHeader(header.data);
+        if (!layout.isValid()) {
+            qWarning() << "[CrosshairDetector] Unsupported raw framebuffer header" << header.data.left(12).toHex()
+                       << "- falling back to PNG capture";
+            m_rawUnsupported = true;
+            m_sampleInProgress = false;
+            applySamplingInterval();
+            return;
+        }
+        
+        m_adbClient->execAsync(m_deviceId, "screencap | wc -c", [this, layout](const AdbSocketClient::Reply& size) mutable {
+            m_sampleInProgress = false;
+            if (!size.ok) return;  // Retry on next sample
+            
+            bool ok = false;
+            const qint64 total = size.data.trimmed().toLongLong(&ok);
+            const int headerSize = ok ? rawHeaderSize(layout, total) : 0;
+            if (headerSize == 0) {
+                qWarning() << "[CrosshairDetector] Unexpected raw screencap size" << total
+                           << "- falling back to PNG capture";
+                m_rawUnsupported = true;
+                applySamplingInterval();
+                return;
+            }
+            
+            layout.headerSize = headerSize;
+            m_rawLayout = layout;
+            m_samplesSinceCalibration = 0;
+            qDebug() << "[CrosshairDetector] Raw capture:" << layout.width << "x" << layout.height
+                     << "| header" << headerSize << "bytes";
+        }, 3000);
+    }, 3000);
+}
+
+void CrosshairDetector::onRawStrip(const AdbSocketClient::Reply& reply, const RawLayout& layout, int rows)
+{
+    m_sampleInProgress = false;
+    
+    const qint64 rowBytes = qint64(layout.width) * layout.bytesPerPixel;
+    if (!reply.ok) {
+        return;  // Silent fail, will retry next sample
+    }
+    if (reply.data.size() != rows * rowBytes) {
+        m_rawLayout = RawLayout();  // Geometry changed (rotation?), re-probe
+        return;
+    }
+    
+    // Wrap the strip without copying; its center is the screen center
+    QImage strip(reinterpret_cast<const uchar*>(reply.data.constData()),
+                 layout.width, rows, rowBytes, layout.format);
+    updateAimAssistState(analyzeImage(strip));
 }
 
-void CrosshairDetector::onScreencapFinished(int exitCode, QProcess::ExitStatus exitStatus)
+void CrosshairDetector::onScreencap(const AdbSocketClient::Reply& reply)
 {
     m_sampleInProgress = false;
     
-    if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+    if (!reply.ok) {
         return;  // Silent fail, will retry next sample
     }
     
-    QByteArray imageData = m_screencapProcess->readAllStandardOutput();
+    const QByteArray& imageData = reply.data;
     if (imageData.isEmpty()) return;
     
     QImage screenshot;
@@ -124,8 +468,13 @@ void CrosshairDetector::onScreencapFinished(int exitCode, QProcess::ExitStatus e
         return;  // Failed to parse image
     }
     
+    updateAimAssistState(analyzeImage(screenshot));
+}
+
+void CrosshairDetector::updateAimAssistState(bool active)
+{
     bool wasActive = m_aimAssistActive;
-    m_aimAssistActive = analyzeImage(screenshot);
+    m_aimAssistActive = active;
     
     if (m_aimAssistActive != wasActive) {
         qDebug() << "[CrosshairDetector] Aim assist state:" << (m_aimAssistActive ? "ACTIVE (RED)" : "INACTIVE (WHITE)");
@@ -133,51 +482,10 @@ void CrosshairDetector::onScreencapFinished(int exitCode, QProcess::ExitStatus e
     }
 }
 
-bool CrosshairDetector::analyzeImage(const QImage& image)
-{
-    // Sample 5x5 pixels at the exact center of the screen (crosshair location)
-    int centerX = image.width() / 2;
-    int centerY = image.height() / 2;
-    
-    int redCount = 0;
-    int totalSamples = 0;
-    
-    // Sample a 5x5 area around center
-    for (int dx = -2; dx <= 2; dx++) {
-        for (int dy = -2; dy <= 2; dy++) {
-            int x = centerX + dx;
-            int y = centerY + dy;
-            
-            if (x >= 0 && x < image.width() && y >= 0 && y < image.height()) {
-                QColor pixel = image.pixelColor(x, y);
-                if (isRedColor(pixel)) {
-                    redCount++;
-                }
-                totalSamples++;
-            }
-        }
-    }
-    
-    // Consider aim assist active if > 40% of center pixels are red
-    return (totalSamples > 0) && (static_cast<double>(redCount) / totalSamples > 0.4);
-}
-
-bool CrosshairDetector::isRedColor(const QColor& color) const
+bool CrosshairDetector::analyzeImage(const QImage& image) const
 {
-    // Free Fire crosshair red detection
-    // Red hue is around 0-30 or 330-360 degrees
-    // Must have decent saturation and not be too dark
-    
-    int h = color.hue();
-    int s = color.saturation();
-    int v = color.value();
-    
-    bool isRedHue = (h >= 0 && h <= 30) || (h >= 330 && h <= 360) || h == -1;
-    bool hasSaturation = s > 100;  // Not grayish
-    bool notTooDark = v > 80;      // Not too dark
-    bool hasRedChannel = color.red() > 150 && color.red() > color.green() + 50;
-    
-    return isRedHue && hasSaturation && notTooDark && hasRedChannel;
+    // Active if more than 40% of the ROI around the screen center is red
+    return m_classifier.isActive(image);
 }
 
 } // namespace NeoZ
@@ -3,21 +3,42 @@
 
 #include <QObject>
 #include <QTimer>
-#include <QProcess>
 #include <QImage>
 #include <memory>
+#include "../adb/AdbSocketClient.h"
+#include "CrosshairStream.h"
+#include "ReticleClassifier.h"
+#include <array>
 
 namespace NeoZ {
 
 /**
  * @brief Crosshair color detection for Free Fire aim assist state.
  * 
- * Uses ADB screencap to sample center screen pixels and detect:
+ * Uses ADB screencap (exec: over the adb server socket, no adb process
+ * per sample) to sample center screen pixels and detect:
  * - WHITE crosshair = Normal, no enemy in range
  * - RED crosshair = Free Fire aim assist active (enemy in range box)
  * 
  * When aim assist is active, emits signal to reduce Y sensitivity
  * to prevent body lock and help headshots.
+ *
+ * Raw capture mode (default) runs `screencap` without -p and crops the
+ * framebuffer on the device with tail/head, so only the center rows
+ * (~20 KB at 1080p) cross the wire and nothing is PNG-encoded or decoded.
+ * The framebuffer layout (size, pixel format, 12- or 16-byte header) is
+ * probed once and re-probed periodically to follow rotation. Devices with
+ * unsupported formats fall back to PNG capture.
+ *
+ * Video stream mode replaces polling with one continuous screenrecord
+ * H.264 stream (CrosshairStream) and classifies every decoded frame.
+ * Freshness metrics: streamFps; frameLagMs, how far decoded frames trail
+ * the stream's media clock (frame to decoded crop); classifyLatencyUs,
+ * decoded crop to aim-assist decision. screenrecord carries no wall-clock
+ * timestamps, so the two together are the frame-to-decision estimate.
+ * A stream that fails or ends early is retried with exponential backoff,
+ * polling in the meantime; after MAX_STREAM_FAILURES in a row detection
+ * stays on polling until restarted.
  */
 class CrosshairDetector : public QObject
 {
@@ -27,8 +48,31 @@ class CrosshairDetector : public QObject
     Q_PROPERTY(bool aimAssistActive READ aimAssistActive NOTIFY aimAssistStateChanged)
     Q_PROPERTY(int samplingIntervalMs READ samplingIntervalMs WRITE setSamplingIntervalMs NOTIFY settingsChanged)
     Q_PROPERTY(double yReductionAlpha READ yReductionAlpha WRITE setYReductionAlpha NOTIFY settingsChanged)
+    Q_PROPERTY(bool rawCaptureEnabled READ rawCaptureEnabled WRITE setRawCaptureEnabled NOTIFY settingsChanged)
+    Q_PROPERTY(bool videoStreamEnabled READ videoStreamEnabled WRITE setVideoStreamEnabled NOTIFY settingsChanged)
+    
+    // Region of interest: "square" | "ring" | "cross", radius in pixels
+    Q_PROPERTY(QString reticleStyle READ reticleStyle WRITE setReticleStyle NOTIFY settingsChanged)
+    Q_PROPERTY(int roiRadius READ roiRadius WRITE setRoiRadius NOTIFY settingsChanged)
+    Q_PROPERTY(int roiThickness READ roiThickness WRITE setRoiThickness NOTIFY settingsChanged)
+    
+    // Video stream metrics
+    Q_PROPERTY(double streamFps READ streamFps NOTIFY streamMetricsChanged)
+    Q_PROPERTY(double classifyLatencyUs READ classifyLatencyUs NOTIFY streamMetricsChanged)
+    Q_PROPERTY(double frameLagMs READ frameLagMs NOTIFY streamMetricsChanged)
     
 public:
+    // Raw framebuffer geometry as reported by `screencap` (no -p)
+    struct RawLayout {
+        int width = 0;
+        int height = 0;
+        int bytesPerPixel = 0;
+        int headerSize = 0;          // 12, or 16 with the color space field
+        QImage::Format format = QImage::Format_Invalid;
+        
+        bool isValid() const { return width > 0 && height > 0 && format != QImage::Format_Invalid; }
+    };
+    
     explicit CrosshairDetector(QObject* parent = nullptr);
     ~CrosshairDetector() override;
     
@@ -36,12 +80,26 @@ public:
     bool enabled() const { return m_enabled; }
     bool aimAssistActive() const { return m_aimAssistActive; }
     int samplingIntervalMs() const { return m_samplingIntervalMs; }
+    int effectiveSamplingIntervalMs() const;   // PNG capture can't go below PNG_MIN_INTERVAL_MS
     double yReductionAlpha() const { return m_yReductionAlpha; }
+    bool rawCaptureEnabled() const { return m_rawCaptureEnabled; }
+    bool videoStreamEnabled() const { return m_videoStreamEnabled; }
+    QString reticleStyle() const { return ReticleClassifier::styleName(m_classifier.style()); }
+    int roiRadius() const { return m_classifier.radius(); }
+    int roiThickness() const { return m_classifier.thickness(); }
+    double streamFps() const { return m_streamFps; }
+    double classifyLatencyUs() const { return m_classifyLatencyUs; }
+    double frameLagMs() const { return m_frameLagMs; }
     
     // Setters
     void setEnabled(bool enabled);
     void setSamplingIntervalMs(int ms);
     void setYReductionAlpha(double alpha);
+    void setRawCaptureEnabled(bool enabled);
+    void setVideoStreamEnabled(bool enabled);
+    void setReticleStyle(const QString& style);
+    void setRoiRadius(int radius);
+    void setRoiThickness(int thickness);
     
     // ADB device management
     void setAdbPath(const QString& path);
@@ -51,19 +109,43 @@ public:
     Q_INVOKABLE void startDetection();
     Q_INVOKABLE void stopDetection();
     
+    // Run the video stream path on a recorded .h264 file (tests, tuning)
+    Q_INVOKABLE bool startStreamFromFile(const QString& path);
+    
+    // Layout from the first 12-16 bytes of `screencap`; invalid if unsupported
+    static RawLayout parseRawHeader(const QByteArray& header);
+    // Header length (12 or 16) implied by the total `screencap` size, 0 if neither
+    static int rawHeaderSize(const RawLayout& layout, qint64 totalBytes);
+    
+    static constexpr int MIN_INTERVAL_MS = 16;       // Raw capture, ~60 Hz
+    static constexpr int PNG_MIN_INTERVAL_MS = 30;   // PNG encode + decode per sample
+    
 signals:
     void enabledChanged();
     void aimAssistStateChanged(bool active);
     void settingsChanged();
     void detectionError(const QString& error);
+    void streamMetricsChanged();
     
 private slots:
     void performSample();
-    void onScreencapFinished(int exitCode, QProcess::ExitStatus exitStatus);
     
 private:
-    bool analyzeImage(const QImage& image);
-    bool isRedColor(const QColor& color) const;
+    void samplePng();
+    void sampleRawStrip();
+    void calibrateRaw();
+    void onScreencap(const AdbSocketClient::Reply& reply);
+    void onRawStrip(const AdbSocketClient::Reply& reply, const RawLayout& layout, int rows);
+    void updateAimAssistState(bool active);
+    void applySamplingInterval();
+    bool startVideoStream();
+    void onStreamCrop(const QImage& crop, qint64 frameStartUs, qint64 receivedNs);
+    void onStreamEnded();
+    void onStreamFailed(const QString& error);
+    void retryVideoStream(const QString& reason);
+    void publishStreamMetrics();
+    bool analyzeImage(const QImage& image) const;
+    void applyRoi(ReticleClassifier::Style style, int radius, int thickness);
     
     // State
     bool m_enabled = false;
@@ -72,11 +154,40 @@ private:
     // Settings
     int m_samplingIntervalMs = 50;   // 50ms = 20 samples/sec
     double m_yReductionAlpha = 0.2;  // 20% Y reduction when assist active
+    bool m_rawCaptureEnabled = true;
+    ReticleClassifier m_classifier;  // Default: 5x5 square
     
     // ADB
     QString m_adbPath;
     QString m_deviceId;
-    std::unique_ptr<QProcess> m_screencapProcess;
+    std::unique_ptr<AdbSocketClient> m_adbClient;
+    
+    // Raw capture
+    RawLayout m_rawLayout;
+    bool m_rawUnsupported = false;   // Probe failed: use PNG for this device
+    int m_samplesSinceCalibration = 0;
+    static constexpr int RECALIBRATE_SAMPLES = 300;    // ~5 s at 60 Hz (rotation)
+    
+    // Video stream
+    bool m_videoStreamEnabled = false;
+    std::unique_ptr<CrosshairStream> m_stream;
+    bool m_streamFromDevice = false;
+    QTimer* m_streamRetryTimer = nullptr;
+    int m_streamFailures = 0;            // In a row; reset by a full-length stream
+    qint64 m_streamOpenedNs = 0;
+    qint64 m_streamStartNs = 0;
+    qint64 m_streamFirstFrameUs = -1;
+    qint64 m_metricsWindowStartNs = 0;
+    int m_metricsWindowFrames = 0;
+    std::array<qint64, 256> m_classifyLatencyNs{};
+    size_t m_classifyLatencyCount = 0;
+    double m_streamFps = 0.0;
+    double m_classifyLatencyUs = 0.0;
+    double m_frameLagMs = 0.0;
+    static constexpr qint64 METRICS_INTERVAL_NS = 1'000'000'000;
+    static constexpr int STREAM_RETRY_BASE_MS = 500;      // Doubles per failure
+    static constexpr int MAX_STREAM_FAILURES = 4;
+    static constexpr qint64 MIN_STREAM_UPTIME_MS = 10'000; // Shorter ends count as failures
     
     // Polling
     QTimer* m_samplingTimer = nullptr;
@@ -0,0 +1,384 @@
+#include "CrosshairStream.h"
+#include "../adb/AdbSocketClient.h"
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QFile>
+#include <QMediaPlayer>
+#include <QMutex>
+#include <QTcpSocket>
+#include <QUrl>
+#include <QVideoSink>
+#include <QWaitCondition>
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
+#include <QPlaybackOptions>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace NeoZ {
+
+namespace {
+
+// Raw H.264 elementary stream; the URL only tells the demuxer what to expect
+const QUrl H264_HINT(QStringLiteral("stream.h264"));
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 10, 0)
+// No low-latency intent: outrun the player's assumed 25 fps so the arrival
+// of data, not the clock, paces a live stream (screenrecord sends <= 60 fps)
+constexpr qreal LIVE_PLAYBACK_RATE = 4.0;
+#endif
+
+inline int clamp8(int v)
+{
+    return std::clamp(v, 0, 255);
+}
+
+// BT.601 limited range (screenrecord's encoder default), 8.8 fixed point
+inline QRgb yuvToRgb(int y, int u, int v)
+{
+    const int c = 298 * (y - 16);
+    const int d = u - 128;
+    const int e = v - 128;
+    return qRgb(clamp8((c + 409 * e + 128) >> 8),
+                clamp8((c - 100 * d - 208 * e + 128) >> 8),
+                clamp8((c + 516 * d + 128) >> 8));
+}
+
+inline qint64 steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+/**
+ * @brief Thread-safe pipe from the stream socket to the player.
+ *
+ * append() and finish() run on the owner thread; the player's demux thread
+ * reads. Reads block until data arrives, and atEnd() holds only once the
+ * writer has finished and everything was read.
+ */
+class CrosshairStream::LiveBuffer : public QIODevice
+{
+public:
+    LiveBuffer()
+    {
+        // Unbuffered: QIODevice's own buffer is not thread-safe
+        open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    }
+
+    void append(const QByteArray& data)
+    {
+        if (data.isEmpty()) return;
+        {
+            QMutexLocker locker(&m_mutex);
+            m_data += data;
+        }
+        m_ready.wakeAll();
+        emit readyRead();
+    }
+
+    // No more data: wakes a blocked reader, which then sees EOF
+    void finish()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_finished = true;
+        m_ready.wakeAll();
+    }
+
+    bool isSequential() const override { return true; }
+
+    bool atEnd() const override
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_finished && m_data.isEmpty();
+    }
+
+    qint64 bytesAvailable() const override
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_data.size() + QIODevice::bytesAvailable();
+    }
+
+    bool waitForReadyRead(int msecs) override
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_data.isEmpty() && !m_finished) {
+            m_ready.wait(&m_mutex, QDeadlineTimer(msecs));   // Negative: no limit
+        }
+        return !m_data.isEmpty();
+    }
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_data.isEmpty() && !m_finished) {
+            m_ready.wait(&m_mutex);
+        }
+        if (m_data.isEmpty()) return -1;   // Finished and drained
+
+        const qint64 n = qMin<qint64>(maxSize, m_data.size());
+        std::memcpy(data, m_data.constData(), static_cast<size_t>(n));
+        m_data.remove(0, n);
+        return n;
+    }
+
+    qint64 writeData(const char*, qint64) override { return -1; }
+
+private:
+    mutable QMutex m_mutex;
+    QWaitCondition m_ready;
+    QByteArray m_data;
+    bool m_finished = false;
+};
+
+CrosshairStream::CrosshairStream(QObject* parent)
+    : QObject(parent)
+{
+}
+
+CrosshairStream::~CrosshairStream()
+{
+    stop();
+}
+
+bool CrosshairStream::startDevice(AdbSocketClient* client, const QString& serial)
+{
+    if (!client || serial.isEmpty()) return false;
+
+    QString error;
+    QTcpSocket* socket = client->openExecStream(
+        serial, "screenrecord --output-format=h264 --bit-rate 8000000 -", 3000, &error);
+    if (!socket) {
+        qWarning() << "[CrosshairStream] Cannot open screenrecord stream:" << error;
+        emit streamError(error);
+        return false;
+    }
+
+    qDebug() << "[CrosshairStream] Streaming H.264 from" << serial;
+    return startSocket(socket);
+}
+
+bool CrosshairStream::startSocket(QTcpSocket* socket)
+{
+    if (!socket) return false;
+
+    stop();
+
+    auto live = std::make_unique<LiveBuffer>();
+    m_live = live.get();
+    m_socket.reset(socket);
+    connect(socket, &QTcpSocket::readyRead, this, [this]() {
+        m_live->append(m_socket->readAll());
+    });
+    connect(socket, &QTcpSocket::disconnected, this, [this]() {
+        m_live->append(m_socket->readAll());
+        m_live->finish();
+    });
+
+    // Whatever arrived with the service handshake, or before we connected
+    m_live->append(socket->readAll());
+    if (socket->state() != QAbstractSocket::ConnectedState) {
+        m_live->finish();
+    }
+    return startSource(std::move(live), true);
+}
+
+bool CrosshairStream::startFile(const QString& path)
+{
+    auto file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly)) {
+        qWarning() << "[CrosshairStream] Cannot open" << path << ":" << file->errorString();
+        emit streamError(file->errorString());
+        return false;
+    }
+
+    qDebug() << "[CrosshairStream] Replaying" << path;
+    stop();
+    return startSource(std::move(file), false);
+}
+
+bool CrosshairStream::startSource(std::unique_ptr<QIODevice> source, bool live)
+{
+    if (!m_player) {
+        m_player = new QMediaPlayer(this);
+        m_sink = new QVideoSink(this);
+        m_player->setVideoSink(m_sink);
+
+        connect(m_sink, &QVideoSink::videoFrameChanged, this, &CrosshairStream::onVideoFrame);
+        connect(m_player, &QMediaPlayer::mediaStatusChanged, this, [this](QMediaPlayer::MediaStatus status) {
+            if (m_stopping || !m_source) return;   // Our own stop(), not the stream
+            if (status == QMediaPlayer::EndOfMedia) {
+                qDebug() << "[CrosshairStream] Stream ended after" << m_framesDecoded << "frames";
+                emit streamEnded();
+            } else if (status == QMediaPlayer::InvalidMedia) {
+                fail(QStringLiteral("invalid media"));
+            }
+        });
+        connect(m_player, &QMediaPlayer::errorOccurred, this,
+                [this](QMediaPlayer::Error error, const QString& message) {
+            if (m_stopping || !m_source) return;
+            if (error != QMediaPlayer::NoError) {
+                fail(message);
+            }
+        });
+    }
+
+    // Live: decode each frame as it arrives instead of pacing by the clock
+#if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
+    QPlaybackOptions options;
+    if (live) {
+        options.setPlaybackIntent(QPlaybackOptions::PlaybackIntent::LowLatencyStreaming);
+    }
+    m_player->setPlaybackOptions(options);
+#else
+    m_player->setPlaybackRate(live ? LIVE_PLAYBACK_RATE : 1.0);
+#endif
+
+    m_source = std::move(source);
+    m_framesDecoded = 0;
+    m_failed = false;
+    m_player->setSourceDevice(m_source.get(), H264_HINT);
+    m_player->play();
+    return true;
+}
+
+void CrosshairStream::stop()
+{
+    m_stopping = true;
+
+    // The demux thread may be blocked reading: release it before the player joins it
+    if (m_socket) {
+        m_socket->disconnect(this);
+    }
+    if (m_live) {
+        m_live->finish();
+    }
+    if (m_player) {
+        m_player->stop();
+        m_player->setSourceDevice(nullptr);
+    }
+    m_source.reset();
+    m_live = nullptr;
+    m_socket.reset();  // Closing the socket ends screenrecord on the device
+
+    m_stopping = false;
+}
+
+void CrosshairStream::fail(const QString& message)
+{
+    // The player reports one failure as both an error and InvalidMedia
+    if (m_failed) return;
+    m_failed = true;
+    qWarning() << "[CrosshairStream] Decoder error:" << message;
+    emit streamError(message);
+}
+
+void CrosshairStream::onVideoFrame(const QVideoFrame& frame)
+{
+    const qint64 receivedNs = steadyNowNs();
+    if (!frame.isValid()) return;
+
+    ++m_framesDecoded;
+    QImage crop = cropCenter(frame, m_cropSize);
+    if (!crop.isNull()) {
+        emit cropReady(crop, frame.startTime(), receivedNs);
+    }
+}
+
+QImage CrosshairStream::cropCenter(const QVideoFrame& source, int size)
+{
+    const int w = source.width();
+    const int h = source.height();
+    const int x0 = std::clamp(w / 2 - size / 2, 0, qMax(0, w - size));
+    const int y0 = std::clamp(h / 2 - size / 2, 0, qMax(0, h - size));
+    const int cw = qMin(size, w);
+    const int ch = qMin(size, h);
+
+    // Uncommon decoder output (e.g. GPU surface): full conversion
+    auto slowPath = [&]() {
+        return source.toImage().copy(x0, y0, cw, ch).convertToFormat(QImage::Format_RGB32);
+    };
+
+    QVideoFrame frame(source);
+    if (!frame.map(QVideoFrame::ReadOnly)) return slowPath();
+
+    QImage crop(cw, ch, QImage::Format_RGB32);
+    bool converted = true;
+
+    switch (frame.pixelFormat()) {
+    case QVideoFrameFormat::Format_NV12:
+    case QVideoFrameFormat::Format_NV21: {
+        const bool nv21 = frame.pixelFormat() == QVideoFrameFormat::Format_NV21;
+        for (int y = 0; y < ch; ++y) {
+            const uchar* yRow = frame.bits(0) + (y0 + y) * frame.bytesPerLine(0);
+            const uchar* uvRow = frame.bits(1) + ((y0 + y) / 2) * frame.bytesPerLine(1);
+            QRgb* out = reinterpret_cast<QRgb*>(crop.scanLine(y));
+            for (int x = 0; x < cw; ++x) {
+                const int px = x0 + x;
+                const uchar* uv = uvRow + (px & ~1);
+                out[x] = nv21 ? yuvToRgb(yRow[px], uv[1], uv[0]) : yuvToRgb(yRow[px], uv[0], uv[1]);
+            }
+        }
+        break;
+    }
+    case QVideoFrameFormat::Format_YUV420P: {
+        for (int y = 0; y < ch; ++y) {
+            const uchar* yRow = frame.bits(0) + (y0 + y) * frame.bytesPerLine(0);
+            const uchar* uRow = frame.bits(1) + ((y0 + y) / 2) * frame.bytesPerLine(1);
+            const uchar* vRow = frame.bits(2) + ((y0 + y) / 2) * frame.bytesPerLine(2);
+            QRgb* out = reinterpret_cast<QRgb*>(crop.scanLine(y));
+            for (int x = 0; x < cw; ++x) {
+                const int px = x0 + x;
+                out[x] = yuvToRgb(yRow[px], uRow[px / 2], vRow[px / 2]);
+            }
+        }
+        break;
+    }
+    case QVideoFrameFormat::Format_ARGB8888:
+    case QVideoFrameFormat::Format_ARGB8888_Premultiplied:
+    case QVideoFrameFormat::Format_XRGB8888:
+    case QVideoFrameFormat::Format_BGRA8888:
+    case QVideoFrameFormat::Format_BGRA8888_Premultiplied:
+    case QVideoFrameFormat::Format_BGRX8888:
+    case QVideoFrameFormat::Format_RGBA8888:
+    case QVideoFrameFormat::Format_RGBX8888: {
+        // Byte offsets of R, G, B within each 4-byte pixel
+        int r = 1, g = 2, b = 3;                     // ARGB / XRGB
+        switch (frame.pixelFormat()) {
+        case QVideoFrameFormat::Format_BGRA8888:
+        case QVideoFrameFormat::Format_BGRA8888_Premultiplied:
+        case QVideoFrameFormat::Format_BGRX8888:
+            r = 2; g = 1; b = 0;
+            break;
+        case QVideoFrameFormat::Format_RGBA8888:
+        case QVideoFrameFormat::Format_RGBX8888:
+            r = 0; g = 1; b = 2;
+            break;
+        default:
+            break;
+        }
+        for (int y = 0; y < ch; ++y) {
+            const uchar* row = frame.bits(0) + (y0 + y) * frame.bytesPerLine(0) + x0 * 4;
+            QRgb* out = reinterpret_cast<QRgb*>(crop.scanLine(y));
+            for (int x = 0; x < cw; ++x) {
+                out[x] = qRgb(row[x * 4 + r], row[x * 4 + g], row[x * 4 + b]);
+            }
+        }
+        break;
+    }
+    default:
+        converted = false;
+        break;
+    }
+
+    frame.unmap();
+
+    return converted ? crop : slowPath();
+}
+
+} // namespace NeoZ
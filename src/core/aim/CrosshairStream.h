@@ -0,0 +1,96 @@
+#ifndef NEOZ_CROSSHAIRSTREAM_H
+#define NEOZ_CROSSHAIRSTREAM_H
+
+#include <QObject>
+#include <QImage>
+#include <QString>
+#include <QVideoFrame>
+#include <memory>
+
+class QIODevice;
+class QMediaPlayer;
+class QTcpSocket;
+class QVideoSink;
+
+namespace NeoZ {
+
+class AdbSocketClient;
+
+/**
+ * @brief Continuous H.264 frame source for crosshair detection.
+ *
+ * Keeps one `screenrecord --output-format=h264 -` stream open over the
+ * adb server socket and decodes it incrementally with QMediaPlayer into a
+ * QVideoSink. For every decoded frame only the center crop is converted
+ * to RGB (straight from the mapped NV12 / YUV420P / packed RGB planes),
+ * so per-frame work is independent of the screen size.
+ *
+ * The socket is not handed to the player: the player reads from its own
+ * demux thread and treats a momentarily empty sequential device as the
+ * end of the stream. Socket data is copied into a LiveBuffer instead, whose
+ * reads block until more arrives and which reports EOF only once the socket
+ * has closed. A raw elementary stream has no timestamps, so live streams
+ * are played without clock pacing (LowLatencyStreaming on Qt 6.10+, a raised
+ * playback rate before that) and each frame is decoded as it arrives.
+ *
+ * startFile() plays a recorded .h264 elementary stream through the same
+ * path, for tests and offline tuning.
+ *
+ * screenrecord stops after its time limit (180 s); streamEnded() lets the
+ * owner reopen the stream. A stream the decoder rejects, or that fails
+ * mid-way, reports streamError() once instead.
+ */
+class CrosshairStream : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CrosshairStream(QObject* parent = nullptr);
+    ~CrosshairStream() override;
+
+    // Side of the square center crop handed to the classifier
+    void setCropSize(int size) { m_cropSize = qMax(1, size); }
+    int cropSize() const { return m_cropSize; }
+
+    bool startDevice(AdbSocketClient* client, const QString& serial);
+    // Play an open socket positioned at the start of an H.264 stream
+    // (takes ownership; startDevice() uses it, exposed for tests)
+    bool startSocket(QTcpSocket* socket);
+    bool startFile(const QString& path);
+    void stop();
+    bool isRunning() const { return m_source != nullptr; }
+
+    quint64 framesDecoded() const { return m_framesDecoded; }
+
+    // Center crop of a frame, converted to RGB32 (exposed for tests)
+    static QImage cropCenter(const QVideoFrame& frame, int size);
+
+signals:
+    // receivedNs: steady-clock time the decoded frame reached us
+    void cropReady(const QImage& crop, qint64 frameStartUs, qint64 receivedNs);
+    void streamEnded();                        // Played to the end
+    void streamError(const QString& error);    // Could not open or decode
+
+private slots:
+    void onVideoFrame(const QVideoFrame& frame);
+
+private:
+    class LiveBuffer;
+
+    bool startSource(std::unique_ptr<QIODevice> source, bool live);
+    void fail(const QString& message);
+
+    QMediaPlayer* m_player = nullptr;
+    QVideoSink* m_sink = nullptr;
+    std::unique_ptr<QIODevice> m_source;    // What the player reads
+    std::unique_ptr<QTcpSocket> m_socket;   // Live stream feeding m_live
+    LiveBuffer* m_live = nullptr;           // m_source while streaming live
+    bool m_stopping = false;
+    int m_cropSize = 5;
+    quint64 m_framesDecoded = 0;
+    bool m_failed = false;
+};
+
+} // namespace NeoZ
+
+#endif // NEOZ_CROSSHAIRSTREAM_H
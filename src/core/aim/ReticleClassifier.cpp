@@ -0,0 +1,253 @@
+#include "ReticleClassifier.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NEOZ_RETICLE_SSE2 1
+#include <emmintrin.h>
+#else
+#define NEOZ_RETICLE_SSE2 0
+#endif
+
+namespace NeoZ {
+
+namespace {
+
+struct Shifts {
+    int r, g, b;
+};
+
+inline Shifts shiftsFor(ReticleClassifier::ChannelOrder order)
+{
+    return order == ReticleClassifier::ChannelOrder::Bgra ? Shifts{16, 8, 0} : Shifts{0, 8, 16};
+}
+
+inline quint32 loadPixel(const uchar* p)
+{
+    quint32 v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;   // Little-endian targets only (x86, ARM Windows/Android)
+}
+
+#if NEOZ_RETICLE_SSE2
+
+// 4 pixels -> one channel in 32-bit lanes
+inline __m128i channel(__m128i px, __m128i shift, __m128i byteMask)
+{
+    return _mm_and_si128(_mm_srl_epi32(px, shift), byteMask);
+}
+
+int countRedSse2(const uchar* pixels, int n, Shifts s, int* done)
+{
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    const __m128i rShift = _mm_cvtsi32_si128(s.r);
+    const __m128i gShift = _mm_cvtsi32_si128(s.g);
+    const __m128i bShift = _mm_cvtsi32_si128(s.b);
+    const __m128i k150 = _mm_set1_epi16(150);
+    const __m128i k50 = _mm_set1_epi16(50);
+    const __m128i k51 = _mm_set1_epi16(51);
+    const __m128i k20 = _mm_set1_epi16(20);
+
+    int red = 0;
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i * 4));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i * 4 + 16));
+
+        // Values are 0..255, so the signed 32->16 pack is lossless
+        const __m128i r = _mm_packs_epi32(channel(lo, rShift, byteMask), channel(hi, rShift, byteMask));
+        const __m128i g = _mm_packs_epi32(channel(lo, gShift, byteMask), channel(hi, gShift, byteMask));
+        const __m128i b = _mm_packs_epi32(channel(lo, bShift, byteMask), channel(hi, bShift, byteMask));
+
+        const __m128i mn = _mm_min_epi16(g, b);
+        const __m128i delta = _mm_sub_epi16(r, mn);
+        const __m128i gbDiff = _mm_sub_epi16(_mm_max_epi16(g, b), mn);
+
+        __m128i hit = _mm_cmpgt_epi16(r, k150);
+        hit = _mm_and_si128(hit, _mm_cmpgt_epi16(_mm_sub_epi16(r, g), k50));
+        hit = _mm_andnot_si128(_mm_cmpgt_epi16(b, r), hit);
+        hit = _mm_andnot_si128(_mm_cmpgt_epi16(_mm_add_epi16(gbDiff, gbDiff), delta), hit);
+        hit = _mm_and_si128(hit, _mm_cmpgt_epi16(_mm_mullo_epi16(delta, k51), _mm_mullo_epi16(r, k20)));
+
+        // Two mask bits per 16-bit lane
+        red += std::popcount(static_cast<unsigned>(_mm_movemask_epi8(hit))) / 2;
+    }
+    *done = i;
+    return red;
+}
+
+#endif
+
+} // namespace
+
+ReticleClassifier::ReticleClassifier()
+{
+    rebuildSpans();
+}
+
+void ReticleClassifier::setShape(Style style, int radius, int thickness)
+{
+    m_style = style;
+    m_radius = std::clamp(radius, 0, 64);
+    m_thickness = std::clamp(thickness, 1, m_radius + 1);
+    rebuildSpans();
+}
+
+void ReticleClassifier::rebuildSpans()
+{
+    m_spans.clear();
+    const int r = m_radius;
+
+    switch (m_style) {
+    case Style::Square:
+        for (int dy = -r; dy <= r; ++dy) {
+            m_spans.append({dy, -r, r});
+        }
+        break;
+
+    case Style::Ring: {
+        const int outer2 = r * r;
+        const int innerR = std::max(0, r - m_thickness);
+        const int inner2 = innerR * innerR;
+        for (int dy = -r; dy <= r; ++dy) {
+            // Outer half-width on this row
+            int xo = 0;
+            while ((xo + 1) * (xo + 1) + dy * dy <= outer2) ++xo;
+            // First column strictly inside the hole (none if the row misses it)
+            int xi = -1;
+            if (dy * dy < inner2) {
+                xi = 0;
+                while ((xi + 1) * (xi + 1) + dy * dy < inner2) ++xi;
+            }
+            if (xi < 0) {
+                m_spans.append({dy, -xo, xo});
+            } else if (xi < xo) {
+                m_spans.append({dy, -xo, -xi - 1});
+                m_spans.append({dy, xi + 1, xo});
+            }
+        }
+        break;
+    }
+
+    case Style::Cross: {
+        const int half = (m_thickness - 1) / 2;
+        for (int dy = -r; dy <= r; ++dy) {
+            if (std::abs(dy) <= half) {
+                m_spans.append({dy, -r, r});         // Horizontal bar
+            } else {
+                m_spans.append({dy, -half, half});   // Vertical bar
+            }
+        }
+        break;
+    }
+    }
+
+    m_maskPixels = 0;
+    for (const Span& span : m_spans) {
+        m_maskPixels += span.dx1 - span.dx0 + 1;
+    }
+}
+
+ReticleClassifier::Result ReticleClassifier::classify(const QImage& image) const
+{
+    Result result;
+    if (image.isNull()) return result;
+
+    ChannelOrder order;
+    switch (image.format()) {
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+        order = ChannelOrder::Bgra;
+        break;
+    case QImage::Format_RGBA8888:
+    case QImage::Format_RGBX8888:
+    case QImage::Format_RGBA8888_Premultiplied:
+        order = ChannelOrder::Rgba;
+        break;
+    default: {
+        // Convert only the ROI's bounding box (PNG screenshots are often RGB888)
+        const int e = extent();
+        QImage roi = image.copy(image.width() / 2 - m_radius, image.height() / 2 - m_radius, e, e)
+                          .convertToFormat(QImage::Format_RGB32);
+        return classify(roi);
+    }
+    }
+
+    const int cx = image.width() / 2;
+    const int cy = image.height() / 2;
+    for (const Span& span : m_spans) {
+        const int y = cy + span.dy;
+        if (y < 0 || y >= image.height()) continue;
+        const int x0 = std::max(0, cx + span.dx0);
+        const int x1 = std::min(image.width() - 1, cx + span.dx1);
+        if (x1 < x0) continue;
+
+        const int n = x1 - x0 + 1;
+        result.red += countRed(image.constScanLine(y) + x0 * 4, n, order);
+        result.total += n;
+    }
+    return result;
+}
+
+bool ReticleClassifier::isActive(const QImage& image) const
+{
+    const Result result = classify(image);
+    return result.total > 0 && result.ratio() > m_threshold;
+}
+
+bool ReticleClassifier::isRed(int r, int g, int b)
+{
+    const int mn = std::min(g, b);
+    const int delta = r - mn;
+    return r > 150
+        && r - g > 50
+        && r >= b
+        && 2 * (std::max(g, b) - mn) <= delta
+        && delta * 51 > r * 20;
+}
+
+int ReticleClassifier::countRedScalar(const uchar* pixels, int n, ChannelOrder order)
+{
+    const Shifts s = shiftsFor(order);
+    int red = 0;
+    for (int i = 0; i < n; ++i) {
+        const quint32 px = loadPixel(pixels + i * 4);
+        red += isRed((px >> s.r) & 0xFF, (px >> s.g) & 0xFF, (px >> s.b) & 0xFF) ? 1 : 0;
+    }
+    return red;
+}
+
+int ReticleClassifier::countRed(const uchar* pixels, int n, ChannelOrder order)
+{
+#if NEOZ_RETICLE_SSE2
+    int done = 0;
+    int red = countRedSse2(pixels, n, shiftsFor(order), &done);
+    return red + countRedScalar(pixels + done * 4, n - done, order);
+#else
+    return countRedScalar(pixels, n, order);
+#endif
+}
+
+ReticleClassifier::Style ReticleClassifier::styleFromName(const QString& name)
+{
+    const QString key = name.trimmed().toLower();
+    if (key == "ring") return Style::Ring;
+    if (key == "cross") return Style::Cross;
+    return Style::Square;
+}
+
+QString ReticleClassifier::styleName(Style style)
+{
+    switch (style) {
+    case Style::Ring: return "ring";
+    case Style::Cross: return "cross";
+    case Style::Square: break;
+    }
+    return "square";
+}
+
+} // namespace NeoZ
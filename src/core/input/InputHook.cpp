@@ -19,11 +19,55 @@ InputHookManager::InputHookManager(QObject *parent) : QObject(parent)
     // Default settings
     m_pipeline->setInputAuthorityEnabled(true); // We control the input
     m_pipeline->setSafeZoneClampEnabled(true);
+
+    m_worker = std::make_unique<NeoZ::InputWorker>(m_pipeline, &InputHookManager::injectMovement);
 }
 
 InputHookManager::~InputHookManager()
 {
     stopHook();
+    setWorkerMode(false);
+}
+
+void InputHookManager::setWorkerMode(bool enabled)
+{
+    if (m_workerMode == enabled) return;
+
+    if (enabled) {
+        // Worker must be draining before the hook starts submitting
+        if (!m_worker->start()) {
+            qWarning() << "[InputHook] Failed to start input worker";
+            return;
+        }
+        m_workerMode = true;
+    } else {
+        // Stop submitting first, then drain and join
+        m_workerMode = false;
+        m_worker->stop();
+    }
+    qDebug() << "[InputHook] Worker mode:" << (enabled ? "ON" : "OFF");
+}
+
+bool InputHookManager::startRecording(const QString& path)
+{
+    if (m_recording) stopRecording();
+    
+    // Mapped mode only: no in-memory store beyond the minimum
+    auto recorder = std::make_unique<NeoZ::InputRecorder>(0);
+    if (!recorder->open(path)) return false;
+    m_recorder = std::move(recorder);
+    m_recording = true;
+    qDebug() << "[InputHook] Recording raw input to" << path;
+    return true;
+}
+
+bool InputHookManager::stopRecording()
+{
+    if (!m_recording) return false;
+    m_recording = false;
+    const bool ok = m_recorder->close();
+    m_recorder.reset();
+    return ok;
 }
 
 void InputHookManager::setMultipliers(double x, double y)
@@ -118,6 +162,17 @@ LRESULT CALLBACK InputHookManager::LowLevelMouseProc(int nCode, WPARAM wParam, L
             return CallNextHookEx(NULL, nCode, wParam, lParam);
         }
         
+        if (g_hookInstance->m_recording) {
+            g_hookInstance->m_recorder->append(NeoZ::InputWorker::nowNs(), deltaX, deltaY);
+        }
+        
+        // Worker mode: enqueue and return immediately. On a full ring the
+        // event simply passes through unmodified.
+        if (g_hookInstance->m_workerMode) {
+            g_hookInstance->m_worker->submit(deltaX, deltaY);
+            return CallNextHookEx(NULL, nCode, wParam, lParam);
+        }
+        
         // Prepare input state for pipeline
         NeoZ::InputState rawInput = NeoZ::InputState::fromRawDelta(
             static_cast<double>(deltaX),
@@ -134,18 +189,23 @@ LRESULT CALLBACK InputHookManager::LowLevelMouseProc(int nCode, WPARAM wParam, L
         int extraY = static_cast<int>(std::round(processed.deltaY)) - deltaY;
         
         if (extraX != 0 || extraY != 0) {
-            INPUT input = {};
-            input.type = INPUT_MOUSE;
-            input.mi.dx = extraX;
-            input.mi.dy = extraY;
-            input.mi.dwFlags = MOUSEEVENTF_MOVE;
-            SendInput(1, &input, sizeof(INPUT));
+            injectMovement(extraX, extraY);
         }
     }
 
     return CallNextHookEx(NULL, nCode, wParam, lParam);
 }
 
+void InputHookManager::injectMovement(int dx, int dy)
+{
+    INPUT input = {};
+    input.type = INPUT_MOUSE;
+    input.mi.dx = dx;
+    input.mi.dy = dy;
+    input.mi.dwFlags = MOUSEEVENTF_MOVE;
+    SendInput(1, &input, sizeof(INPUT));
+}
+
 #else
 
 // Stub implementations for non-Windows platforms
@@ -159,4 +219,10 @@ void InputHookManager::stopHook()
     qDebug() << "[InputHook] No hook to stop on this platform";
 }
 
+void InputHookManager::injectMovement(int dx, int dy)
+{
+    Q_UNUSED(dx)
+    Q_UNUSED(dy)
+}
+
 #endif
\ No newline at end of file
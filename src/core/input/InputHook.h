@@ -2,7 +2,10 @@
 #define INPUTHOOKMANAGER_H
 
 #include <QObject>
+#include <memory>
 #include "../sensitivity/SensitivityPipeline.h"
+#include "InputWorker.h"
+#include "InputRecording.h"
 
 // Include Windows headers AFTER Qt/STL to avoid template conflicts
 #ifdef Q_OS_WIN
@@ -28,6 +31,19 @@ public:
     void setSmoothingMs(double ms);
     void setVelocityCurve(double lowThresh, double highThresh, double lowMult, double highMult);
 
+    // Worker mode: the hook only enqueues raw deltas; a dedicated
+    // high-priority thread runs the pipeline and injects corrections
+    void setWorkerMode(bool enabled);
+    bool workerMode() const { return m_workerMode; }
+    NeoZ::InputWorker* worker() const { return m_worker.get(); }
+    
+    // Raw stream capture (.nzir) for offline replay, written straight into
+    // a memory-mapped file (readable up to the last event after a crash).
+    // The recorder exists only between startRecording() and stopRecording()
+    bool startRecording(const QString& path);
+    bool stopRecording();
+    bool isRecording() const { return m_recording; }
+
 signals:
     void mouseEventDetected(int dx, int dy); // For analytics UI
 
@@ -43,7 +59,15 @@ private:
     void* m_hook = nullptr;
 #endif
 
+    // Inject extra relative movement (SendInput on Windows)
+    static void injectMovement(int dx, int dy);
+
     NeoZ::SensitivityPipeline* m_pipeline = nullptr;
+    std::unique_ptr<NeoZ::InputWorker> m_worker;
+    bool m_workerMode = false;
+    
+    std::unique_ptr<NeoZ::InputRecorder> m_recorder;   // Only while recording
+    bool m_recording = false;
     
     // Position tracking for delta calculation
     int m_lastX = 0;
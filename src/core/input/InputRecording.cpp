@@ -0,0 +1,323 @@
+#include "InputRecording.h"
+#include <QDebug>
+#include <QSaveFile>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace NeoZ {
+
+namespace {
+
+inline uint8_t* putVarint(uint8_t* out, uint64_t value)
+{
+    while (value >= 0x80) {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+inline bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+inline uint64_t zigzag(int64_t v)
+{
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t v)
+{
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+template <typename T>
+inline void storeLE(uint8_t* dst, T value)
+{
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        dst[i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i));
+    }
+}
+
+template <typename T>
+inline T loadLE(const uint8_t* src)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        v |= static_cast<uint64_t>(src[i]) << (8 * i);
+    }
+    return static_cast<T>(v);
+}
+
+inline int64_t toNs(std::chrono::steady_clock::time_point t)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+} // namespace
+
+// ========== RECORDER ==========
+
+InputRecorder::InputRecorder(size_t capacityBytes)
+{
+    // Sized (not reserved) so every page is touched before recording starts
+    m_buffer.resize(std::max(capacityBytes, InputRecordingFormat::HEADER_SIZE + MAX_EVENT_BYTES));
+    m_data = m_buffer.data();
+    m_capacity = m_buffer.size();
+    clear();
+}
+
+InputRecorder::~InputRecorder()
+{
+    close();
+}
+
+bool InputRecorder::open(const QString& path, size_t capacityBytes)
+{
+    close();
+    capacityBytes = std::max(capacityBytes, InputRecordingFormat::HEADER_SIZE + MAX_EVENT_BYTES);
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)
+        || !m_file.resize(static_cast<qint64>(capacityBytes))) {
+        qWarning() << "[InputRecorder] Cannot create" << path << ":" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+    uchar* data = m_file.map(0, static_cast<qint64>(capacityBytes));
+    if (!data) {
+        qWarning() << "[InputRecorder] Cannot map" << path << ":" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    m_data = data;
+    m_capacity = capacityBytes;
+    clear();
+    qDebug() << "[InputRecorder] Recording to" << path << "(" << capacityBytes << "bytes mapped)";
+    return true;
+}
+
+bool InputRecorder::close()
+{
+    if (!m_file.isOpen()) return true;
+
+    writeHeader();
+    const uint64_t events = m_eventCount;
+    m_file.unmap(m_data);
+    const bool ok = m_file.resize(static_cast<qint64>(m_size));
+    m_file.close();
+    qDebug() << "[InputRecorder] Saved" << events << "events (" << m_size << "bytes, dropped"
+             << m_dropped << ") to" << m_file.fileName();
+
+    m_data = m_buffer.data();
+    m_capacity = m_buffer.size();
+    clear();
+    return ok;
+}
+
+void InputRecorder::clear()
+{
+    m_size = InputRecordingFormat::HEADER_SIZE;
+    m_eventCount = 0;
+    m_dropped = 0;
+    m_firstTimestampNs = 0;
+    m_lastTimestampNs = 0;
+    writeHeader();
+}
+
+void InputRecorder::writeHeader()
+{
+    uint8_t* h = m_data;
+    std::memcpy(h, InputRecordingFormat::MAGIC, 4);
+    storeLE<uint16_t>(h + 4, InputRecordingFormat::VERSION);
+    storeLE<uint16_t>(h + 6, 0);
+    storeLE<uint32_t>(h + 8, 0);
+    storeLE<int64_t>(h + 12, m_firstTimestampNs);
+    storeLE<uint64_t>(h + 20, m_eventCount);
+    storeLE<uint32_t>(h + 28, 0);
+}
+
+void InputRecorder::append(const InputState& raw)
+{
+    append(toNs(raw.timestamp),
+           static_cast<int32_t>(std::lround(raw.deltaX)),
+           static_cast<int32_t>(std::lround(raw.deltaY)));
+}
+
+void InputRecorder::append(int64_t timestampNs, int32_t dx, int32_t dy)
+{
+    // Full: drop rather than grow (never allocates on the hook thread)
+    if (m_capacity - m_size < MAX_EVENT_BYTES) {
+        ++m_dropped;
+        return;
+    }
+
+    if (m_eventCount == 0) {
+        m_firstTimestampNs = timestampNs;
+        m_lastTimestampNs = timestampNs;
+        storeLE<int64_t>(m_data + 12, m_firstTimestampNs);
+    }
+    // Clamp out-of-order stamps so Δt stays unsigned
+    int64_t dt = std::max<int64_t>(0, timestampNs - m_lastTimestampNs);
+    m_lastTimestampNs += dt;
+
+    uint8_t* out = m_data + m_size;
+    out = putVarint(out, static_cast<uint64_t>(dt));
+    out = putVarint(out, zigzag(dx));
+    out = putVarint(out, zigzag(dy));
+    m_size = static_cast<size_t>(out - m_data);
+    ++m_eventCount;
+
+    // Count last, so a reader of a crashed mapping never sees a partial event
+    storeLE<uint64_t>(m_data + 20, m_eventCount);
+}
+
+std::vector<uint8_t> InputRecorder::bytes() const
+{
+    return std::vector<uint8_t>(m_data, m_data + m_size);
+}
+
+bool InputRecorder::save(const QString& path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "[InputRecorder] Cannot open" << path << ":" << file.errorString();
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(m_data), static_cast<qint64>(m_size));
+    if (!file.commit()) {
+        qWarning() << "[InputRecorder] Write failed:" << file.errorString();
+        return false;
+    }
+    qDebug() << "[InputRecorder] Saved" << m_eventCount << "events (" << m_size << "bytes) to" << path;
+    return true;
+}
+
+// ========== RECORDING (READER) ==========
+
+InputRecording::~InputRecording()
+{
+    close();
+}
+
+void InputRecording::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();  // Also unmaps
+    }
+    m_ownedBytes.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_eventCount = 0;
+    m_firstTimestampNs = 0;
+}
+
+bool InputRecording::open(const QString& path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    qint64 size = m_file.size();
+    const uint8_t* data = size > 0 ? m_file.map(0, size) : nullptr;
+    if (!data) {
+        m_error = QStringLiteral("Cannot map file");
+        m_file.close();
+        return false;
+    }
+    if (!parseHeader(data, size)) {
+        m_file.close();
+        return false;
+    }
+    m_data = data;
+    m_size = size;
+    return true;
+}
+
+bool InputRecording::fromBytes(std::vector<uint8_t> bytes)
+{
+    close();
+    m_ownedBytes = std::move(bytes);
+    if (!parseHeader(m_ownedBytes.data(), static_cast<qint64>(m_ownedBytes.size()))) {
+        m_ownedBytes.clear();
+        return false;
+    }
+    m_data = m_ownedBytes.data();
+    m_size = static_cast<qint64>(m_ownedBytes.size());
+    return true;
+}
+
+bool InputRecording::parseHeader(const uint8_t* data, qint64 size)
+{
+    if (size < static_cast<qint64>(InputRecordingFormat::HEADER_SIZE)
+        || std::memcmp(data, InputRecordingFormat::MAGIC, 4) != 0) {
+        m_error = QStringLiteral("Not an input recording");
+        return false;
+    }
+    if (loadLE<uint16_t>(data + 4) != InputRecordingFormat::VERSION) {
+        m_error = QStringLiteral("Unsupported recording version");
+        return false;
+    }
+    m_firstTimestampNs = loadLE<int64_t>(data + 12);
+    m_eventCount = loadLE<uint64_t>(data + 20);
+    m_error.clear();
+    return true;
+}
+
+InputRecording::Cursor InputRecording::cursor() const
+{
+    Cursor c;
+    if (!m_data) return c;
+    c.m_ptr = m_data + InputRecordingFormat::HEADER_SIZE;
+    c.m_end = m_data + m_size;
+    c.m_timestampNs = m_firstTimestampNs;
+    c.m_count = m_eventCount;
+    return c;
+}
+
+bool InputRecording::Cursor::next(InputState& out)
+{
+    if (m_index >= m_count) return false;
+
+    uint64_t dt, zx, zy;
+    if (!getVarint(m_ptr, m_end, dt) || !getVarint(m_ptr, m_end, zx) || !getVarint(m_ptr, m_end, zy)) {
+        m_count = m_index;  // Truncated stream: stop here
+        return false;
+    }
+
+    m_timestampNs += static_cast<int64_t>(dt);
+    out.deltaX = static_cast<double>(unzigzag(zx));
+    out.deltaY = static_cast<double>(unzigzag(zy));
+    out.velocity = std::sqrt(out.deltaX * out.deltaX + out.deltaY * out.deltaY);
+    out.timestamp = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(m_timestampNs));
+    out.stage = InputState::Raw;
+    ++m_index;
+    return true;
+}
+
+std::vector<InputState> InputRecording::decodeAll() const
+{
+    std::vector<InputState> events;
+    events.reserve(static_cast<size_t>(m_eventCount));
+    Cursor c = cursor();
+    InputState state;
+    while (c.next(state)) {
+        events.push_back(state);
+    }
+    return events;
+}
+
+} // namespace NeoZ
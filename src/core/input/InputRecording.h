@@ -0,0 +1,158 @@
+#ifndef NEOZ_INPUTRECORDING_H
+#define NEOZ_INPUTRECORDING_H
+
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <vector>
+#include "InputState.h"
+
+namespace NeoZ {
+
+/**
+ * @brief Compact binary format for raw mouse streams (.nzir).
+ *
+ * Layout (little-endian):
+ *   Header (32 bytes)
+ *     char[4]  magic "NZIR"
+ *     uint16   version (1)
+ *     uint16   flags (0)
+ *     uint32   reserved
+ *     int64    first timestamp (steady_clock ns)
+ *     uint64   event count
+ *     uint32   reserved
+ *   Events, back to back:
+ *     varint   Δt ns since previous event (0 for the first)
+ *     varint   zigzag(dx)
+ *     varint   zigzag(dy)
+ *
+ * Raw hook deltas are integral counts; non-integral values are rounded.
+ * A typical 1 kHz event costs 5 bytes.
+ */
+namespace InputRecordingFormat {
+    constexpr char MAGIC[4] = {'N', 'Z', 'I', 'R'};
+    constexpr uint16_t VERSION = 1;
+    constexpr size_t HEADER_SIZE = 32;
+}
+
+/**
+ * @brief Appends raw InputState events to a fixed-capacity .nzir stream.
+ *
+ * The backing store is allocated up front and never grows: either an
+ * in-memory buffer (written out by save()) or, after open(), a
+ * memory-mapped file that append() encodes into directly. append() does
+ * no allocation or I/O, so it is safe on the hook thread. When the store
+ * is full further events are dropped and counted.
+ *
+ * The header's event count is kept current on every append, so a mapped
+ * recording left behind by a crash is readable up to the last event.
+ */
+class InputRecorder
+{
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 20;          // ~200k events
+    static constexpr size_t DEFAULT_FILE_CAPACITY = 64u << 20;   // ~13M events
+    static constexpr size_t MAX_EVENT_BYTES = 20;                // 3 varints, worst case
+
+    explicit InputRecorder(size_t capacityBytes = DEFAULT_CAPACITY);
+    ~InputRecorder();
+
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    // Record straight into a memory-mapped file of capacityBytes. close()
+    // trims it to the recorded size and returns to the in-memory buffer.
+    bool open(const QString& path, size_t capacityBytes = DEFAULT_FILE_CAPACITY);
+    bool close();
+    bool isMapped() const { return m_file.isOpen(); }
+
+    void clear();
+    void append(const InputState& raw);
+    void append(int64_t timestampNs, int32_t dx, int32_t dy);
+
+    uint64_t eventCount() const { return m_eventCount; }
+    uint64_t droppedCount() const { return m_dropped; }
+    size_t byteSize() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+
+    // Header + events, ready to write
+    std::vector<uint8_t> bytes() const;
+    bool save(const QString& path) const;
+
+private:
+    void writeHeader();
+
+    std::vector<uint8_t> m_buffer;   // In-memory store (fixed size)
+    QFile m_file;                    // Mapped store while open
+    uint8_t* m_data = nullptr;       // Active store
+    size_t m_capacity = 0;
+    size_t m_size = 0;
+    uint64_t m_eventCount = 0;
+    uint64_t m_dropped = 0;
+    int64_t m_firstTimestampNs = 0;
+    int64_t m_lastTimestampNs = 0;
+};
+
+/**
+ * @brief Read-only view of a .nzir recording.
+ *
+ * open() memory-maps the file; decoding walks the mapping directly with
+ * no per-event allocation. fromBytes() wraps an in-memory stream instead.
+ */
+class InputRecording
+{
+public:
+    InputRecording() = default;
+    ~InputRecording();
+
+    InputRecording(const InputRecording&) = delete;
+    InputRecording& operator=(const InputRecording&) = delete;
+
+    bool open(const QString& path);
+    bool fromBytes(std::vector<uint8_t> bytes);
+    void close();
+
+    bool isValid() const { return m_data != nullptr; }
+    uint64_t eventCount() const { return m_eventCount; }
+    int64_t firstTimestampNs() const { return m_firstTimestampNs; }
+    QString errorString() const { return m_error; }
+
+    /**
+     * @brief Sequential decoder over the event stream.
+     */
+    class Cursor
+    {
+    public:
+        // Decode the next event; false at end of stream or on corruption
+        bool next(InputState& out);
+        uint64_t position() const { return m_index; }
+
+    private:
+        friend class InputRecording;
+        const uint8_t* m_ptr = nullptr;
+        const uint8_t* m_end = nullptr;
+        int64_t m_timestampNs = 0;
+        uint64_t m_index = 0;
+        uint64_t m_count = 0;
+    };
+
+    Cursor cursor() const;
+
+    // Decode everything (convenience for tests and small recordings)
+    std::vector<InputState> decodeAll() const;
+
+private:
+    bool parseHeader(const uint8_t* data, qint64 size);
+
+    QFile m_file;
+    std::vector<uint8_t> m_ownedBytes;
+    const uint8_t* m_data = nullptr;
+    qint64 m_size = 0;
+    uint64_t m_eventCount = 0;
+    int64_t m_firstTimestampNs = 0;
+    QString m_error;
+};
+
+} // namespace NeoZ
+
+#endif // NEOZ_INPUTRECORDING_H
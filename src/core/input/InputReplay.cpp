@@ -0,0 +1,67 @@
+#include "InputReplay.h"
+#include "InputRecording.h"
+#include "../sensitivity/SensitivityPipeline.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <bit>
+
+namespace NeoZ {
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+inline uint64_t fnvMix(uint64_t hash, double value)
+{
+    uint64_t bits = std::bit_cast<uint64_t>(value);
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (bits >> (8 * i)) & 0xFF;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+} // namespace
+
+InputReplay::Result InputReplay::run(const InputRecording& recording, SensitivityPipeline& pipeline,
+                                     std::vector<InputState>* outputs)
+{
+    Result result;
+    result.outputHash = FNV_OFFSET;
+    if (!recording.isValid()) return result;
+
+    // Recorded events carry their own timestamps; restart the event clock
+    // so the first one sees Δt = 0 regardless of earlier use
+    pipeline.clock().reset();
+
+    if (outputs) {
+        outputs->clear();
+        outputs->reserve(static_cast<size_t>(recording.eventCount()));
+    }
+
+    InputRecording::Cursor cursor = recording.cursor();
+    InputState raw;
+    QElapsedTimer timer;
+    timer.start();
+
+    while (cursor.next(raw)) {
+        InputState processed = pipeline.process(raw);
+        result.sumX += processed.deltaX;
+        result.sumY += processed.deltaY;
+        result.outputHash = fnvMix(fnvMix(result.outputHash, processed.deltaX), processed.deltaY);
+        if (outputs) outputs->push_back(processed);
+    }
+
+    result.elapsedNs = timer.nsecsElapsed();
+    result.events = cursor.position();
+    if (result.elapsedNs > 0) {
+        result.eventsPerSecond = static_cast<double>(result.events) * 1e9 / static_cast<double>(result.elapsedNs);
+    }
+
+    qDebug() << "[InputReplay] Replayed" << result.events << "events in"
+             << result.elapsedNs / 1e6 << "ms (" << result.eventsPerSecond << "events/s)";
+    return result;
+}
+
+} // namespace NeoZ
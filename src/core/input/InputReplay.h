@@ -0,0 +1,41 @@
+#ifndef NEOZ_INPUTREPLAY_H
+#define NEOZ_INPUTREPLAY_H
+
+#include <cstdint>
+#include <vector>
+#include "InputState.h"
+
+namespace NeoZ {
+
+class InputRecording;
+class SensitivityPipeline;
+
+/**
+ * @brief Offline replay driver for .nzir recordings.
+ *
+ * Feeds every recorded event through SensitivityPipeline::process(). The
+ * pipeline clock takes Δt from the recorded timestamps, so two runs over
+ * the same recording and settings produce identical output.
+ * Start from a freshly constructed (or reset) pipeline for reproducible
+ * filter state.
+ */
+class InputReplay
+{
+public:
+    struct Result {
+        uint64_t events = 0;
+        int64_t elapsedNs = 0;
+        double eventsPerSecond = 0.0;
+        uint64_t outputHash = 0;   // FNV-1a over output delta bit patterns
+        double sumX = 0.0;         // Total processed movement
+        double sumY = 0.0;
+    };
+
+    // outputs (optional) receives every processed state in order
+    static Result run(const InputRecording& recording, SensitivityPipeline& pipeline,
+                      std::vector<InputState>* outputs = nullptr);
+};
+
+} // namespace NeoZ
+
+#endif // NEOZ_INPUTREPLAY_H
@@ -0,0 +1,210 @@
+#include "InputWorker.h"
+#include "../sensitivity/SensitivityPipeline.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <span>
+#include <vector>
+
+#ifdef Q_OS_WIN
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(Q_OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace NeoZ {
+
+namespace {
+// Busy-poll this many times before parking (covers 1-8 kHz event gaps)
+constexpr int SPIN_ITERATIONS = 4000;
+}
+
+InputWorker::InputWorker(SensitivityPipeline* pipeline, Injector injector)
+    : m_pipeline(pipeline)
+    , m_injector(std::move(injector))
+{
+}
+
+InputWorker::~InputWorker()
+{
+    stop();
+}
+
+int64_t InputWorker::nowNs() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool InputWorker::start(int cpuCore)
+{
+    if (m_running.load(std::memory_order_acquire) || !m_pipeline) return false;
+
+    if (cpuCore < 0) {
+        unsigned cores = std::thread::hardware_concurrency();
+        cpuCore = cores > 1 ? static_cast<int>(cores) - 1 : 0;
+    }
+
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&InputWorker::run, this, cpuCore);
+    qDebug() << "[InputWorker] Started on core" << cpuCore;
+    return true;
+}
+
+void InputWorker::stop()
+{
+    if (!m_running.exchange(false, std::memory_order_acq_rel)) return;
+
+    m_signal.fetch_add(1, std::memory_order_seq_cst);
+    m_signal.notify_one();
+    if (m_thread.joinable()) m_thread.join();
+    qDebug() << "[InputWorker] Stopped | Processed:" << m_processed.load()
+             << "Dropped:" << m_dropped.load();
+}
+
+bool InputWorker::submit(int dx, int dy) noexcept
+{
+    RawDelta delta{dx, dy, nowNs()};
+    if (!m_ring.tryPush(delta)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_signal.fetch_add(1, std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_seq_cst)) {
+        m_signal.notify_one();
+    }
+    return true;
+}
+
+void InputWorker::configureCurrentThread(int cpuCore)
+{
+#ifdef Q_OS_WIN
+    if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL)) {
+        qWarning() << "[InputWorker] SetThreadPriority failed:" << GetLastError();
+    }
+    if (cpuCore < 64 && !SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpuCore)) {
+        qWarning() << "[InputWorker] SetThreadAffinityMask failed:" << GetLastError();
+    }
+#elif defined(Q_OS_LINUX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpuCore, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        qWarning() << "[InputWorker] Could not pin to core" << cpuCore;
+    }
+#else
+    Q_UNUSED(cpuCore)
+#endif
+}
+
+void InputWorker::waitForWork()
+{
+    for (int i = 0; i < SPIN_ITERATIONS; ++i) {
+        if (!m_ring.empty() || !m_running.load(std::memory_order_relaxed)) return;
+        if ((i & 63) == 63) std::this_thread::yield();
+    }
+
+    // Announce sleep, then re-check so a concurrent submit() is never missed
+    m_sleeping.store(true, std::memory_order_seq_cst);
+    uint32_t seen = m_signal.load(std::memory_order_seq_cst);
+    if (m_ring.empty() && m_running.load(std::memory_order_seq_cst)) {
+        m_signal.wait(seen, std::memory_order_seq_cst);
+    }
+    m_sleeping.store(false, std::memory_order_relaxed);
+}
+
+void InputWorker::run(int cpuCore)
+{
+    configureCurrentThread(cpuCore);
+
+    std::array<RawDelta, MAX_BATCH> raw;
+    std::vector<InputState> inputs(MAX_BATCH);
+    std::vector<InputState> outputs(MAX_BATCH);
+
+    while (true) {
+        size_t n = m_ring.popBulk(raw.data(), MAX_BATCH);
+        if (n == 0) {
+            if (!m_running.load(std::memory_order_acquire)) break;
+            waitForWork();
+            continue;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            InputState& in = inputs[i];
+            in.deltaX = raw[i].dx;
+            in.deltaY = raw[i].dy;
+            in.velocity = std::sqrt(in.deltaX * in.deltaX + in.deltaY * in.deltaY);
+            in.timestamp = std::chrono::steady_clock::time_point(
+                std::chrono::nanoseconds(raw[i].timestampNs));
+            in.stage = InputState::Raw;
+        }
+
+        m_pipeline->processBatch(std::span<const InputState>(inputs.data(), n),
+                                 std::span<InputState>(outputs.data(), n));
+
+        // The pipeline returns the DESIRED total movement; the physical
+        // movement already went through, so only the difference is injected
+        int extraX = 0;
+        int extraY = 0;
+        for (size_t i = 0; i < n; ++i) {
+            extraX += static_cast<int>(std::round(outputs[i].deltaX)) - raw[i].dx;
+            extraY += static_cast<int>(std::round(outputs[i].deltaY)) - raw[i].dy;
+        }
+        if ((extraX != 0 || extraY != 0) && m_injector) {
+            m_injector(extraX, extraY);
+        }
+
+        const int64_t done = nowNs();
+        for (size_t i = 0; i < n; ++i) {
+            recordLatency(done - raw[i].timestampNs);
+        }
+        m_processed.fetch_add(n, std::memory_order_relaxed);
+    }
+}
+
+void InputWorker::recordLatency(int64_t ns) noexcept
+{
+    uint32_t clamped = static_cast<uint32_t>(std::clamp<int64_t>(ns, 0, UINT32_MAX));
+    uint64_t idx = m_latencyHead.fetch_add(1, std::memory_order_relaxed) % LATENCY_WINDOW;
+    m_latencyNs[idx].store(clamped, std::memory_order_relaxed);
+}
+
+InputWorkerStats InputWorker::stats() const
+{
+    InputWorkerStats s;
+    s.queueDepth = m_ring.size();
+    s.processed = m_processed.load(std::memory_order_relaxed);
+    s.dropped = m_dropped.load(std::memory_order_relaxed);
+
+    size_t count = static_cast<size_t>(
+        std::min<uint64_t>(m_latencyHead.load(std::memory_order_relaxed), LATENCY_WINDOW));
+    if (count == 0) return s;
+
+    std::vector<uint32_t> samples(count);
+    for (size_t i = 0; i < count; ++i) {
+        samples[i] = m_latencyNs[i].load(std::memory_order_relaxed);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    auto percentileUs = [&](double p) {
+        size_t idx = std::min(count - 1, static_cast<size_t>(p * static_cast<double>(count)));
+        return samples[idx] / 1000.0;
+    };
+    s.latencyP50Us = percentileUs(0.50);
+    s.latencyP99Us = percentileUs(0.99);
+    s.latencyP999Us = percentileUs(0.999);
+    return s;
+}
+
+void InputWorker::resetStats()
+{
+    m_processed.store(0, std::memory_order_relaxed);
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_latencyHead.store(0, std::memory_order_relaxed);
+}
+
+} // namespace NeoZ
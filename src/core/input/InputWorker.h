@@ -0,0 +1,106 @@
+#ifndef NEOZ_INPUTWORKER_H
+#define NEOZ_INPUTWORKER_H
+
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include "../perf/SpscRing.hpp"
+
+namespace NeoZ {
+
+class SensitivityPipeline;
+
+/**
+ * @brief Raw mouse delta as captured by the hook (16 bytes, ring element).
+ */
+struct RawDelta
+{
+    int32_t dx = 0;
+    int32_t dy = 0;
+    int64_t timestampNs = 0;  // steady_clock at capture
+};
+
+/**
+ * @brief Copyable worker statistics for the UI.
+ */
+struct InputWorkerStats
+{
+    size_t queueDepth = 0;
+    uint64_t processed = 0;
+    uint64_t dropped = 0;
+    double latencyP50Us = 0.0;   // Capture → injection
+    double latencyP99Us = 0.0;
+    double latencyP999Us = 0.0;
+};
+
+/**
+ * @brief Dedicated high-priority input processing thread.
+ *
+ * The OS hook callback only calls submit(), which pushes the raw delta
+ * into a lock-free SPSC ring and returns. A pinned, time-critical worker
+ * drains the ring in bulk, runs SensitivityPipeline::processBatch() and
+ * injects the correction through the supplied injector.
+ *
+ * If the ring is full the event is dropped (counted) and passes through
+ * unmodified, so the hook never blocks.
+ */
+class InputWorker
+{
+public:
+    // Receives the summed extra movement to inject for one drained batch
+    using Injector = std::function<void(int dx, int dy)>;
+
+    static constexpr size_t RING_CAPACITY = 4096;
+    static constexpr size_t MAX_BATCH = 256;
+    static constexpr size_t LATENCY_WINDOW = 2048;
+
+    InputWorker(SensitivityPipeline* pipeline, Injector injector);
+    ~InputWorker();
+
+    InputWorker(const InputWorker&) = delete;
+    InputWorker& operator=(const InputWorker&) = delete;
+
+    // Start the worker pinned to cpuCore (-1 = last logical core)
+    bool start(int cpuCore = -1);
+    void stop();
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    // Producer side (hook thread only). Never blocks.
+    bool submit(int dx, int dy) noexcept;
+
+    InputWorkerStats stats() const;
+    void resetStats();
+
+    static int64_t nowNs() noexcept;
+
+private:
+    void run(int cpuCore);
+    void waitForWork();
+    void recordLatency(int64_t ns) noexcept;
+    static void configureCurrentThread(int cpuCore);
+
+    SensitivityPipeline* m_pipeline;
+    Injector m_injector;
+
+    SpscRing<RawDelta, RING_CAPACITY> m_ring;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+
+    // Wake-up protocol: producer bumps m_signal and notifies only if the
+    // worker announced it is about to sleep
+    std::atomic<uint32_t> m_signal{0};
+    std::atomic<bool> m_sleeping{false};
+
+    // Stats (written by worker / producer, read by UI)
+    std::atomic<uint64_t> m_processed{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::array<std::atomic<uint32_t>, LATENCY_WINDOW> m_latencyNs{};
+    std::atomic<uint64_t> m_latencyHead{0};
+};
+
+} // namespace NeoZ
+
+#endif // NEOZ_INPUTWORKER_H
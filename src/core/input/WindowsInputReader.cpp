@@ -46,6 +46,8 @@ void WindowsInputReader::refresh()
              << "| System DPI:" << m_systemDpi;
 }
 
+#ifdef Q_OS_WIN
+
 int WindowsInputReader::readPointerSpeed()
 {
     int speed = 10; // Default
@@ -88,6 +90,15 @@ int WindowsInputReader::readSystemDpi()
     return dpi;
 }
 
+#else
+
+// Non-Windows builds (tests, benchmarks): report Windows defaults
+int WindowsInputReader::readPointerSpeed() { return 10; }
+bool WindowsInputReader::readEnhancePrecision() { return false; }
+int WindowsInputReader::readSystemDpi() { return 96; }
+
+#endif
+
 double WindowsInputReader::speedToMultiplier(int speed)
 {
     // Windows pointer speed 1-20 maps to multipliers:
@@ -2,7 +2,10 @@
 #define NEOZ_WINDOWSINPUTREADER_H
 
 #include <QObject>
+
+#ifdef Q_OS_WIN
 #include <windows.h>
+#endif
 
 namespace NeoZ {
 
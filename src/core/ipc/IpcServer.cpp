@@ -1,6 +1,6 @@
 #include "IpcServer.h"
 #include <QDebug>
-#include <QDataStream>
+#include <QJsonArray>
 
 namespace NeoZ {
 
@@ -52,6 +52,7 @@ void IpcServer::shutdown()
             client->deleteLater();
         }
         m_clients.clear();
+        m_clientFraming.clear();
         
         m_server->close();
         delete m_server;
@@ -82,6 +83,7 @@ void IpcServer::onNewConnection()
         QJsonObject welcome;
         welcome["type"] = "Welcome";
         welcome["version"] = "1.0";
+        welcome["framings"] = QJsonArray::fromStringList(MessageFraming::supportedModes());
         sendTo(clientId, welcome);
     }
 }
@@ -96,6 +98,7 @@ void IpcServer::onClientDisconnected()
         if (it.value() == client) {
             clientId = it.key();
             m_clients.erase(it);
+            m_clientFraming.remove(clientId);
             break;
         }
     }
@@ -120,32 +123,48 @@ void IpcServer::onReadyRead()
         }
     }
     
-    // Read all available data
-    while (client->bytesAvailable() > 0) {
-        QByteArray data = client->readLine();
-        if (!data.isEmpty()) {
-            processMessage(clientId, data);
+    // Read every complete frame (JSON line or CBOR)
+    for (;;) {
+        QJsonObject msg;
+        QString error;
+        auto result = MessageFraming::read(client, &msg, &error);
+        
+        if (result == MessageFraming::ReadResult::Incomplete) {
+            break;
+        } else if (result == MessageFraming::ReadResult::Message) {
+            processMessage(clientId, msg);
+        } else if (result == MessageFraming::ReadResult::Malformed) {
+            if (!error.isEmpty()) {
+                qWarning() << "[IpcServer] Invalid message from client" << clientId << ":" << error;
+            }
+        } else {
+            qWarning() << "[IpcServer] Corrupt stream from client" << clientId << ":" << error;
+            client->disconnectFromServer();
+            break;
         }
     }
 }
 
-void IpcServer::processMessage(qintptr clientId, const QByteArray& data)
+void IpcServer::processMessage(qintptr clientId, const QJsonObject& msg)
 {
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
-    
-    if (error.error != QJsonParseError::NoError) {
-        qWarning() << "[IpcServer] Invalid JSON from client" << clientId 
-                   << ":" << error.errorString();
-        return;
-    }
-    
-    QJsonObject msg = doc.object();
     QString type = msg["type"].toString();
     
     qDebug() << "[IpcServer] Received from" << clientId << ":" << type;
     emit messageReceived(clientId, msg);
     
+    // Framing negotiation: the reply still uses the old framing
+    if (type == "SetFraming") {
+        MessageFraming::Mode mode;
+        QJsonObject response;
+        response["success"] = MessageFraming::modeFromName(msg["framing"].toString(), &mode);
+        respond(clientId, msg, response);
+        if (response["success"].toBool()) {
+            m_clientFraming[clientId] = mode;
+            qDebug() << "[IpcServer] Client" << clientId << "framing:" << MessageFraming::modeName(mode);
+        }
+        return;
+    }
+    
     // Check for registered handler
     if (m_handlers.contains(type)) {
         QJsonObject response = m_handlers[type](msg);
@@ -157,13 +176,21 @@ void IpcServer::processMessage(qintptr clientId, const QByteArray& data)
 
 void IpcServer::broadcast(const QJsonObject& msg)
 {
-    QByteArray data = QJsonDocument(msg).toJson(QJsonDocument::Compact) + "\n";
+    // Encode once per framing in use
+    QByteArray json;
+    QByteArray cbor;
     
-    for (auto* client : m_clients) {
-        if (client->state() == QLocalSocket::ConnectedState) {
-            client->write(data);
-            client->flush();
+    for (auto it = m_clients.cbegin(); it != m_clients.cend(); ++it) {
+        QLocalSocket* client = it.value();
+        if (client->state() != QLocalSocket::ConnectedState) continue;
+        
+        auto mode = m_clientFraming.value(it.key(), MessageFraming::Mode::Json);
+        QByteArray& data = (mode == MessageFraming::Mode::Cbor) ? cbor : json;
+        if (data.isEmpty()) {
+            data = MessageFraming::encode(msg, mode);
         }
+        client->write(data);
+        client->flush();
     }
 }
 
@@ -176,8 +203,8 @@ void IpcServer::sendTo(qintptr clientId, const QJsonObject& msg)
     
     QLocalSocket* client = m_clients[clientId];
     if (client->state() == QLocalSocket::ConnectedState) {
-        QByteArray data = QJsonDocument(msg).toJson(QJsonDocument::Compact) + "\n";
-        client->write(data);
+        auto mode = m_clientFraming.value(clientId, MessageFraming::Mode::Json);
+        client->write(MessageFraming::encode(msg, mode));
         client->flush();
     }
 }
@@ -8,6 +8,7 @@
 #include <QJsonObject>
 #include <QHash>
 #include <functional>
+#include "MessageFraming.h"
 
 namespace NeoZ {
 
@@ -24,6 +25,9 @@ namespace NeoZ {
  * - Messages are JSON objects with "type" field
  * - Each message has optional "id" for correlation
  * - Server broadcasts events to all connected clients
+ * - Newline-delimited JSON by default; Welcome advertises "framings" and a
+ *   client may switch what it receives to length-prefixed CBOR with
+ *   SetFraming (see MessageFraming)
  */
 class IpcServer : public QObject
 {
@@ -99,10 +103,11 @@ private slots:
     void onReadyRead();
     
 private:
-    void processMessage(qintptr clientId, const QByteArray& data);
+    void processMessage(qintptr clientId, const QJsonObject& msg);
     
     QLocalServer* m_server = nullptr;
     QHash<qintptr, QLocalSocket*> m_clients;
+    QHash<qintptr, MessageFraming::Mode> m_clientFraming;   // Absent = JSON
     QHash<QString, MessageHandler> m_handlers;
     QString m_endpoint;
 };
@@ -0,0 +1,104 @@
+#include "MessageFraming.h"
+#include <QCborMap>
+#include <QCborValue>
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QtEndian>
+
+namespace NeoZ {
+
+QByteArray MessageFraming::encode(const QJsonObject& msg, Mode mode)
+{
+    if (mode == Mode::Json) {
+        return QJsonDocument(msg).toJson(QJsonDocument::Compact) + "\n";
+    }
+
+    const QByteArray payload = QCborValue(QCborMap::fromJsonObject(msg)).toCbor();
+
+    QByteArray frame;
+    frame.reserve(HEADER_SIZE + payload.size());
+    frame.append(BINARY_MARKER);
+    char length[4];
+    qToBigEndian(static_cast<quint32>(payload.size()), length);
+    frame.append(length, sizeof(length));
+    frame.append(payload);
+    return frame;
+}
+
+MessageFraming::ReadResult MessageFraming::read(QIODevice* device, QJsonObject* msg, QString* error)
+{
+    if (device->bytesAvailable() < 1) return ReadResult::Incomplete;
+
+    char first = 0;
+    device->peek(&first, 1);
+
+    if (first == BINARY_MARKER) {
+        if (device->bytesAvailable() < HEADER_SIZE) return ReadResult::Incomplete;
+
+        char header[HEADER_SIZE];
+        device->peek(header, HEADER_SIZE);
+        const quint32 length = qFromBigEndian<quint32>(header + 1);
+        if (length > MAX_FRAME_SIZE) {
+            if (error) *error = QString("frame too large (%1 bytes)").arg(length);
+            return ReadResult::Corrupt;
+        }
+        if (device->bytesAvailable() < HEADER_SIZE + static_cast<qint64>(length)) {
+            return ReadResult::Incomplete;
+        }
+
+        device->skip(HEADER_SIZE);
+        const QByteArray payload = device->read(length);
+
+        QCborParserError parseError;
+        const QCborValue value = QCborValue::fromCbor(payload, &parseError);
+        if (parseError.error != QCborError::NoError || !value.isMap()) {
+            if (error) *error = parseError.error != QCborError::NoError ? parseError.errorString()
+                                                                        : QString("CBOR frame is not a map");
+            return ReadResult::Malformed;
+        }
+        *msg = value.toMap().toJsonObject();
+        return ReadResult::Message;
+    }
+
+    if (!device->canReadLine()) return ReadResult::Incomplete;
+
+    const QByteArray line = device->readLine().trimmed();
+    if (line.isEmpty()) {
+        if (error) error->clear();
+        return ReadResult::Malformed;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        if (error) *error = parseError.errorString();
+        return ReadResult::Malformed;
+    }
+    *msg = doc.object();
+    return ReadResult::Message;
+}
+
+QString MessageFraming::modeName(Mode mode)
+{
+    return mode == Mode::Cbor ? "cbor" : "json";
+}
+
+bool MessageFraming::modeFromName(const QString& name, Mode* mode)
+{
+    if (name == "json") {
+        *mode = Mode::Json;
+        return true;
+    }
+    if (name == "cbor") {
+        *mode = Mode::Cbor;
+        return true;
+    }
+    return false;
+}
+
+QStringList MessageFraming::supportedModes()
+{
+    return {"json", "cbor"};
+}
+
+} // namespace NeoZ
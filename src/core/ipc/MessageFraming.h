@@ -0,0 +1,61 @@
+#ifndef NEOZ_MESSAGEFRAMING_H
+#define NEOZ_MESSAGEFRAMING_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+class QIODevice;
+
+namespace NeoZ {
+
+/**
+ * @brief Wire framing shared by IpcServer/IpcClient and AdbService.
+ *
+ * Two framings can be mixed on one stream:
+ * - Json: compact JSON object + '\n' (the original protocol, always
+ *   understood, so old peers keep working)
+ * - Cbor: 0xCB marker + big-endian uint32 length + CBOR map
+ *
+ * A JSON frame always starts with '{', so readers tell the two apart per
+ * frame and never need to know what the peer chose. Negotiation therefore
+ * only decides what a side sends: the server advertises "framings" (in
+ * Welcome / Pong) and a client opts in with
+ *   {"type": "SetFraming", "framing": "cbor"}
+ *
+ * CBOR skips text number formatting and parsing, and maps straight onto
+ * QJsonObject (both share QCborContainerPrivate in Qt 6).
+ */
+class MessageFraming
+{
+public:
+    enum class Mode {
+        Json,
+        Cbor
+    };
+
+    enum class ReadResult {
+        Message,      // *msg holds the next message
+        Incomplete,   // Wait for more bytes
+        Malformed,    // Bad frame skipped, stream still in sync
+        Corrupt       // Stream cannot be resynchronized; close it
+    };
+
+    static constexpr char BINARY_MARKER = static_cast<char>(0xCB);
+    static constexpr int HEADER_SIZE = 5;
+    static constexpr quint32 MAX_FRAME_SIZE = 16 * 1024 * 1024;
+
+    static QByteArray encode(const QJsonObject& msg, Mode mode);
+
+    // Consume at most one frame from the device (either framing)
+    static ReadResult read(QIODevice* device, QJsonObject* msg, QString* error = nullptr);
+
+    static QString modeName(Mode mode);
+    static bool modeFromName(const QString& name, Mode* mode);
+    static QStringList supportedModes();
+};
+
+} // namespace NeoZ
+
+#endif // NEOZ_MESSAGEFRAMING_H
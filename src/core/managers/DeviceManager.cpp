@@ -144,41 +144,40 @@ void DeviceManager::refreshEmulatorState()
 {
     if (!isConnected()) return;
     
-    // Batch fetch emulator state
-    auto result = m_connection->executeBatch({
-        "wm size",
-        "wm density",
-        "pidof com.dts.freefireth"
-    });
-    
-    if (result.success && result.results.size() >= 3) {
-        // Parse screen size
-        QString sizeStr = result.results[0];
+    // Through the connection's cache, shared with every other poller of this device
+    m_connection->getCachedAsync(AdbConnection::SCREEN_SIZE_COMMAND, AdbConnection::DISPLAY_TTL_MS,
+                                 [this](const QString& sizeStr, bool ok) {
         static QRegularExpression sizeRx("(\\d+)x(\\d+)");
         auto match = sizeRx.match(sizeStr);
-        if (match.hasMatch()) {
+        if (ok && match.hasMatch()) {
             m_mobileRes = match.captured(1) + "x" + match.captured(2);
+            emit emulatorStateChanged();
         }
-        
-        // Parse density
-        QString densityStr = result.results[1];
+    });
+    
+    m_connection->getCachedAsync(AdbConnection::DENSITY_COMMAND, AdbConnection::DISPLAY_TTL_MS,
+                                 [this](const QString& densityStr, bool ok) {
         static QRegularExpression densityRx("(\\d+)");
-        match = densityRx.match(densityStr);
-        if (match.hasMatch()) {
+        auto match = densityRx.match(densityStr);
+        if (ok && match.hasMatch()) {
             m_mobileDpi = match.captured(1);
+            emit emulatorStateChanged();
         }
-        
-        // Free Fire PID
-        m_processId = result.results[2].trimmed();
+    });
+    
+    // Free Fire PID
+    m_connection->getCachedAsync(AdbConnection::FREEFIRE_PID_COMMAND, AdbConnection::PID_TTL_MS,
+                                 [this](const QString& pid, bool ok) {
+        if (!ok) return;
+        m_processId = pid;
         bool wasRunning = m_freeFireRunning;
         m_freeFireRunning = !m_processId.isEmpty();
         
         if (m_freeFireRunning != wasRunning) {
             emit freeFireStateChanged(m_freeFireRunning);
         }
-        
         emit emulatorStateChanged();
-    }
+    });
 }
 
 void DeviceManager::onScanComplete()
@@ -195,14 +194,17 @@ void DeviceManager::checkFreeFireState()
 {
     if (!isConnected()) return;
     
-    // Quick cached check
-    bool running = m_connection->isFreeFireRunning();
-    
-    if (running != m_freeFireRunning) {
-        m_freeFireRunning = running;
-        emit emulatorStateChanged();
-        emit freeFireStateChanged(running);
-    }
+    // Quick cached check; a miss doesn't block the GUI thread
+    m_connection->getCachedAsync(AdbConnection::FREEFIRE_PID_COMMAND, AdbConnection::PID_TTL_MS,
+                                 [this](const QString& pid, bool ok) {
+        bool running = ok && !pid.isEmpty();
+        
+        if (running != m_freeFireRunning) {
+            m_freeFireRunning = running;
+            emit emulatorStateChanged();
+            emit freeFireStateChanged(running);
+        }
+    });
 }
 
 } // namespace NeoZ
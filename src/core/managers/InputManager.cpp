@@ -12,6 +12,9 @@ InputManager::InputManager(QObject* parent)
         connect(pipe, &SensitivityPipeline::inputProcessed, 
                 this, &InputManager::onInputProcessed, Qt::UniqueConnection);
     }
+    
+    m_workerStatsTimer.setInterval(WORKER_STATS_INTERVAL_MS);
+    connect(&m_workerStatsTimer, &QTimer::timeout, this, &InputManager::refreshWorkerStats);
 }
 
 InputManager::~InputManager()
@@ -104,6 +107,36 @@ void InputManager::setMouseDpi(int dpi)
     }
 }
 
+bool InputManager::workerThreadEnabled() const
+{
+    return InputHookManager::instance().workerMode();
+}
+
+void InputManager::setWorkerThreadEnabled(bool enabled)
+{
+    auto& hookManager = InputHookManager::instance();
+    if (hookManager.workerMode() == enabled) return;
+    
+    hookManager.setWorkerMode(enabled);
+    if (hookManager.workerMode() != enabled) return;  // Start failed
+    
+    if (enabled) {
+        m_workerStatsTimer.start();
+    } else {
+        m_workerStatsTimer.stop();
+    }
+    refreshWorkerStats();
+    emit workerThreadEnabledChanged();
+}
+
+void InputManager::refreshWorkerStats()
+{
+    if (auto* worker = InputHookManager::instance().worker()) {
+        m_workerStats = worker->stats();
+        emit workerStatsChanged();
+    }
+}
+
 void InputManager::onInputProcessed(const InputState& input)
 {
     // Update telemetry
@@ -2,6 +2,7 @@
 #define NEOZ_INPUTMANAGER_H
 
 #include <QObject>
+#include <QTimer>
 #include "../input/InputHook.h"
 #include "../sensitivity/SensitivityPipeline.h"
 #include "../perf/FastConf.hpp"
@@ -15,6 +16,7 @@ namespace NeoZ {
  * - Input hook lifecycle (start/stop)
  * - Input pipeline configuration
  * - Telemetry tracking (velocity, angle, latency)
+ * - Dedicated input worker thread toggle and its queue/latency stats
  */
 class InputManager : public QObject
 {
@@ -26,6 +28,14 @@ class InputManager : public QObject
     Q_PROPERTY(double mouseAngleDegrees READ mouseAngleDegrees NOTIFY telemetryChanged)
     Q_PROPERTY(double latencyMs READ latencyMs NOTIFY telemetryChanged)
     
+    // Input worker thread
+    Q_PROPERTY(bool workerThreadEnabled READ workerThreadEnabled WRITE setWorkerThreadEnabled NOTIFY workerThreadEnabledChanged)
+    Q_PROPERTY(int queueDepth READ queueDepth NOTIFY workerStatsChanged)
+    Q_PROPERTY(qint64 droppedEvents READ droppedEvents NOTIFY workerStatsChanged)
+    Q_PROPERTY(double latencyP50Us READ latencyP50Us NOTIFY workerStatsChanged)
+    Q_PROPERTY(double latencyP99Us READ latencyP99Us NOTIFY workerStatsChanged)
+    Q_PROPERTY(double latencyP999Us READ latencyP999Us NOTIFY workerStatsChanged)
+    
 public:
     explicit InputManager(QObject* parent = nullptr);
     ~InputManager();
@@ -45,6 +55,15 @@ public:
     double mouseAngleDegrees() const { return m_mouseAngleDegrees; }
     double latencyMs() const { return m_latencyMs; }
     
+    // Input worker thread
+    bool workerThreadEnabled() const;
+    void setWorkerThreadEnabled(bool enabled);
+    int queueDepth() const { return static_cast<int>(m_workerStats.queueDepth); }
+    qint64 droppedEvents() const { return static_cast<qint64>(m_workerStats.dropped); }
+    double latencyP50Us() const { return m_workerStats.latencyP50Us; }
+    double latencyP99Us() const { return m_workerStats.latencyP99Us; }
+    double latencyP999Us() const { return m_workerStats.latencyP999Us; }
+    
     // Configuration
     void setAxisMultiplierX(double value);
     void setAxisMultiplierY(double value);
@@ -55,10 +74,13 @@ signals:
     void hookStateChanged();
     void statusChanged();
     void telemetryChanged();
+    void workerThreadEnabledChanged();
+    void workerStatsChanged();
     void inputProcessed(double deltaX, double deltaY, double velocity);
     
 private slots:
     void onInputProcessed(const InputState& input);
+    void refreshWorkerStats();
     
 private:
     QString m_status = "Idle";
@@ -68,6 +90,11 @@ private:
     
     // Performance tracking
     FastConf<float, 32> m_latencyTracker;
+    
+    // Worker stats are polled, not pushed, so the worker never touches Qt
+    QTimer m_workerStatsTimer;
+    InputWorkerStats m_workerStats;
+    static constexpr int WORKER_STATS_INTERVAL_MS = 250;
 };
 
 } // namespace NeoZ
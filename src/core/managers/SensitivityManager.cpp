@@ -9,7 +9,7 @@ SensitivityManager::SensitivityManager(QObject* parent)
     : QObject(parent)
 {
     m_velocityCurve = new VelocityCurve(this);
-    m_drcs = new DRCS(this);
+    m_drcs = InputHookManager::instance().pipeline()->drcs();  // Pipeline Step 8
     
     loadFromConfig();
 }
@@ -111,7 +111,7 @@ private:
     QString m_curve = "FF_OneTap_v2";
     
     VelocityCurve* m_velocityCurve = nullptr;
-    DRCS* m_drcs = nullptr;
+    DRCS* m_drcs = nullptr;  // Owned by SensitivityPipeline
     
     // Snapshot data
     struct Snapshot {
@@ -0,0 +1,141 @@
+#pragma once
+/**
+ * @file RcuCell.hpp
+ * @brief Single-pointer RCU cell for immutable hot-path snapshots
+ *
+ * Features:
+ * - Readers never lock, never allocate, never see a half-built object
+ * - Writers build a complete object, then publish it with one atomic swap
+ * - Retired objects are reclaimed once no reader is in flight
+ * - Header-only
+ *
+ * Usage:
+ *   RcuCell<Params> params(std::make_unique<Params>());
+ *   {
+ *       auto p = params.read();      // hook thread: ~2 atomic ops
+ *       use(p->gain);
+ *   }
+ *   params.publish(std::move(next)); // GUI thread
+ *
+ * Keep read guards short-lived (one event or one batch): reclamation of
+ * retired objects waits for a moment with zero readers in flight.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace NeoZ {
+
+template <typename T>
+class RcuCell
+{
+public:
+    /**
+     * @brief RAII read-side critical section
+     */
+    class ReadGuard
+    {
+    public:
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ReadGuard(ReadGuard&& other) noexcept
+            : m_cell(other.m_cell), m_ptr(other.m_ptr)
+        {
+            other.m_cell = nullptr;
+            other.m_ptr = nullptr;
+        }
+        ReadGuard& operator=(ReadGuard&&) = delete;
+
+        ~ReadGuard()
+        {
+            if (m_cell) m_cell->m_readers.fetch_sub(1, std::memory_order_release);
+        }
+
+        const T* get() const noexcept { return m_ptr; }
+        const T* operator->() const noexcept { return m_ptr; }
+        const T& operator*() const noexcept { return *m_ptr; }
+        explicit operator bool() const noexcept { return m_ptr != nullptr; }
+
+    private:
+        friend class RcuCell;
+        ReadGuard(const RcuCell* cell, const T* ptr) noexcept : m_cell(cell), m_ptr(ptr) {}
+
+        const RcuCell* m_cell;
+        const T* m_ptr;
+    };
+
+    explicit RcuCell(std::unique_ptr<T> initial = nullptr) noexcept
+        : m_current(initial.release())
+    {
+    }
+
+    ~RcuCell()
+    {
+        delete m_current.load(std::memory_order_relaxed);
+        for (T* old : m_retired) delete old;
+    }
+
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    /**
+     * @brief Enter a read-side section and load the current object (wait-free)
+     *
+     * The reader count is raised before the pointer is loaded, so a writer
+     * that later observes zero readers knows nobody holds a retired object.
+     */
+    ReadGuard read() const noexcept
+    {
+        m_readers.fetch_add(1, std::memory_order_seq_cst);
+        return ReadGuard(this, m_current.load(std::memory_order_seq_cst));
+    }
+
+    /**
+     * @brief Publish a fully-built replacement (writers serialize on a mutex)
+     */
+    void publish(std::unique_ptr<T> next)
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        T* old = m_current.exchange(next.release(), std::memory_order_seq_cst);
+        if (old) m_retired.push_back(old);
+        reclaimLocked();
+    }
+
+    /**
+     * @brief Try to free retired objects (also done on every publish)
+     */
+    void reclaim()
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        reclaimLocked();
+    }
+
+    /**
+     * @brief Number of retired objects awaiting reclamation
+     */
+    size_t retiredCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        return m_retired.size();
+    }
+
+private:
+    void reclaimLocked()
+    {
+        if (m_retired.empty()) return;
+        if (m_readers.load(std::memory_order_seq_cst) != 0) return;
+        for (T* old : m_retired) delete old;
+        m_retired.clear();
+    }
+
+    alignas(64) std::atomic<T*> m_current{nullptr};
+    alignas(64) mutable std::atomic<uint32_t> m_readers{0};
+
+    mutable std::mutex m_writeMutex;
+    std::vector<T*> m_retired;
+};
+
+} // namespace NeoZ
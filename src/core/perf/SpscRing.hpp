@@ -0,0 +1,109 @@
+#pragma once
+/**
+ * @file SpscRing.hpp
+ * @brief Bounded lock-free single-producer / single-consumer ring
+ *
+ * Features:
+ * - Wait-free push/pop (one acquire load + one release store each)
+ * - Head and tail on separate cache lines (no false sharing)
+ * - Cached opposite index, so the common case touches no shared line
+ * - Compile-time capacity (power of two), no allocations
+ * - Header-only
+ *
+ * Usage:
+ *   SpscRing<RawDelta, 1024> ring;
+ *   ring.tryPush(d);                 // producer thread only
+ *   size_t n = ring.popBulk(out, 64); // consumer thread only
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace NeoZ {
+
+template <typename T, size_t N>
+class SpscRing
+{
+    static_assert((N & (N - 1)) == 0, "N must be power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    /**
+     * @brief Producer: enqueue one element
+     * @return false if the ring is full (caller decides whether to drop)
+     */
+    bool tryPush(const T& value) noexcept
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - cachedTail_ == N) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head - cachedTail_ == N) return false;
+        }
+        buffer_[head & mask_] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer: dequeue one element
+     * @return false if the ring is empty
+     */
+    bool tryPop(T& out) noexcept
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == cachedHead_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail == cachedHead_) return false;
+        }
+        out = buffer_[tail & mask_];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer: dequeue up to maxCount elements in one shot
+     * @return Number of elements written to out
+     */
+    size_t popBulk(T* out, size_t maxCount) noexcept
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        cachedHead_ = head_.load(std::memory_order_acquire);
+        size_t count = cachedHead_ - tail;
+        if (count > maxCount) count = maxCount;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = buffer_[(tail + i) & mask_];
+        }
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Approximate number of queued elements (any thread)
+     */
+    size_t size() const noexcept
+    {
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        const size_t head = head_.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+    static constexpr size_t capacity() noexcept { return N; }
+
+private:
+    static constexpr size_t mask_ = N - 1;
+
+    // Producer-owned line
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;
+
+    // Consumer-owned line
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;
+
+    alignas(64) std::array<T, N> buffer_{};
+};
+
+} // namespace NeoZ
@@ -6,31 +6,63 @@
 
 #include "DRCS.h"
 #include <QDebug>
-#include <numeric>
 #include <algorithm>
+#include <numbers>
 
 DRCS::DRCS(QObject *parent)
     : QObject(parent)
 {
-    m_motionBuffer.reserve(BUFFER_SIZE);
-    initTimeDecayWeights();
+    m_timeDecayFactor = std::exp(-TIME_DECAY_RATE);
+    m_binHead.fill(-1);
+    publishSettings();
     qDebug() << "[DRCS] Initialized - Directional Repetition Constraint System";
 }
 
-void DRCS::initTimeDecayWeights()
+void DRCS::publishSettings()
 {
-    m_timeDecayWeights.resize(BUFFER_SIZE);
-    // Exponential decay: recent inputs have higher weight
-    for (size_t i = 0; i < BUFFER_SIZE; ++i) {
-        // Weight decreases as we go back in time
-        // w[0] = 1.0 (most recent), w[n] decays exponentially
-        m_timeDecayWeights[i] = std::exp(-0.3 * static_cast<double>(i));
-    }
+    auto settings = std::make_unique<Settings>();
+    settings->enabled = m_enabled;
+    settings->repetitionTolerance = m_repetitionTolerance;
+    settings->directionThreshold = m_directionThreshold;
+    settings->directionHalfArc = std::acos(m_directionThreshold);
+    settings->suppressionSteepness = m_suppressionSteepness;
+    settings->resetSensitivity = m_resetSensitivity;
+    settings->varianceThreshold = m_varianceThreshold;
+    m_settings.publish(std::move(settings));
 }
 
 double DRCS::processInput(double dx, double dy)
 {
-    if (!m_enabled) {
+    auto settings = m_settings.read();
+    applyPendingReset();
+    double suppression = step(dx, dy, *settings);
+    publishStats();
+    return suppression;
+}
+
+bool DRCS::applyBatch(const double* rawXs, const double* rawYs, double* xs, double* ys, size_t n)
+{
+    auto settings = m_settings.read();
+    applyPendingReset();
+    
+    if (!settings->enabled) {
+        m_currentSuppression = 1.0;
+        m_repetitionScore = 0.0;
+        return false;
+    }
+    
+    for (size_t i = 0; i < n; ++i) {
+        double suppression = step(rawXs[i], rawYs[i], *settings);
+        xs[i] *= suppression;
+        ys[i] *= suppression;
+    }
+    publishStats();
+    return true;
+}
+
+double DRCS::step(double dx, double dy, const Settings& settings)
+{
+    if (!settings.enabled) {
         m_currentSuppression = 1.0;
         m_repetitionScore = 0.0;
         return 1.0;
@@ -46,38 +78,40 @@ double DRCS::processInput(double dx, double dy)
     MotionVector current;
     current.dx = dx;
     current.dy = dy;
-    current.timestamp = std::chrono::steady_clock::now();
     current.normalize();
     
     // Check for direction change that should reset
-    if (!m_motionBuffer.empty()) {
-        double similarity = calculateCosineSimilarity(current, m_motionBuffer.back());
-        if (similarity < m_resetSensitivity) {
+    if (m_historyCount > 0) {
+        double similarity = calculateCosineSimilarity(current, historyAt(0));
+        if (similarity < settings.resetSensitivity) {
             // Significant direction change - partial reset
-            double resetFactor = (m_resetSensitivity - similarity) / m_resetSensitivity;
+            double resetFactor = (settings.resetSensitivity - similarity) / settings.resetSensitivity;
             m_repetitionScore *= (1.0 - resetFactor * 0.5);
         }
     }
     
-    // Add to buffer
-    m_motionBuffer.push_back(current);
-    if (m_motionBuffer.size() > BUFFER_SIZE) {
-        m_motionBuffer.erase(m_motionBuffer.begin());
+    // Make room so the window (including current) stays at BUFFER_SIZE
+    if (m_historyCount == BUFFER_SIZE) {
+        evictOldest();
     }
     
-    // Calculate repetition score
-    m_repetitionScore = calculateRepetitionScore();
+    // Score against the previous drags, then add current to the history
+    m_repetitionScore = calculateRepetitionScore(current, settings);
+    pushHistory(current, directionBin(current));
     
     // Check for micro-variance bypass
-    if (hasMicroVariance() || hasAngularJitter()) {
+    if (hasMicroVariance(settings) || hasAngularJitter(settings)) {
         // Human-like variance detected - reduce suppression
         m_repetitionScore *= 0.5;
     }
     
     // Calculate suppression factor
-    m_currentSuppression = calculateSuppressionFactor(m_repetitionScore);
+    m_currentSuppression = calculateSuppressionFactor(m_repetitionScore, settings);
     
-    emit suppressionChanged();
+    ++m_pendingEvents;
+    if (m_currentSuppression < SUPPRESSED_BELOW) {
+        ++m_pendingSuppressed;
+    }
     
     return m_currentSuppression;
 }
@@ -91,11 +125,44 @@ void DRCS::applyToInput(double& dx, double& dy)
 
 void DRCS::reset()
 {
-    m_motionBuffer.clear();
+    // The processing thread owns the history; ask it to clear on its next event
+    m_resetEpoch.fetch_add(1, std::memory_order_release);
+    m_publishedSuppression.store(1.0, std::memory_order_relaxed);
+    m_publishedScore.store(0.0, std::memory_order_relaxed);
+    emit suppressionChanged();
+    qDebug() << "[DRCS] Reset";
+}
+
+void DRCS::applyPendingReset()
+{
+    uint64_t epoch = m_resetEpoch.load(std::memory_order_acquire);
+    if (epoch == m_appliedResetEpoch) return;
+    
+    m_appliedResetEpoch = epoch;
+    m_historyHead = 0;
+    m_historyCount = 0;
+    m_binTree.fill(0.0);
+    m_binHead.fill(-1);
+    m_decayScale = 1.0;
     m_repetitionScore = 0.0;
     m_currentSuppression = 1.0;
+}
+
+void DRCS::publishStats()
+{
+    if (m_pendingEvents == 0) return;
+    if (m_statsTimer.isValid() && m_statsTimer.elapsed() < STATS_PUBLISH_INTERVAL_MS) return;
+    m_statsTimer.start();
+    
+    m_publishedSuppression.store(m_currentSuppression, std::memory_order_relaxed);
+    m_publishedScore.store(m_repetitionScore, std::memory_order_relaxed);
+    m_totalEvents.fetch_add(m_pendingEvents, std::memory_order_relaxed);
+    m_totalSuppressed.fetch_add(m_pendingSuppressed, std::memory_order_relaxed);
+    m_pendingEvents = 0;
+    m_pendingSuppressed = 0;
+    
+    // Queued to GUI-thread receivers when called from the input thread
     emit suppressionChanged();
-    qDebug() << "[DRCS] Reset";
 }
 
 double DRCS::calculateCosineSimilarity(const MotionVector& a, const MotionVector& b)
@@ -105,59 +172,185 @@ double DRCS::calculateCosineSimilarity(const MotionVector& a, const MotionVector
     return a.dirX * b.dirX + a.dirY * b.dirY;
 }
 
-double DRCS::calculateRepetitionScore()
+const MotionVector& DRCS::historyAt(size_t age) const
+{
+    return m_history[(m_historyHead - 1 - age) & (RING_CAPACITY - 1)].motion;
+}
+
+uint32_t DRCS::directionBin(const MotionVector& v)
+{
+    // atan2 in [-π, π] → [0, DIRECTION_BINS)
+    double turns = (std::atan2(v.dirY, v.dirX) + std::numbers::pi) / (2.0 * std::numbers::pi);
+    return static_cast<uint32_t>(turns * DIRECTION_BINS) & (DIRECTION_BINS - 1);
+}
+
+uint32_t DRCS::wrapBin(long bin)
+{
+    constexpr long bins = static_cast<long>(DIRECTION_BINS);
+    return static_cast<uint32_t>(((bin % bins) + bins) % bins);
+}
+
+void DRCS::pushHistory(const MotionVector& motion, uint32_t bin)
 {
-    if (m_motionBuffer.size() < 2) {
+    // Age every stored sample by one step, then insert with weight 1.0
+    // (w[0] for the next event's comparison)
+    m_decayScale *= m_timeDecayFactor;
+    if (m_decayScale < REBASE_SCALE) {
+        rebaseWeights();
+    }
+    
+    const int16_t slot = static_cast<int16_t>(m_historyHead & (RING_CAPACITY - 1));
+    HistoryEntry& entry = m_history[slot];
+    entry.motion = motion;
+    entry.bin = bin;
+    entry.storedWeight = 1.0 / m_decayScale;
+    binAdd(bin, entry.storedWeight);
+    
+    // Newest first in its bin's list
+    entry.prevInBin = -1;
+    entry.nextInBin = m_binHead[bin];
+    if (entry.nextInBin >= 0) {
+        m_history[entry.nextInBin].prevInBin = slot;
+    }
+    m_binHead[bin] = slot;
+    
+    ++m_historyHead;
+    ++m_historyCount;
+}
+
+void DRCS::evictOldest()
+{
+    const HistoryEntry& oldest = m_history[(m_historyHead - m_historyCount) & (RING_CAPACITY - 1)];
+    binAdd(oldest.bin, -oldest.storedWeight);
+    
+    if (oldest.prevInBin >= 0) {
+        m_history[oldest.prevInBin].nextInBin = oldest.nextInBin;
+    } else {
+        m_binHead[oldest.bin] = oldest.nextInBin;
+    }
+    if (oldest.nextInBin >= 0) {
+        m_history[oldest.nextInBin].prevInBin = oldest.prevInBin;
+    }
+    --m_historyCount;
+}
+
+void DRCS::rebaseWeights()
+{
+    // Fold the scale into the stored weights and rebuild the tree from the
+    // ring, which also discards accumulated add/subtract rounding error
+    m_binTree.fill(0.0);
+    for (size_t age = 0; age < m_historyCount; ++age) {
+        HistoryEntry& entry = m_history[(m_historyHead - 1 - age) & (RING_CAPACITY - 1)];
+        entry.storedWeight *= m_decayScale;
+        binAdd(entry.bin, entry.storedWeight);
+    }
+    m_decayScale = 1.0;
+}
+
+double DRCS::calculateRepetitionScore(const MotionVector& current, const Settings& settings)
+{
+    if (m_historyCount == 0) {
         return 0.0;
     }
     
-    const MotionVector& current = m_motionBuffer.back();
-    double score = 0.0;
-    
-    // Compare current drag to all previous drags in buffer
-    for (size_t i = 0; i < m_motionBuffer.size() - 1; ++i) {
-        size_t bufferIndex = m_motionBuffer.size() - 2 - i;  // Start from most recent
-        const MotionVector& previous = m_motionBuffer[bufferIndex];
-        
-        double similarity = calculateCosineSimilarity(current, previous);
-        
-        // If similarity exceeds threshold, count as repetition
-        if (similarity >= m_directionThreshold) {
-            // Apply time-decay weight
-            double weight = (i < m_timeDecayWeights.size()) ? m_timeDecayWeights[i] : 0.1;
-            score += weight;
-        }
+    // Arc of directions with cosine similarity >= θ_d, in bin units. Bins
+    // wholly inside it come from the tree; bins that straddle an edge (or
+    // lie within rounding distance of one) are tested sample by sample.
+    constexpr double binsPerRadian = DIRECTION_BINS / (2.0 * std::numbers::pi);
+    const double position = (std::atan2(current.dirY, current.dirX) + std::numbers::pi) * binsPerRadian;
+    const double halfArc = settings.directionHalfArc * binsPerRadian;
+    const long edgeFirst = static_cast<long>(std::floor(position - halfArc - EDGE_MARGIN_BINS));
+    const long edgeLast = static_cast<long>(std::floor(position + halfArc + EDGE_MARGIN_BINS));
+    const long innerFirst = static_cast<long>(std::ceil(position - halfArc + EDGE_MARGIN_BINS));
+    const long innerLast = static_cast<long>(std::floor(position + halfArc - EDGE_MARGIN_BINS)) - 1;
+    
+    double stored = 0.0;
+    if (innerFirst > innerLast) {
+        stored = binExact(edgeFirst, edgeLast, current, settings);
+    } else {
+        stored = binRange(innerFirst, innerLast)
+               + binExact(edgeFirst, innerFirst - 1, current, settings)
+               + binExact(innerLast + 1, edgeLast, current, settings);
     }
     
-    return score;
+    // Clamp rounding residue from evictions
+    return std::max(0.0, stored * m_decayScale);
+}
+
+double DRCS::binExact(long first, long last, const MotionVector& current, const Settings& settings)
+{
+    double sum = 0.0;
+    for (long bin = first; bin <= last; ++bin) {
+        for (int16_t slot = m_binHead[wrapBin(bin)]; slot >= 0; slot = m_history[slot].nextInBin) {
+            const HistoryEntry& entry = m_history[slot];
+            if (calculateCosineSimilarity(current, entry.motion) >= settings.directionThreshold) {
+                sum += entry.storedWeight;
+            }
+        }
+    }
+    return sum;
+}
+
+void DRCS::binAdd(uint32_t bin, double weight)
+{
+    for (size_t i = bin + 1; i <= DIRECTION_BINS; i += i & (~i + 1)) {
+        m_binTree[i] += weight;
+    }
+}
+
+double DRCS::binPrefix(size_t end) const
+{
+    double sum = 0.0;
+    for (size_t i = end; i > 0; i -= i & (~i + 1)) {
+        sum += m_binTree[i];
+    }
+    return sum;
+}
+
+double DRCS::binRange(long first, long last) const
+{
+    constexpr long bins = static_cast<long>(DIRECTION_BINS);
+    if (last < first) {
+        return 0.0;
+    }
+    // Arc crosses the ±π seam: split into two ranges
+    if (first < 0) {
+        return binPrefix(static_cast<size_t>(last + 1))
+             + binPrefix(DIRECTION_BINS) - binPrefix(static_cast<size_t>(first + bins));
+    }
+    if (last >= bins) {
+        return binPrefix(DIRECTION_BINS) - binPrefix(static_cast<size_t>(first))
+             + binPrefix(static_cast<size_t>(last - bins + 1));
+    }
+    return binPrefix(static_cast<size_t>(last + 1)) - binPrefix(static_cast<size_t>(first));
 }
 
-double DRCS::calculateSuppressionFactor(double repetitionScore)
+double DRCS::calculateSuppressionFactor(double repetitionScore, const Settings& settings)
 {
     // Sigmoid suppression: λ(R) = 1 / (1 + e^(a*(R - R₀)))
     // When R < R₀: factor ~1.0 (no suppression)
     // When R > R₀: factor decreases smoothly toward 0
     
-    double exponent = m_suppressionSteepness * (repetitionScore - m_repetitionTolerance);
+    double exponent = settings.suppressionSteepness * (repetitionScore - settings.repetitionTolerance);
     double factor = 1.0 / (1.0 + std::exp(exponent));
     
     // Clamp to reasonable range - never fully suppress
     return std::max(0.15, std::min(1.0, factor));
 }
 
-bool DRCS::hasMicroVariance()
+bool DRCS::hasMicroVariance(const Settings& settings)
 {
-    if (m_motionBuffer.size() < 3) {
+    if (m_historyCount < 3) {
         return false;
     }
     
     // Calculate variance in magnitude over recent inputs
     double sum = 0.0;
     double sumSq = 0.0;
-    size_t count = std::min(m_motionBuffer.size(), static_cast<size_t>(5));
+    size_t count = std::min(m_historyCount, static_cast<size_t>(5));
     
-    for (size_t i = m_motionBuffer.size() - count; i < m_motionBuffer.size(); ++i) {
-        double mag = m_motionBuffer[i].magnitude;
+    for (size_t age = 0; age < count; ++age) {
+        double mag = historyAt(age).magnitude;
         sum += mag;
         sumSq += mag * mag;
     }
@@ -166,31 +359,30 @@ bool DRCS::hasMicroVariance()
     double variance = (sumSq / count) - (mean * mean);
     
     // Normalize variance by mean to get coefficient of variation
-    double cv = (mean > 0.01) ? std::sqrt(variance) / mean : 0.0;
+    double cv = (mean > 0.01) ? std::sqrt(std::max(0.0, variance)) / mean : 0.0;
     
-    return cv >= m_varianceThreshold;
+    return cv >= settings.varianceThreshold;
 }
 
-bool DRCS::hasAngularJitter()
+bool DRCS::hasAngularJitter(const Settings& settings)
 {
-    if (m_motionBuffer.size() < 3) {
+    if (m_historyCount < 3) {
         return false;
     }
     
     // Check if there's small but consistent angular variance
     // (similarity < 1.0 but > threshold)
-    size_t count = std::min(m_motionBuffer.size() - 1, static_cast<size_t>(5));
+    size_t count = std::min(m_historyCount - 1, static_cast<size_t>(5));
     double avgSimilarity = 0.0;
     
-    for (size_t i = 1; i <= count; ++i) {
-        size_t idx = m_motionBuffer.size() - 1 - i;
-        double sim = calculateCosineSimilarity(m_motionBuffer.back(), m_motionBuffer[idx]);
+    for (size_t age = 1; age <= count; ++age) {
+        double sim = calculateCosineSimilarity(historyAt(0), historyAt(age));
         avgSimilarity += sim;
     }
     avgSimilarity /= count;
     
     // Jitter: similar enough to be "same direction" but not perfectly identical
-    return avgSimilarity >= m_directionThreshold && avgSimilarity < 0.99;
+    return avgSimilarity >= settings.directionThreshold && avgSimilarity < 0.99;
 }
 
 // Setters
@@ -198,6 +390,7 @@ void DRCS::setEnabled(bool enabled)
 {
     if (m_enabled != enabled) {
         m_enabled = enabled;
+        publishSettings();
         if (!enabled) {
             reset();
         }
@@ -209,23 +402,27 @@ void DRCS::setEnabled(bool enabled)
 void DRCS::setRepetitionTolerance(double value)
 {
     m_repetitionTolerance = std::max(1.0, std::min(10.0, value));
+    publishSettings();
     emit parametersChanged();
 }
 
 void DRCS::setDirectionThreshold(double value)
 {
     m_directionThreshold = std::max(0.8, std::min(0.99, value));
+    publishSettings();
     emit parametersChanged();
 }
 
 void DRCS::setSuppressionSteepness(double value)
 {
     m_suppressionSteepness = std::max(0.5, std::min(5.0, value));
+    publishSettings();
     emit parametersChanged();
 }
 
 void DRCS::setResetSensitivity(double value)
 {
     m_resetSensitivity = std::max(0.5, std::min(0.95, value));
+    publishSettings();
     emit parametersChanged();
 }
@@ -10,9 +10,14 @@
 #define DRCS_H
 
 #include <QObject>
-#include <vector>
+#include <QElapsedTimer>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cmath>
 #include <chrono>
+#include <cstdint>
+#include "../perf/RcuCell.hpp"
 
 struct MotionVector {
     double dx = 0.0;
@@ -46,8 +51,26 @@ class DRCS : public QObject
     Q_PROPERTY(double resetSensitivity READ resetSensitivity WRITE setResetSensitivity NOTIFY parametersChanged)
     Q_PROPERTY(double currentSuppression READ currentSuppression NOTIFY suppressionChanged)
     Q_PROPERTY(double repetitionScore READ repetitionScore NOTIFY suppressionChanged)
+    Q_PROPERTY(qint64 processedEvents READ processedEvents NOTIFY suppressionChanged)
+    Q_PROPERTY(qint64 suppressedEvents READ suppressedEvents NOTIFY suppressionChanged)
 
 public:
+    /**
+     * @brief Input-thread view of the parameters.
+     *
+     * Setters run on the GUI thread and publish a fresh Settings through an
+     * RcuCell; processing loads it once per event (or batch).
+     */
+    struct Settings {
+        bool enabled = false;
+        double repetitionTolerance = 4.0;
+        double directionThreshold = 0.95;
+        double directionHalfArc = 0.0;      // acos(directionThreshold)
+        double suppressionSteepness = 2.0;
+        double resetSensitivity = 0.8;
+        double varianceThreshold = 0.05;
+    };
+    
     explicit DRCS(QObject *parent = nullptr);
     
     // Main processing function - call this for each input frame
@@ -57,7 +80,15 @@ public:
     // Apply DRCS to input and return modified values
     void applyToInput(double& dx, double& dy);
     
-    // Reset the system (e.g., on direction change or timeout)
+    // Pipeline stage: detect on the raw mouse counts rawXs/rawYs (what the
+    // thresholds are tuned for) and scale the processed deltas xs/ys in
+    // place, exactly as applyToInput() would event by event. Returns false,
+    // leaving xs/ys untouched, while disabled. Allocation-free; statistics
+    // are published once per batch, at most every STATS_PUBLISH_INTERVAL_MS.
+    bool applyBatch(const double* rawXs, const double* rawYs, double* xs, double* ys, size_t n);
+    
+    // Reset the system (e.g., on direction change or timeout).
+    // Safe from any thread: history is cleared before the next event.
     Q_INVOKABLE void reset();
     
     // Getters
@@ -66,8 +97,12 @@ public:
     double directionThreshold() const { return m_directionThreshold; }
     double suppressionSteepness() const { return m_suppressionSteepness; }
     double resetSensitivity() const { return m_resetSensitivity; }
-    double currentSuppression() const { return m_currentSuppression; }
-    double repetitionScore() const { return m_repetitionScore; }
+    
+    // Published statistics (updated in batches)
+    double currentSuppression() const { return m_publishedSuppression.load(std::memory_order_relaxed); }
+    double repetitionScore() const { return m_publishedScore.load(std::memory_order_relaxed); }
+    qint64 processedEvents() const { return static_cast<qint64>(m_totalEvents.load(std::memory_order_relaxed)); }
+    qint64 suppressedEvents() const { return static_cast<qint64>(m_totalSuppressed.load(std::memory_order_relaxed)); }
     
     // Setters
     void setEnabled(bool enabled);
@@ -83,15 +118,66 @@ signals:
 
 private:
     // Core algorithm functions
+    double step(double dx, double dy, const Settings& settings);
     double calculateCosineSimilarity(const MotionVector& a, const MotionVector& b);
-    double calculateRepetitionScore();
-    double calculateSuppressionFactor(double repetitionScore);
-    bool hasMicroVariance();
-    bool hasAngularJitter();
+    double calculateRepetitionScore(const MotionVector& current, const Settings& settings);
+    double calculateSuppressionFactor(double repetitionScore, const Settings& settings);
+    bool hasMicroVariance(const Settings& settings);
+    bool hasAngularJitter(const Settings& settings);
     
-    // Motion buffer
-    std::vector<MotionVector> m_motionBuffer;
+    void publishSettings();
+    void applyPendingReset();
+    void publishStats();
+    
+    // Motion history: fixed power-of-two ring, BUFFER_SIZE samples live
+    // (including the current one). Capacity only rounds the window up.
     static constexpr size_t BUFFER_SIZE = 20;
+    static constexpr size_t RING_CAPACITY = std::bit_ceil(BUFFER_SIZE);
+    
+    struct HistoryEntry {
+        MotionVector motion;
+        uint32_t bin = 0;           // Direction bin
+        double storedWeight = 0.0;  // Time-decay weight / m_decayScale at insert
+        int16_t prevInBin = -1;     // Ring slots of the neighbours in the
+        int16_t nextInBin = -1;     // same bin (-1 = none)
+    };
+    
+    std::array<HistoryEntry, RING_CAPACITY> m_history;
+    size_t m_historyHead = 0;   // Total samples ever pushed
+    size_t m_historyCount = 0;  // Live samples (<= BUFFER_SIZE)
+    
+    const MotionVector& historyAt(size_t age) const;  // 0 = newest
+    void pushHistory(const MotionVector& motion, uint32_t bin);
+    void evictOldest();
+    void rebaseWeights();
+    
+    // Incremental repetition score.
+    // Directions are quantized into DIRECTION_BINS angular bins; a Fenwick
+    // tree over the bins holds the time-decayed weight of the samples in
+    // each. Weights decay lazily through m_decayScale (actual = stored *
+    // scale), so aging the whole history is one multiply. The score is a
+    // range sum over the bins lying entirely within acos(θ_d) of the
+    // current direction, plus an exact cosine test of the few samples in
+    // the bins straddling the arc's edges (per-bin lists). Same samples
+    // counted as the O(N) scan; only the summation order differs.
+    // O(log DIRECTION_BINS) per event, independent of BUFFER_SIZE.
+    static constexpr size_t DIRECTION_BINS = 4096;      // ~0.09° per bin
+    static constexpr double TIME_DECAY_RATE = 0.3;      // w_i = e^(-0.3 i)
+    static constexpr double REBASE_SCALE = 1e-150;      // Renormalize below this
+    static constexpr double EDGE_MARGIN_BINS = 1e-6;    // atan2/acos rounding slack
+    
+    std::array<double, DIRECTION_BINS + 1> m_binTree{};  // 1-based Fenwick
+    std::array<int16_t, DIRECTION_BINS> m_binHead;       // Newest slot per bin
+    double m_decayScale = 1.0;
+    double m_timeDecayFactor = 0.0;   // e^(-TIME_DECAY_RATE)
+    
+    void binAdd(uint32_t bin, double weight);
+    double binPrefix(size_t end) const;               // Sum of bins [0, end)
+    double binRange(long first, long last) const;     // Inclusive, wraps
+    double binExact(long first, long last, const MotionVector& current,
+                    const Settings& settings);        // Inclusive, wraps
+    static uint32_t directionBin(const MotionVector& v);
+    static uint32_t wrapBin(long bin);
     
     // Parameters
     bool m_enabled = false;
@@ -101,13 +187,25 @@ private:
     double m_resetSensitivity = 0.8;          // How fast direction change resets
     double m_varianceThreshold = 0.05;        // ε_m: micro-variance threshold
     
-    // Current state
+    NeoZ::RcuCell<Settings> m_settings;
+    
+    // Processing-thread state
     double m_currentSuppression = 1.0;
     double m_repetitionScore = 0.0;
+    uint64_t m_appliedResetEpoch = 0;
+    uint64_t m_pendingEvents = 0;
+    uint64_t m_pendingSuppressed = 0;
+    QElapsedTimer m_statsTimer;
+    
+    // Cross-thread: reset requests and batched statistics
+    std::atomic<uint64_t> m_resetEpoch{0};
+    std::atomic<double> m_publishedSuppression{1.0};
+    std::atomic<double> m_publishedScore{0.0};
+    std::atomic<uint64_t> m_totalEvents{0};
+    std::atomic<uint64_t> m_totalSuppressed{0};
     
-    // Time decay weights (more recent = higher weight)
-    std::vector<double> m_timeDecayWeights;
-    void initTimeDecayWeights();
+    static constexpr qint64 STATS_PUBLISH_INTERVAL_MS = 50;
+    static constexpr double SUPPRESSED_BELOW = 0.99;  // Counts as a suppressed event
 };
 
 #endif // DRCS_H
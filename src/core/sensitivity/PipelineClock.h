@@ -0,0 +1,79 @@
+#ifndef NEOZ_PIPELINECLOCK_H
+#define NEOZ_PIPELINECLOCK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include "../input/InputState.h"
+
+namespace NeoZ {
+
+/**
+ * @brief Monotonic nanosecond time source.
+ *
+ * Defaults to std::chrono::steady_clock; tests and replay drivers can
+ * substitute a manual or recorded clock.
+ */
+using TimeSource = std::function<int64_t()>;
+
+/**
+ * @brief Event-time clock for the sensitivity pipeline.
+ *
+ * Δt is derived from InputState::timestamp in nanoseconds, so 1-8 kHz
+ * polling yields fractional-ms deltas (0.125 ms at 8 kHz) instead of
+ * whole-ms wall-clock reads that mostly round to zero. Events without a
+ * timestamp are stamped from the time source. The first event after
+ * construction or reset() has Δt = 0 (kernel fallbacks apply).
+ *
+ * Single-threaded: owned by whichever thread runs the pipeline.
+ */
+class PipelineClock
+{
+public:
+    PipelineClock() = default;
+
+    static int64_t steadyNowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // nullptr restores steady_clock
+    void setTimeSource(TimeSource source) { m_source = std::move(source); }
+
+    int64_t nowNs() const { return m_source ? m_source() : steadyNowNs(); }
+
+    // Event time in ns (time source if the event carries no timestamp)
+    int64_t eventNs(const InputState& event) const
+    {
+        int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            event.timestamp.time_since_epoch()).count();
+        return ns != 0 ? ns : nowNs();
+    }
+
+    // Δt in ms since the previous event; advances the clock
+    double advance(const InputState& event)
+    {
+        const int64_t ns = eventNs(event);
+        double dtMs = 0.0;
+        if (m_hasLast) {
+            dtMs = static_cast<double>(std::max<int64_t>(0, ns - m_lastNs)) / 1.0e6;
+        }
+        m_lastNs = ns;
+        m_hasLast = true;
+        return dtMs;
+    }
+
+    void reset() { m_hasLast = false; }
+
+private:
+    TimeSource m_source;
+    int64_t m_lastNs = 0;
+    bool m_hasLast = false;
+};
+
+} // namespace NeoZ
+
+#endif // NEOZ_PIPELINECLOCK_H
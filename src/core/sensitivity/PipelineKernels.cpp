@@ -0,0 +1,594 @@
+#include "PipelineKernels.h"
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NEOZ_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define NEOZ_KERNELS_X86 0
+#endif
+
+// Per-function ISA targeting so the rest of the binary stays baseline x86-64.
+// MSVC accepts intrinsics without target flags.
+#if defined(__GNUC__) || defined(__clang__)
+#define NEOZ_TARGET(isa) __attribute__((target(isa)))
+#else
+#define NEOZ_TARGET(isa)
+#endif
+
+// No FMA contraction in this file, whatever the target's flags: a fused
+// multiply-add rounds once, so the ISA levels would stop being bit-identical.
+// Set here rather than per target so the app, tests and bench all agree.
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract(off)
+#endif
+
+namespace NeoZ {
+
+namespace {
+
+// Slow zone constants (mirror SensitivityPipeline step 6)
+constexpr double SLOW_ZONE_MIN_RATIO = 0.001;
+constexpr double FALLBACK_DT_SEC = 0.001;
+
+// exp() reduction constants (fdlibm split of ln 2)
+constexpr double EXP_MIN_ARG = -708.0;  // Below this e^x underflows to subnormal
+constexpr double LOG2E = 1.44269504088896338700e+00;
+constexpr double LN2_HI = 6.93147180369123816490e-01;
+constexpr double LN2_LO = 1.90821492927058770002e-10;
+
+// Taylor coefficients 1/n! for the reduced range |r| <= ln2/2
+constexpr double EXP_C[] = {
+    1.0,
+    1.0,
+    1.0 / 2.0,
+    1.0 / 6.0,
+    1.0 / 24.0,
+    1.0 / 120.0,
+    1.0 / 720.0,
+    1.0 / 5040.0,
+    1.0 / 40320.0,
+    1.0 / 362880.0,
+    1.0 / 3628800.0,
+    1.0 / 39916800.0,
+    1.0 / 479001600.0,
+    1.0 / 6227020800.0,
+};
+constexpr int EXP_DEGREE = 13;
+
+std::atomic<int> g_isaOverride{-1};
+
+// ========== SCALAR REFERENCE (one element) ==========
+
+inline void scaleOne(double& x, double& y, double dpi, double winScale,
+                     double resScale, double gainX, double gainY)
+{
+    x = ((x / dpi) * winScale) * resScale * gainX;
+    y = ((y / dpi) * winScale) * resScale * gainY;
+}
+
+inline void curveOne(double& x, double& y, double& v, const VelocityCurve::Shape& shape)
+{
+    v = std::sqrt(x * x + y * y);
+    if (shape.linear) return;
+    double c = shape.evaluate(v);
+    x *= c;
+    y *= c;
+}
+
+inline void lutOne(double& x, double& y, double& v, const VelocityCurve::Table& table)
+{
+    v = std::sqrt(x * x + y * y);
+    double c = table.lookup(v);
+    x *= c;
+    y *= c;
+}
+
+inline void slowZoneOne(double& x, double& y, double v, double dtMs, double omegaThreshold)
+{
+    double dt = (dtMs > 0.0) ? (dtMs / 1000.0) : FALLBACK_DT_SEC;
+    double angularVelocity = v / dt;
+    if (angularVelocity < omegaThreshold) {
+        double ratio = angularVelocity / omegaThreshold;
+        if (ratio < SLOW_ZONE_MIN_RATIO) ratio = SLOW_ZONE_MIN_RATIO;
+        double scale = ratio * ratio;  // γ = 2
+        x *= scale;
+        y *= scale;
+    }
+}
+
+inline double lambdaOne(double dtMs, double tau)
+{
+    return (dtMs > 0.0) ? PipelineKernels::expNonPositive(-dtMs / tau) : 0.0;
+}
+
+// ========== SCALAR KERNELS (also used for SIMD tails) ==========
+
+void scaleAxesScalar(double* xs, double* ys, std::size_t begin, std::size_t n,
+                     double dpi, double winScale, double resScale, double gx, double gy)
+{
+    for (std::size_t i = begin; i < n; ++i) {
+        scaleOne(xs[i], ys[i], dpi, winScale, resScale, gx, gy);
+    }
+}
+
+void applyCurveScalar(double* xs, double* ys, double* vs, std::size_t begin, std::size_t n,
+                      const VelocityCurve::Shape& shape)
+{
+    for (std::size_t i = begin; i < n; ++i) {
+        curveOne(xs[i], ys[i], vs[i], shape);
+    }
+}
+
+void applyLutScalar(double* xs, double* ys, double* vs, std::size_t begin, std::size_t n,
+                    const VelocityCurve::Table& table)
+{
+    for (std::size_t i = begin; i < n; ++i) {
+        lutOne(xs[i], ys[i], vs[i], table);
+    }
+}
+
+void applySlowZoneScalar(double* xs, double* ys, const double* vs, const double* dtMs,
+                         std::size_t begin, std::size_t n, double omegaThreshold)
+{
+    for (std::size_t i = begin; i < n; ++i) {
+        slowZoneOne(xs[i], ys[i], vs[i], dtMs[i], omegaThreshold);
+    }
+}
+
+void smoothingLambdasScalar(const double* dtMs, double* lambdas, std::size_t begin,
+                            std::size_t n, double tau)
+{
+    for (std::size_t i = begin; i < n; ++i) {
+        lambdas[i] = lambdaOne(dtMs[i], tau);
+    }
+}
+
+#if NEOZ_KERNELS_X86
+
+// ========== SSE4.1 (2 lanes) ==========
+
+NEOZ_TARGET("sse4.1")
+inline __m128d expNonPositiveSse(__m128d x)
+{
+    const __m128d minArg = _mm_set1_pd(EXP_MIN_ARG);
+    const __m128d valid = _mm_cmpge_pd(x, minArg);  // false for NaN
+    x = _mm_max_pd(x, minArg);
+
+    __m128d k = _mm_round_pd(_mm_mul_pd(x, _mm_set1_pd(LOG2E)),
+                             _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m128d r = _mm_sub_pd(_mm_sub_pd(x, _mm_mul_pd(k, _mm_set1_pd(LN2_HI))),
+                           _mm_mul_pd(k, _mm_set1_pd(LN2_LO)));
+
+    __m128d p = _mm_set1_pd(EXP_C[EXP_DEGREE]);
+    for (int i = EXP_DEGREE - 1; i >= 0; --i) {
+        p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(EXP_C[i]));
+    }
+
+    __m128i k64 = _mm_cvtepi32_epi64(_mm_cvtpd_epi32(k));
+    __m128i bits = _mm_slli_epi64(_mm_add_epi64(k64, _mm_set1_epi64x(1023)), 52);
+    return _mm_and_pd(_mm_mul_pd(p, _mm_castsi128_pd(bits)), valid);
+}
+
+NEOZ_TARGET("sse4.1")
+void scaleAxesSse41(double* xs, double* ys, std::size_t n,
+                    double dpi, double winScale, double resScale, double gx, double gy)
+{
+    const __m128d vDpi = _mm_set1_pd(dpi);
+    const __m128d vWin = _mm_set1_pd(winScale);
+    const __m128d vRes = _mm_set1_pd(resScale);
+    const __m128d vGx = _mm_set1_pd(gx);
+    const __m128d vGy = _mm_set1_pd(gy);
+
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(xs + i);
+        __m128d y = _mm_loadu_pd(ys + i);
+        x = _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(_mm_div_pd(x, vDpi), vWin), vRes), vGx);
+        y = _mm_mul_pd(_mm_mul_pd(_mm_mul_pd(_mm_div_pd(y, vDpi), vWin), vRes), vGy);
+        _mm_storeu_pd(xs + i, x);
+        _mm_storeu_pd(ys + i, y);
+    }
+    scaleAxesScalar(xs, ys, i, n, dpi, winScale, resScale, gx, gy);
+}
+
+NEOZ_TARGET("sse4.1")
+void applyCurveSse41(double* xs, double* ys, double* vs, std::size_t n,
+                     const VelocityCurve::Shape& shape)
+{
+    const __m128d lowT = _mm_set1_pd(shape.lowThreshold);
+    const __m128d highT = _mm_set1_pd(shape.highThreshold);
+    const __m128d span = _mm_set1_pd(shape.highThreshold - shape.lowThreshold);
+    const __m128d lowM = _mm_set1_pd(shape.lowMultiplier);
+    const __m128d midM = _mm_set1_pd(shape.midMultiplier);
+    const __m128d highM = _mm_set1_pd(shape.highMultiplier);
+    const __m128d lowSpan = _mm_set1_pd(shape.midMultiplier - shape.lowMultiplier);
+    const __m128d highSpan = _mm_set1_pd(shape.highMultiplier - shape.midMultiplier);
+    const __m128d half = _mm_set1_pd(0.5);
+    const __m128d two = _mm_set1_pd(2.0);
+    const __m128d three = _mm_set1_pd(3.0);
+
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(xs + i);
+        __m128d y = _mm_loadu_pd(ys + i);
+        __m128d v = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(x, x), _mm_mul_pd(y, y)));
+        _mm_storeu_pd(vs + i, v);
+        if (shape.linear) continue;
+
+        // Evaluate both smoothstep halves, then select like Shape::evaluate()
+        __m128d t = _mm_div_pd(_mm_sub_pd(v, lowT), span);
+        __m128d lt = _mm_mul_pd(t, two);
+        __m128d ls = _mm_mul_pd(_mm_mul_pd(lt, lt), _mm_sub_pd(three, _mm_mul_pd(two, lt)));
+        __m128d lower = _mm_add_pd(lowM, _mm_mul_pd(lowSpan, ls));
+        __m128d ht = _mm_mul_pd(_mm_sub_pd(t, half), two);
+        __m128d hs = _mm_mul_pd(_mm_mul_pd(ht, ht), _mm_sub_pd(three, _mm_mul_pd(two, ht)));
+        __m128d upper = _mm_add_pd(midM, _mm_mul_pd(highSpan, hs));
+
+        __m128d c = _mm_blendv_pd(upper, lower, _mm_cmplt_pd(t, half));
+        c = _mm_blendv_pd(c, highM, _mm_cmpge_pd(v, highT));
+        c = _mm_blendv_pd(c, lowM, _mm_cmple_pd(v, lowT));
+
+        _mm_storeu_pd(xs + i, _mm_mul_pd(x, c));
+        _mm_storeu_pd(ys + i, _mm_mul_pd(y, c));
+    }
+    applyCurveScalar(xs, ys, vs, i, n, shape);
+}
+
+NEOZ_TARGET("sse4.1")
+void applySlowZoneSse41(double* xs, double* ys, const double* vs, const double* dtMs,
+                        std::size_t n, double omegaThreshold)
+{
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d ms = _mm_set1_pd(1000.0);
+    const __m128d fallbackDt = _mm_set1_pd(FALLBACK_DT_SEC);
+    const __m128d thr = _mm_set1_pd(omegaThreshold);
+    const __m128d minRatio = _mm_set1_pd(SLOW_ZONE_MIN_RATIO);
+    const __m128d one = _mm_set1_pd(1.0);
+
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d d = _mm_loadu_pd(dtMs + i);
+        __m128d dt = _mm_blendv_pd(fallbackDt, _mm_div_pd(d, ms), _mm_cmpgt_pd(d, zero));
+        __m128d omega = _mm_div_pd(_mm_loadu_pd(vs + i), dt);
+        __m128d ratio = _mm_div_pd(omega, thr);
+        ratio = _mm_blendv_pd(ratio, minRatio, _mm_cmplt_pd(ratio, minRatio));
+        __m128d scale = _mm_blendv_pd(one, _mm_mul_pd(ratio, ratio), _mm_cmplt_pd(omega, thr));
+        _mm_storeu_pd(xs + i, _mm_mul_pd(_mm_loadu_pd(xs + i), scale));
+        _mm_storeu_pd(ys + i, _mm_mul_pd(_mm_loadu_pd(ys + i), scale));
+    }
+    applySlowZoneScalar(xs, ys, vs, dtMs, i, n, omegaThreshold);
+}
+
+NEOZ_TARGET("sse4.1")
+void smoothingLambdasSse41(const double* dtMs, double* lambdas, std::size_t n, double tau)
+{
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d signBit = _mm_set1_pd(-0.0);
+    const __m128d vTau = _mm_set1_pd(tau);
+
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d d = _mm_loadu_pd(dtMs + i);
+        __m128d e = expNonPositiveSse(_mm_div_pd(_mm_xor_pd(d, signBit), vTau));
+        _mm_storeu_pd(lambdas + i, _mm_and_pd(e, _mm_cmpgt_pd(d, zero)));
+    }
+    smoothingLambdasScalar(dtMs, lambdas, i, n, tau);
+}
+
+// ========== AVX2 (4 lanes) ==========
+
+NEOZ_TARGET("avx2")
+inline __m256d expNonPositiveAvx(__m256d x)
+{
+    const __m256d minArg = _mm256_set1_pd(EXP_MIN_ARG);
+    const __m256d valid = _mm256_cmp_pd(x, minArg, _CMP_GE_OQ);
+    x = _mm256_max_pd(x, minArg);
+
+    __m256d k = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(LOG2E)),
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_sub_pd(_mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(LN2_HI))),
+                              _mm256_mul_pd(k, _mm256_set1_pd(LN2_LO)));
+
+    __m256d p = _mm256_set1_pd(EXP_C[EXP_DEGREE]);
+    for (int i = EXP_DEGREE - 1; i >= 0; --i) {
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(EXP_C[i]));
+    }
+
+    __m256i k64 = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(k));
+    __m256i bits = _mm256_slli_epi64(_mm256_add_epi64(k64, _mm256_set1_epi64x(1023)), 52);
+    return _mm256_and_pd(_mm256_mul_pd(p, _mm256_castsi256_pd(bits)), valid);
+}
+
+NEOZ_TARGET("avx2")
+void scaleAxesAvx2(double* xs, double* ys, std::size_t n,
+                   double dpi, double winScale, double resScale, double gx, double gy)
+{
+    const __m256d vDpi = _mm256_set1_pd(dpi);
+    const __m256d vWin = _mm256_set1_pd(winScale);
+    const __m256d vRes = _mm256_set1_pd(resScale);
+    const __m256d vGx = _mm256_set1_pd(gx);
+    const __m256d vGy = _mm256_set1_pd(gy);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(xs + i);
+        __m256d y = _mm256_loadu_pd(ys + i);
+        x = _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(_mm256_div_pd(x, vDpi), vWin), vRes), vGx);
+        y = _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(_mm256_div_pd(y, vDpi), vWin), vRes), vGy);
+        _mm256_storeu_pd(xs + i, x);
+        _mm256_storeu_pd(ys + i, y);
+    }
+    scaleAxesScalar(xs, ys, i, n, dpi, winScale, resScale, gx, gy);
+}
+
+NEOZ_TARGET("avx2")
+void applyCurveAvx2(double* xs, double* ys, double* vs, std::size_t n,
+                    const VelocityCurve::Shape& shape)
+{
+    const __m256d lowT = _mm256_set1_pd(shape.lowThreshold);
+    const __m256d highT = _mm256_set1_pd(shape.highThreshold);
+    const __m256d span = _mm256_set1_pd(shape.highThreshold - shape.lowThreshold);
+    const __m256d lowM = _mm256_set1_pd(shape.lowMultiplier);
+    const __m256d midM = _mm256_set1_pd(shape.midMultiplier);
+    const __m256d highM = _mm256_set1_pd(shape.highMultiplier);
+    const __m256d lowSpan = _mm256_set1_pd(shape.midMultiplier - shape.lowMultiplier);
+    const __m256d highSpan = _mm256_set1_pd(shape.highMultiplier - shape.midMultiplier);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d three = _mm256_set1_pd(3.0);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(xs + i);
+        __m256d y = _mm256_loadu_pd(ys + i);
+        __m256d v = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)));
+        _mm256_storeu_pd(vs + i, v);
+        if (shape.linear) continue;
+
+        __m256d t = _mm256_div_pd(_mm256_sub_pd(v, lowT), span);
+        __m256d lt = _mm256_mul_pd(t, two);
+        __m256d ls = _mm256_mul_pd(_mm256_mul_pd(lt, lt), _mm256_sub_pd(three, _mm256_mul_pd(two, lt)));
+        __m256d lower = _mm256_add_pd(lowM, _mm256_mul_pd(lowSpan, ls));
+        __m256d ht = _mm256_mul_pd(_mm256_sub_pd(t, half), two);
+        __m256d hs = _mm256_mul_pd(_mm256_mul_pd(ht, ht), _mm256_sub_pd(three, _mm256_mul_pd(two, ht)));
+        __m256d upper = _mm256_add_pd(midM, _mm256_mul_pd(highSpan, hs));
+
+        __m256d c = _mm256_blendv_pd(upper, lower, _mm256_cmp_pd(t, half, _CMP_LT_OQ));
+        c = _mm256_blendv_pd(c, highM, _mm256_cmp_pd(v, highT, _CMP_GE_OQ));
+        c = _mm256_blendv_pd(c, lowM, _mm256_cmp_pd(v, lowT, _CMP_LE_OQ));
+
+        _mm256_storeu_pd(xs + i, _mm256_mul_pd(x, c));
+        _mm256_storeu_pd(ys + i, _mm256_mul_pd(y, c));
+    }
+    applyCurveScalar(xs, ys, vs, i, n, shape);
+}
+
+NEOZ_TARGET("avx2")
+void applyLutAvx2(double* xs, double* ys, double* vs, std::size_t n,
+                  const VelocityCurve::Table& table)
+{
+    using Table = VelocityCurve::Table;
+    const double* values = table.values.data();
+    const __m256d invStep = _mm256_set1_pd(table.invStep);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d size = _mm256_set1_pd(static_cast<double>(Table::SIZE));
+    const __m128i lastIndex = _mm_set1_epi32(Table::SIZE - 1);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(xs + i);
+        __m256d y = _mm256_loadu_pd(ys + i);
+        __m256d v = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)));
+        _mm256_storeu_pd(vs + i, v);
+
+        // Same clamp/truncate/lerp sequence as Table::lookup()
+        __m256d pos = _mm256_min_pd(_mm256_max_pd(_mm256_mul_pd(v, invStep), zero), size);
+        __m128i idx = _mm_min_epi32(_mm256_cvttpd_epi32(pos), lastIndex);
+        __m256d frac = _mm256_sub_pd(pos, _mm256_cvtepi32_pd(idx));
+        __m256d a = _mm256_i32gather_pd(values, idx, 8);
+        __m256d b = _mm256_i32gather_pd(values + 1, idx, 8);
+        __m256d c = _mm256_add_pd(a, _mm256_mul_pd(_mm256_sub_pd(b, a), frac));
+
+        _mm256_storeu_pd(xs + i, _mm256_mul_pd(x, c));
+        _mm256_storeu_pd(ys + i, _mm256_mul_pd(y, c));
+    }
+    applyLutScalar(xs, ys, vs, i, n, table);
+}
+
+NEOZ_TARGET("avx2")
+void applySlowZoneAvx2(double* xs, double* ys, const double* vs, const double* dtMs,
+                       std::size_t n, double omegaThreshold)
+{
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d ms = _mm256_set1_pd(1000.0);
+    const __m256d fallbackDt = _mm256_set1_pd(FALLBACK_DT_SEC);
+    const __m256d thr = _mm256_set1_pd(omegaThreshold);
+    const __m256d minRatio = _mm256_set1_pd(SLOW_ZONE_MIN_RATIO);
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d d = _mm256_loadu_pd(dtMs + i);
+        __m256d dt = _mm256_blendv_pd(fallbackDt, _mm256_div_pd(d, ms), _mm256_cmp_pd(d, zero, _CMP_GT_OQ));
+        __m256d omega = _mm256_div_pd(_mm256_loadu_pd(vs + i), dt);
+        __m256d ratio = _mm256_div_pd(omega, thr);
+        ratio = _mm256_blendv_pd(ratio, minRatio, _mm256_cmp_pd(ratio, minRatio, _CMP_LT_OQ));
+        __m256d scale = _mm256_blendv_pd(one, _mm256_mul_pd(ratio, ratio),
+                                         _mm256_cmp_pd(omega, thr, _CMP_LT_OQ));
+        _mm256_storeu_pd(xs + i, _mm256_mul_pd(_mm256_loadu_pd(xs + i), scale));
+        _mm256_storeu_pd(ys + i, _mm256_mul_pd(_mm256_loadu_pd(ys + i), scale));
+    }
+    applySlowZoneScalar(xs, ys, vs, dtMs, i, n, omegaThreshold);
+}
+
+NEOZ_TARGET("avx2")
+void smoothingLambdasAvx2(const double* dtMs, double* lambdas, std::size_t n, double tau)
+{
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+    const __m256d vTau = _mm256_set1_pd(tau);
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d d = _mm256_loadu_pd(dtMs + i);
+        __m256d e = expNonPositiveAvx(_mm256_div_pd(_mm256_xor_pd(d, signBit), vTau));
+        _mm256_storeu_pd(lambdas + i, _mm256_and_pd(e, _mm256_cmp_pd(d, zero, _CMP_GT_OQ)));
+    }
+    smoothingLambdasScalar(dtMs, lambdas, i, n, tau);
+}
+
+#endif // NEOZ_KERNELS_X86
+
+} // namespace
+
+// ========== DISPATCH ==========
+
+PipelineKernels::Isa PipelineKernels::detected()
+{
+    static const Isa isa = []() {
+#if NEOZ_KERNELS_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4] = {};
+        __cpuid(info, 1);
+        const bool sse41 = (info[2] & (1 << 19)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        bool avx2 = false;
+        if (osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        const bool sse41 = __builtin_cpu_supports("sse4.1");
+        const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+        if (avx2) return Isa::AVX2;
+        if (sse41) return Isa::SSE41;
+#endif
+        return Isa::Scalar;
+    }();
+    return isa;
+}
+
+PipelineKernels::Isa PipelineKernels::activeIsa()
+{
+    int forced = g_isaOverride.load(std::memory_order_relaxed);
+    Isa best = detected();
+    if (forced < 0 || forced > static_cast<int>(best)) return best;
+    return static_cast<Isa>(forced);
+}
+
+void PipelineKernels::setIsaOverride(Isa isa)
+{
+    g_isaOverride.store(static_cast<int>(isa), std::memory_order_relaxed);
+}
+
+const char* PipelineKernels::isaName(Isa isa)
+{
+    switch (isa) {
+    case Isa::AVX2: return "AVX2";
+    case Isa::SSE41: return "SSE4.1";
+    case Isa::Scalar: break;
+    }
+    return "Scalar";
+}
+
+double PipelineKernels::expNonPositive(double x)
+{
+    if (!(x >= EXP_MIN_ARG)) return 0.0;  // Underflow (and NaN) → 0
+
+    double k = std::nearbyint(x * LOG2E);
+    double r = (x - k * LN2_HI) - k * LN2_LO;
+
+    double p = EXP_C[EXP_DEGREE];
+    for (int i = EXP_DEGREE - 1; i >= 0; --i) {
+        p = p * r + EXP_C[i];
+    }
+
+    // 2^k built directly in the exponent field (k ∈ [-1022, 0])
+    auto bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(k) + 1023) << 52;
+    return p * std::bit_cast<double>(bits);
+}
+
+void PipelineKernels::scaleAxes(double* xs, double* ys, std::size_t n,
+                                double dpi, double winScale, double resScale,
+                                double gainX, double gainY)
+{
+    switch (activeIsa()) {
+#if NEOZ_KERNELS_X86
+    case Isa::AVX2: scaleAxesAvx2(xs, ys, n, dpi, winScale, resScale, gainX, gainY); return;
+    case Isa::SSE41: scaleAxesSse41(xs, ys, n, dpi, winScale, resScale, gainX, gainY); return;
+#endif
+    default: scaleAxesScalar(xs, ys, 0, n, dpi, winScale, resScale, gainX, gainY); return;
+    }
+}
+
+void PipelineKernels::applyCurve(double* xs, double* ys, double* vs, std::size_t n,
+                                 const VelocityCurve::Table& curve)
+{
+    if (curve.useLut) {
+#if NEOZ_KERNELS_X86
+        if (activeIsa() == Isa::AVX2) {
+            applyLutAvx2(xs, ys, vs, n, curve);
+            return;
+        }
+#endif
+        applyLutScalar(xs, ys, vs, 0, n, curve);
+        return;
+    }
+
+    const VelocityCurve::Shape& shape = curve.shape;
+    switch (activeIsa()) {
+#if NEOZ_KERNELS_X86
+    case Isa::AVX2: applyCurveAvx2(xs, ys, vs, n, shape); return;
+    case Isa::SSE41: applyCurveSse41(xs, ys, vs, n, shape); return;
+#endif
+    default: applyCurveScalar(xs, ys, vs, 0, n, shape); return;
+    }
+}
+
+void PipelineKernels::applySlowZone(double* xs, double* ys, const double* vs,
+                                    const double* dtMs, std::size_t n,
+                                    double omegaThreshold)
+{
+    if (!(omegaThreshold > 0.0)) return;
+
+    switch (activeIsa()) {
+#if NEOZ_KERNELS_X86
+    case Isa::AVX2: applySlowZoneAvx2(xs, ys, vs, dtMs, n, omegaThreshold); return;
+    case Isa::SSE41: applySlowZoneSse41(xs, ys, vs, dtMs, n, omegaThreshold); return;
+#endif
+    default: applySlowZoneScalar(xs, ys, vs, dtMs, 0, n, omegaThreshold); return;
+    }
+}
+
+void PipelineKernels::smoothingLambdas(const double* dtMs, double* lambdas,
+                                       std::size_t n, double tau)
+{
+    if (!(tau > 0.0)) {
+        for (std::size_t i = 0; i < n; ++i) lambdas[i] = 0.0;
+        return;
+    }
+
+    switch (activeIsa()) {
+#if NEOZ_KERNELS_X86
+    case Isa::AVX2: smoothingLambdasAvx2(dtMs, lambdas, n, tau); return;
+    case Isa::SSE41: smoothingLambdasSse41(dtMs, lambdas, n, tau); return;
+#endif
+    default: smoothingLambdasScalar(dtMs, lambdas, 0, n, tau); return;
+    }
+}
+
+} // namespace NeoZ
@@ -0,0 +1,81 @@
+#ifndef NEOZ_PIPELINEKERNELS_H
+#define NEOZ_PIPELINEKERNELS_H
+
+#include "VelocityCurve.h"
+#include <cstddef>
+
+namespace NeoZ {
+
+/**
+ * @brief Vectorized batch kernels for the Precision Axis Control stages.
+ *
+ * Each kernel works in place over structure-of-arrays delta buffers and has
+ * three implementations selected at runtime:
+ * - AVX2    (4 doubles per op)
+ * - SSE4.1  (2 doubles per op)
+ * - Scalar  (reference, also used for loop tails and non-x86 builds)
+ *
+ * All implementations perform the same IEEE operations in the same order
+ * per element (no FMA contraction), so results are bit-identical across
+ * ISA levels. This class is stateless and thread-safe.
+ */
+class PipelineKernels
+{
+public:
+    enum class Isa {
+        Scalar,
+        SSE41,
+        AVX2
+    };
+
+    // Best ISA supported by this CPU (detected once), unless overridden
+    static Isa activeIsa();
+    static const char* isaName(Isa isa);
+
+    // Force a specific ISA (clamped to what the CPU supports).
+    // Intended for tests and benchmarks; pass detected() to clear.
+    static void setIsaOverride(Isa isa);
+    static Isa detected();
+
+    /**
+     * @brief Steps 1-4: DPI norm → Windows speed → resolution → axis gain.
+     * x = ((x / dpi) * winScale) * resScale * gain
+     */
+    static void scaleAxes(double* xs, double* ys, std::size_t n,
+                          double dpi, double winScale, double resScale,
+                          double gainX, double gainY);
+
+    /**
+     * @brief Step 5: velocity magnitude and C(v) velocity curve.
+     * Writes |Δ| to vs, then scales xs/ys by curve.evaluate(|Δ|).
+     * LUT mode uses AVX2 gathers; SSE4.1 falls back to scalar lookups.
+     */
+    static void applyCurve(double* xs, double* ys, double* vs, std::size_t n,
+                           const VelocityCurve::Table& curve);
+
+    /**
+     * @brief Step 6: slow zone attenuation.
+     * ω = v / Δt; if ω < ω_t: scale = max(ω/ω_t, 0.001)^2
+     */
+    static void applySlowZone(double* xs, double* ys, const double* vs,
+                              const double* dtMs, std::size_t n,
+                              double omegaThreshold);
+
+    /**
+     * @brief Step 7 (parallel part): smoothing weights λ = e^(-Δt/τ).
+     * λ = 0 when τ <= 0 or Δt <= 0. The λ-blend itself is a recurrence and
+     * stays sequential in the pipeline.
+     */
+    static void smoothingLambdas(const double* dtMs, double* lambdas,
+                                 std::size_t n, double tau);
+
+    /**
+     * @brief e^x for x <= 0, the reference for the vectorized exp.
+     * Cody-Waite reduction plus a degree-13 polynomial; ~1 ulp vs std::exp.
+     */
+    static double expNonPositive(double x);
+};
+
+} // namespace NeoZ
+
+#endif // NEOZ_PIPELINEKERNELS_H
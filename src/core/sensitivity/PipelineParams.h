@@ -0,0 +1,53 @@
+#ifndef NEOZ_PIPELINEPARAMS_H
+#define NEOZ_PIPELINEPARAMS_H
+
+#include <cstdint>
+
+namespace NeoZ {
+
+/**
+ * @brief Immutable snapshot of every value the input hot path reads.
+ *
+ * SensitivityPipeline setters run on the GUI thread, while process() runs
+ * on the hook thread. Setters never touch the hook thread's view directly:
+ * they build a complete PipelineParams and publish it through an RcuCell.
+ * process() loads the pointer once per event (or batch), so a reader
+ * always sees one consistent generation of settings with no locks and
+ * no torn doubles.
+ *
+ * Derived values (gains, τ, ω threshold) are precomputed at publish time
+ * so the hot path does no pow() on settings.
+ */
+struct alignas(64) PipelineParams
+{
+    // Master gates
+    bool inputAuthorityEnabled = false;
+    bool simulateMode = false;
+    bool adbMode = false;
+    bool safeZoneClampEnabled = true;
+
+    // Steps 1-4: DPI norm, Windows speed, resolution, axis gains
+    double mouseDpi = 800.0;
+    double windowsPointerScale = 1.0;
+    double resolutionScale = 1.0;      // Already 1.0 when not in ADB mode
+    double gainX = 1.0;                // 1 + k * M_x
+    double gainY = 1.0;
+
+    // Step 6: slow zone threshold ω_t = ω_max * slowZone
+    double omegaThreshold = 100.0;
+
+    // Step 7: smoothing τ = max(1, S^1.35), 0 = off
+    double smoothingTau = 0.0;
+
+    // Step 9: final multipliers
+    double sensitivityX = 1.0;
+    double sensitivityY = 1.0;
+
+    // Bumped when hook-thread filter state (smoothing, drag history)
+    // must be cleared, e.g. by resetToDefaults()
+    uint64_t stateEpoch = 0;
+};
+
+} // namespace NeoZ
+
+#endif // NEOZ_PIPELINEPARAMS_H
@@ -1,6 +1,9 @@
 #include "SensitivityPipeline.h"
+#include "PipelineKernels.h"
 #include "../input/WindowsInputReader.h"
 #include <QDebug>
+#include <QThread>
+#include <algorithm>
 #include <cmath>
 
 namespace NeoZ {
@@ -10,6 +13,7 @@ SensitivityPipeline::SensitivityPipeline(QObject* parent)
     , m_velocityCurve(std::make_unique<VelocityCurve>(this))
     , m_hostNormalizer(std::make_unique<HostNormalizer>(this))
     , m_emulatorTranslator(std::make_unique<EmulatorTranslator>(this))
+    , m_drcs(std::make_unique<DRCS>(this))
 {
     // Connect sub-component signals
     connect(m_velocityCurve.get(), &VelocityCurve::curveChanged,
@@ -26,8 +30,13 @@ SensitivityPipeline::SensitivityPipeline(QObject* parent)
                 emit presetConfidenceChanged();
             });
     
+    // Working set for at least a single event (process() never allocates)
+    m_batch.ensureCapacity(1);
+    
+    // Initial hook-thread view of the defaults
+    publishParams();
+    
     // Start timers
-    m_smoothingTimer.start();
     m_latencyTimer.start();
     
     qDebug() << "[SensitivityPipeline] Initialized with Input Authority OFF (safe mode)";
@@ -40,152 +49,243 @@ InputState SensitivityPipeline::process(const InputState& rawInput)
     // Start latency measurement
     m_latencyTimer.restart();
     
+    // One consistent generation of settings for the whole event
+    auto params = m_params.read();
+    
     // ===== INPUT AUTHORITY GATE =====
     // When OFF, pass through raw input unmodified (safe mode)
-    if (!m_inputAuthorityEnabled || m_simulateMode) {
+    if (!params->inputAuthorityEnabled || params->simulateMode) {
         InputState passthrough = rawInput;
         passthrough.velocity = std::sqrt(rawInput.deltaX * rawInput.deltaX + rawInput.deltaY * rawInput.deltaY);
-        emit inputProcessed(passthrough);
+        passthrough.stage = InputState::Raw;
+        publishResult(passthrough, 0, -1.0);
         return passthrough;
     }
     
-    // ===== NEO-Z PRECISION AXIS CONTROL PIPELINE =====
-    // Raw Δ → DPI norm → Win speed → Res norm → X/Y mult → Curve → Slow Zone → Smoothing → Drag Limit → Output
+    // Single-event batch: Δt from the event timestamp
+    m_batch.x[0] = rawInput.deltaX;
+    m_batch.y[0] = rawInput.deltaY;
+    m_batch.dtMs[0] = m_clock.advance(rawInput);
     
-    double deltaX = rawInput.deltaX;
-    double deltaY = rawInput.deltaY;
+    runStages(1, *params);
     
-    // Step 1: DPI normalization (convert counts to inches)
-    double dpiNormX = deltaX / static_cast<double>(m_mouseDpi);
-    double dpiNormY = deltaY / static_cast<double>(m_mouseDpi);
+    // Measure latency
+    const double latencyMs = m_latencyTimer.nsecsElapsed() / 1000000.0;
     
-    // Step 2: Windows cursor speed scaling
-    double winSpeedScale = m_hostNormalizer->windowsPointerScale();
-    double winScaledX = dpiNormX * winSpeedScale;
-    double winScaledY = dpiNormY * winSpeedScale;
+    // Build output state
+    InputState result;
+    result.deltaX = m_batch.x[0];
+    result.deltaY = m_batch.y[0];
+    result.velocity = m_batch.velocity[0];
+    result.timestamp = rawInput.timestamp;
+    result.stage = InputState::Raw;
     
-    // Step 3: Resolution normalization (Emulator Translation)
-    // Desktop Mode: Assistive shaping (no emulator scaling)
-    // ADB Mode: Full control (apply emulator resolution scaling)
-    double resScale = 1.0;
-    if (m_adbMode) {
-        resScale = m_emulatorTranslator->resolutionScale();
-    }
+    publishResult(result, 0, latencyMs);
     
-    double resNormX = winScaledX * resScale;
-    double resNormY = winScaledY * resScale;
+    return result;
+}
+
+void SensitivityPipeline::processBatch(std::span<const InputState> rawInputs, std::span<InputState> outputs)
+{
+    const size_t n = std::min(rawInputs.size(), outputs.size());
+    if (n == 0) return;
     
-    // Step 4: Apply center-zero axis multipliers
-    double axisX = resNormX * gainX();
-    double axisY = resNormY * gainY();
+    m_latencyTimer.restart();
     
-    // Step 5: Calculate velocity and apply curve
-    double velocity = std::sqrt(axisX * axisX + axisY * axisY);
-    double curveValue = m_velocityCurve->apply(velocity);
-    double curvedX = axisX * curveValue;
-    double curvedY = axisY * curveValue;
+    // One consistent generation of settings for the whole batch
+    auto params = m_params.read();
     
-    // Step 6: SLOW ZONE (AIM ASSIST FRIENDLY)
-    // Free Fire aim assist engages when angular velocity is low.
-    // We punish over-drag to prevent breaking aim assist.
+    // ===== INPUT AUTHORITY GATE =====
+    if (!params->inputAuthorityEnabled || params->simulateMode) {
+        for (size_t i = 0; i < n; ++i) {
+            const InputState& raw = rawInputs[i];
+            outputs[i] = raw;
+            outputs[i].velocity = std::sqrt(raw.deltaX * raw.deltaX + raw.deltaY * raw.deltaY);
+            outputs[i].stage = InputState::Raw;
+        }
+        publishResult(outputs[n - 1], static_cast<int>(n), -1.0);
+        return;
+    }
     
-    // 6a. Compute angular velocity: ω = |Δθ| / Δt
-    qint64 elapsedMs = m_smoothingTimer.elapsed();
-    m_smoothingTimer.restart();
+    // Scatter AoS input into the SoA working set (Δt from event timestamps,
+    // exactly as process() would see them one by one)
+    m_batch.ensureCapacity(n);
+    for (size_t i = 0; i < n; ++i) {
+        m_batch.x[i] = rawInputs[i].deltaX;
+        m_batch.y[i] = rawInputs[i].deltaY;
+        m_batch.dtMs[i] = m_clock.advance(rawInputs[i]);
+    }
     
-    double dt = (elapsedMs > 0) ? (elapsedMs / 1000.0) : 0.001; // Avoid divide by zero
-    double angularVelocity = velocity / dt; // velocity is |Δθ|
+    runStages(n, *params);
     
-    // 6b. Define slow zone threshold
-    // ω_threshold = ω_max * slowZone
-    // ω_max ≈ 500 deg/s (typical fast flick)
-    constexpr double OMEGA_MAX = 500.0; 
-    double omegaThreshold = OMEGA_MAX * (m_slowZonePercent / 100.0);
+    // Gather back into AoS output
+    for (size_t i = 0; i < n; ++i) {
+        InputState& out = outputs[i];
+        out.deltaX = m_batch.x[i];
+        out.deltaY = m_batch.y[i];
+        out.velocity = m_batch.velocity[i];
+        out.timestamp = rawInputs[i].timestamp;
+        out.stage = InputState::Raw;
+    }
     
-    double slowZoneX = curvedX;
-    double slowZoneY = curvedY;
+    // Aggregated signals: per-event average latency, last state for telemetry
+    const double latencyMs = m_latencyTimer.nsecsElapsed() / 1000000.0 / static_cast<double>(n);
+    publishResult(outputs[n - 1], static_cast<int>(n), latencyMs);
+}
+
+void SensitivityPipeline::publishResult(const InputState& last, int count, double latencyMs)
+{
+    if (latencyMs >= 0.0) {
+        m_latencyMs.store(latencyMs, std::memory_order_relaxed);
+    }
     
-    // 6c. Apply exponential damping
-    // if ω < ω_threshold: scale = (ω / ω_threshold)^γ
-    // γ = 1.6 - 2.2 (tunable, using 2.0 as sweet spot)
-    constexpr double GAMMA = 2.0;
+    // Owner thread (GUI, tests): plain synchronous signals
+    if (QThread::currentThread() == thread()) {
+        if (latencyMs >= 0.0) emit latencyChanged();
+        emit inputProcessed(last);
+        if (count > 0) emit batchProcessed(count);
+        return;
+    }
     
-    if (angularVelocity < omegaThreshold && omegaThreshold > 0.0) {
-        double ratio = angularVelocity / omegaThreshold;
-        // Ensure ratio is not zero to avoid issues, though mathematically 0^2 is 0
-        if (ratio < 0.001) ratio = 0.001;
-        
-        double scale = std::pow(ratio, GAMMA);
-        
-        // Apply scaling ("sticky but smooth")
-        slowZoneX = curvedX * scale;
-        slowZoneY = curvedY * scale;
+    // Hook/worker thread: receivers live on the owner thread, so never emit
+    // here. Post one notification and fold everything until it runs into it.
+    m_pendingCount.fetch_add(count, std::memory_order_relaxed);
+    if (m_notifyPending.exchange(true, std::memory_order_acq_rel)) return;
+    
+    QMetaObject::invokeMethod(this, [this, last]() {
+        m_notifyPending.store(false, std::memory_order_release);
+        const int pending = m_pendingCount.exchange(0, std::memory_order_relaxed);
+        emit latencyChanged();
+        emit inputProcessed(last);
+        if (pending > 0) emit batchProcessed(pending);
+    }, Qt::QueuedConnection);
+}
+
+void SensitivityPipeline::runStages(size_t n, const PipelineParams& params)
+{
+    // ===== NEO-Z PRECISION AXIS CONTROL PIPELINE =====
+    // Raw Δ → DPI norm → Win speed → Res norm → X/Y mult → Curve → Slow Zone → Smoothing → Drag Limit/DRCS → Output
+    // Each stage is a pass over the SoA buffers. Element-wise stages run in
+    // PipelineKernels (AVX2/SSE4.1/scalar, bit-identical across ISA levels).
+    
+    double* xs = m_batch.x.data();
+    double* ys = m_batch.y.data();
+    double* vs = m_batch.velocity.data();
+    const double* dtMs = m_batch.dtMs.data();
+    double* lambdas = m_batch.lambda.data();
+    
+    // Filter state reset requested from the GUI thread
+    if (params.stateEpoch != m_appliedStateEpoch) {
+        m_prevDeltaX = 0.0;
+        m_prevDeltaY = 0.0;
+        m_dragHistoryCount = 0;
+        m_appliedStateEpoch = params.stateEpoch;
     }
     
+    // Raw counts, kept for DRCS detection
+    std::copy(xs, xs + n, m_batch.rawX.data());
+    std::copy(ys, ys + n, m_batch.rawY.data());
+    
+    // Steps 1-4: DPI normalization (counts → inches), Windows cursor speed,
+    // resolution normalization, center-zero axis multipliers.
+    // Desktop Mode: Assistive shaping (no emulator scaling)
+    // ADB Mode: Full control (apply emulator resolution scaling)
+    PipelineKernels::scaleAxes(xs, ys, n, params.mouseDpi,
+                               params.windowsPointerScale, params.resolutionScale,
+                               params.gainX, params.gainY);
+    
+    // Step 5: Calculate velocity and apply curve
+    {
+        auto curve = m_velocityCurve->snapshot();
+        PipelineKernels::applyCurve(xs, ys, vs, n, *curve);
+    }
+    
+    // Step 6: SLOW ZONE (AIM ASSIST FRIENDLY)
+    // Free Fire aim assist engages when angular velocity is low.
+    // We punish over-drag to prevent breaking aim assist.
+    //   ω = |Δθ| / Δt,  ω_threshold = ω_max * slowZone  (ω_max ≈ 500 deg/s, typical fast flick)
+    //   if ω < ω_threshold: scale = (ω / ω_threshold)^γ  (γ = 2.0 sweet spot of 1.6 - 2.2)
+    PipelineKernels::applySlowZone(xs, ys, vs, dtMs, n, params.omegaThreshold);
+    
     // Step 7: Time-based smoothing with non-linear τ
-    // τ = max(1, S^1.35) where S is smoothingMs
-    // λ = e^(-Δt/τ)
-    // Note: elapsedMs is already captured above
-    
-    double tau = smoothingTau();  // Uses non-linear mapping
-    double lambda = 0.0;
-    if (tau > 0.0 && elapsedMs > 0) {
-        lambda = std::exp(-static_cast<double>(elapsedMs) / tau);
+    // τ = max(1, S^1.35) where S is smoothingMs, λ = e^(-Δt/τ)
+    // λ is computed in parallel; the blend is a recurrence and stays sequential.
+    PipelineKernels::smoothingLambdas(dtMs, lambdas, n, params.smoothingTau);
+    for (size_t i = 0; i < n; ++i) {
+        double lambda = lambdas[i];
+        double smoothedX = lambda * m_prevDeltaX + (1.0 - lambda) * xs[i];
+        double smoothedY = lambda * m_prevDeltaY + (1.0 - lambda) * ys[i];
+        
+        m_prevDeltaX = smoothedX;
+        m_prevDeltaY = smoothedY;
+        xs[i] = smoothedX;
+        ys[i] = smoothedY;
     }
     
-    double smoothedX = lambda * m_prevDeltaX + (1.0 - lambda) * slowZoneX;
-    double smoothedY = lambda * m_prevDeltaY + (1.0 - lambda) * slowZoneY;
-    
-    m_prevDeltaX = smoothedX;
-    m_prevDeltaY = smoothedY;
-    
-    // Step 8: REPETITION DRAG LIMITER
-    // Detect repetitive movement patterns and apply damping
-    double dragX = smoothedX;
-    double dragY = smoothedY;
-    if (m_dragHistory.size() >= 2) {
-        auto& last = m_dragHistory.back();
-        double magnitude = std::sqrt(smoothedX * smoothedX + smoothedY * smoothedY);
-        double lastMag = std::sqrt(last.first * last.first + last.second * last.second);
-        if (magnitude > 0.001 && lastMag > 0.001) {
-            // Cosine similarity
-            double dot = smoothedX * last.first + smoothedY * last.second;
-            double similarity = dot / (magnitude * lastMag);
-            if (similarity > DRAG_SIMILARITY_THRESHOLD) {
-                dragX *= DRAG_DAMPING;
-                dragY *= DRAG_DAMPING;
+    // Step 8: REPETITION CONSTRAINT
+    // DRCS when enabled: detects on the raw mouse counts (its thresholds are
+    // tuned for those) and scales the smoothed deltas. Otherwise the
+    // repetition drag limiter damps drags that repeat the previous one.
+    // The limiter history tracks every event so toggling DRCS resumes it
+    // with current state.
+    const bool drcsApplied = m_drcs->applyBatch(m_batch.rawX.data(), m_batch.rawY.data(), xs, ys, n);
+    for (size_t i = 0; i < n; ++i) {
+        double smoothedX = xs[i];
+        double smoothedY = ys[i];
+        if (!drcsApplied && m_dragHistoryCount >= 2) {
+            double magnitude = std::sqrt(smoothedX * smoothedX + smoothedY * smoothedY);
+            double lastMag = std::sqrt(m_dragLastX * m_dragLastX + m_dragLastY * m_dragLastY);
+            if (magnitude > 0.001 && lastMag > 0.001) {
+                // Cosine similarity
+                double dot = smoothedX * m_dragLastX + smoothedY * m_dragLastY;
+                double similarity = dot / (magnitude * lastMag);
+                if (similarity > DRAG_SIMILARITY_THRESHOLD) {
+                    xs[i] *= DRAG_DAMPING;
+                    ys[i] *= DRAG_DAMPING;
+                }
             }
         }
-    }
-    m_dragHistory.push_back({smoothedX, smoothedY});
-    while (m_dragHistory.size() > DRAG_HISTORY_SIZE) {
-        m_dragHistory.pop_front();
+        m_dragLastX = smoothedX;
+        m_dragLastY = smoothedY;
+        m_dragHistoryCount = std::min(m_dragHistoryCount + 1, 2);
     }
     
     // Step 9: Apply final sensitivity multipliers (clamped if safe zone enabled)
-    double finalX = dragX * m_sensitivityX;
-    double finalY = dragY * m_sensitivityY;
-    
-    if (m_safeZoneClampEnabled) {
+    for (size_t i = 0; i < n; ++i) {
+        xs[i] *= params.sensitivityX;
+        ys[i] *= params.sensitivityY;
+    }
+    if (params.safeZoneClampEnabled) {
         // Clamp to prevent overshoot
-        finalX = qBound(-100.0, finalX, 100.0);
-        finalY = qBound(-100.0, finalY, 100.0);
+        for (size_t i = 0; i < n; ++i) {
+            xs[i] = qBound(-100.0, xs[i], 100.0);
+            ys[i] = qBound(-100.0, ys[i], 100.0);
+        }
     }
-    
-    // Measure latency
-    m_latencyMs = m_latencyTimer.nsecsElapsed() / 1000000.0;
-    emit latencyChanged();
-    
-    // Build output state
-    InputState result;
-    result.deltaX = finalX;
-    result.deltaY = finalY;
-    result.velocity = velocity;
-    result.timestamp = rawInput.timestamp;
-    
-    emit inputProcessed(result);
-    
-    return result;
+}
+
+void SensitivityPipeline::publishParams()
+{
+    // ω_max ≈ 500 deg/s (typical fast flick)
+    constexpr double OMEGA_MAX = 500.0;
+    
+    auto params = std::make_unique<PipelineParams>();
+    params->inputAuthorityEnabled = m_inputAuthorityEnabled;
+    params->simulateMode = m_simulateMode;
+    params->adbMode = m_adbMode;
+    params->safeZoneClampEnabled = m_safeZoneClampEnabled;
+    params->mouseDpi = static_cast<double>(m_mouseDpi);
+    params->windowsPointerScale = m_hostNormalizer->windowsPointerScale();
+    params->resolutionScale = m_adbMode ? m_emulatorTranslator->resolutionScale() : 1.0;
+    params->gainX = gainX();
+    params->gainY = gainY();
+    params->omegaThreshold = OMEGA_MAX * (m_slowZonePercent / 100.0);
+    params->smoothingTau = smoothingTau();
+    params->sensitivityX = m_sensitivityX;
+    params->sensitivityY = m_sensitivityY;
+    params->stateEpoch = m_stateEpoch;
+    
+    m_params.publish(std::move(params));
 }
 
 SensitivityCalculator::Parameters SensitivityPipeline::buildParameters(double velocity) const
@@ -237,6 +337,7 @@ void SensitivityPipeline::setInputAuthorityEnabled(bool enabled)
     if (m_inputAuthorityEnabled == enabled) return;
     m_inputAuthorityEnabled = enabled;
     qDebug() << "[SensitivityPipeline] Input Authority:" << (enabled ? "ENABLED" : "DISABLED (safe mode)");
+    publishParams();
     emit inputAuthorityChanged();
 }
 
@@ -245,6 +346,7 @@ void SensitivityPipeline::setSafeZoneClampEnabled(bool enabled)
     if (m_safeZoneClampEnabled == enabled) return;
     m_safeZoneClampEnabled = enabled;
     qDebug() << "[SensitivityPipeline] Safe Zone Clamp:" << (enabled ? "ON" : "OFF");
+    publishParams();
     emit settingsChanged();
 }
 
@@ -254,6 +356,7 @@ void SensitivityPipeline::setSensitivityX(double value)
     if (qFuzzyCompare(m_sensitivityX, value)) return;
     m_sensitivityX = value;
     qDebug() << "[SensitivityPipeline] Sensitivity X:" << value;
+    publishParams();
     emit settingsChanged();
 }
 
@@ -263,6 +366,7 @@ void SensitivityPipeline::setSensitivityY(double value)
     if (qFuzzyCompare(m_sensitivityY, value)) return;
     m_sensitivityY = value;
     qDebug() << "[SensitivityPipeline] Sensitivity Y:" << value;
+    publishParams();
     emit settingsChanged();
 }
 
@@ -273,6 +377,7 @@ void SensitivityPipeline::setMouseDpi(int dpi)
     m_mouseDpi = dpi;
     m_hostNormalizer->setMouseDpi(dpi);
     qDebug() << "[SensitivityPipeline] Mouse DPI:" << dpi;
+    publishParams();
     emit settingsChanged();
 }
 
@@ -282,6 +387,7 @@ void SensitivityPipeline::setAxisMultiplierX(double value)
     if (qFuzzyCompare(m_axisMultiplierX, value)) return;
     m_axisMultiplierX = value;
     qDebug() << "[SensitivityPipeline] Axis Multiplier X:" << value << "-> Gain:" << gainX();
+    publishParams();
     emit settingsChanged();
 }
 
@@ -291,6 +397,7 @@ void SensitivityPipeline::setAxisMultiplierY(double value)
     if (qFuzzyCompare(m_axisMultiplierY, value)) return;
     m_axisMultiplierY = value;
     qDebug() << "[SensitivityPipeline] Axis Multiplier Y:" << value << "-> Gain:" << gainY();
+    publishParams();
     emit settingsChanged();
 }
 
@@ -300,6 +407,7 @@ void SensitivityPipeline::setGainFactor(double value)
     if (qFuzzyCompare(m_gainFactor, value)) return;
     m_gainFactor = value;
     qDebug() << "[SensitivityPipeline] Gain Factor (k):" << value;
+    publishParams();
     emit settingsChanged();
 }
 
@@ -324,6 +432,7 @@ void SensitivityPipeline::setSmoothingMs(double value)
     else label = "Training";
     
     qDebug() << "[SensitivityPipeline] Smoothing:" << value << "ms (τ=" << smoothingTau() << ") [" << label << "]";
+    publishParams();
     emit settingsChanged();
 }
 
@@ -341,6 +450,7 @@ void SensitivityPipeline::setSlowZonePercent(double value)
     else label = "Sticky";
     
     qDebug() << "[SensitivityPipeline] Slow Zone:" << value << "% [" << label << "]";
+    publishParams();
     emit settingsChanged();
 }
 
@@ -374,8 +484,8 @@ void SensitivityPipeline::resetToDefaults()
     m_gainFactor = 0.6;
     m_smoothingMs = 16.0;
     m_slowZonePercent = 20.0;  // Headshot sweet spot
-    m_prevDeltaX = 0.0;
-    m_prevDeltaY = 0.0;
+    ++m_stateEpoch;            // Hook thread clears smoothing/drag state
+    m_drcs->reset();           // ...and DRCS history
     
     m_velocityCurve->applyPreset(VelocityCurve::Linear);
     m_hostNormalizer->setMouseDpi(800);
@@ -383,12 +493,15 @@ void SensitivityPipeline::resetToDefaults()
     m_hostNormalizer->setAccelerationEnabled(false);
     m_emulatorTranslator->applyPreset(EmulatorTranslator::Unknown);
     
+    publishParams();
+    
     qDebug() << "[SensitivityPipeline] Reset to defaults (Precision Axis Control)";
     emit settingsChanged();
 }
 
 void SensitivityPipeline::onSubComponentChanged()
 {
+    publishParams();
     emit settingsChanged();
     emit pipelineRecalculated();
 }
@@ -426,12 +539,14 @@ void SensitivityPipeline::rollback()
     m_hostNormalizer->setMouseDpi(m_mouseDpi);
     
     qDebug() << "[SensitivityPipeline] Rolled back to snapshot";
+    publishParams();
     emit settingsChanged();
 }
 
 void SensitivityPipeline::enableSimulateMode(bool enable)
 {
     m_simulateMode = enable;
+    publishParams();
     qDebug() << "[SensitivityPipeline] Simulate mode:" << (enable ? "ON" : "OFF");
 }
 
@@ -440,6 +555,7 @@ void SensitivityPipeline::setAdbMode(bool enabled)
     if (m_adbMode == enabled) return;
     m_adbMode = enabled;
     qDebug() << "[SensitivityPipeline] ADB Mode:" << (enabled ? "ON (Full Control)" : "OFF (Assistive Shaping)");
+    publishParams();
     emit settingsChanged();
 }
 
@@ -3,13 +3,19 @@
 
 #include <QObject>
 #include <QElapsedTimer>
+#include <atomic>
 #include <memory>
-#include <deque>
+#include <span>
+#include <vector>
 #include "../input/InputState.h"
 #include "VelocityCurve.h"
 #include "HostNormalizer.h"
 #include "EmulatorTranslator.h"
 #include "SensitivityCalculator.h"
+#include "DRCS.h"
+#include "PipelineParams.h"
+#include "PipelineClock.h"
+#include "../perf/RcuCell.hpp"
 
 namespace NeoZ {
 
@@ -26,8 +32,13 @@ class WindowsInputReader;
  *   At M=0, gain is neutral (1.0)
  * 
  * Time-Based Smoothing:
- *   λ = e^(-Δt/τ)
+ *   λ = e^(-Δt/τ), Δt from event timestamps (ns resolution, see PipelineClock)
  *   Δ_final = λ * Δ_prev + (1-λ) * Δ_curve
+ * 
+ * Threading: setters/getters belong to the GUI thread; process() runs on
+ * the hook thread and only reads the published PipelineParams snapshot.
+ * Results are published through an atomic latency and, off the owner
+ * thread, a coalesced queued notification (see publishResult()).
  */
 class SensitivityPipeline : public QObject
 {
@@ -65,6 +76,7 @@ class SensitivityPipeline : public QObject
     Q_PROPERTY(NeoZ::VelocityCurve* velocityCurve READ velocityCurve CONSTANT)
     Q_PROPERTY(NeoZ::HostNormalizer* hostNormalizer READ hostNormalizer CONSTANT)
     Q_PROPERTY(NeoZ::EmulatorTranslator* emulatorTranslator READ emulatorTranslator CONSTANT)
+    Q_PROPERTY(DRCS* drcs READ drcs CONSTANT)
     
     // Computed values
     Q_PROPERTY(double effectiveSensitivity READ effectiveSensitivity NOTIFY settingsChanged)
@@ -79,6 +91,13 @@ public:
     // Process input through the full pipeline
     InputState process(const InputState& rawInput);
     
+    // Process a batch of coalesced events through the full pipeline.
+    // Output is bit-identical to calling process() per event; signals are
+    // emitted once per batch instead of once per event (fewer when called
+    // off the owner thread, see publishResult()).
+    // outputs.size() must be >= rawInputs.size().
+    void processBatch(std::span<const InputState> rawInputs, std::span<InputState> outputs);
+    
     // Getters
     double sensitivityX() const { return m_sensitivityX; }
     double sensitivityY() const { return m_sensitivityY; }
@@ -86,7 +105,7 @@ public:
     
     // Input Authority getters
     bool inputAuthorityEnabled() const { return m_inputAuthorityEnabled; }
-    double latencyMs() const { return m_latencyMs; }
+    double latencyMs() const { return m_latencyMs.load(std::memory_order_relaxed); }
     bool safeZoneClampEnabled() const { return m_safeZoneClampEnabled; }
     int presetConfidence() const { return m_presetConfidence; }
     double effectiveAngularSensitivity() const;  // Degrees per cm
@@ -108,6 +127,7 @@ public:
     VelocityCurve* velocityCurve() const { return m_velocityCurve.get(); }
     HostNormalizer* hostNormalizer() const { return m_hostNormalizer.get(); }
     EmulatorTranslator* emulatorTranslator() const { return m_emulatorTranslator.get(); }
+    DRCS* drcs() const { return m_drcs.get(); }
     
     double effectiveSensitivity() const;
     double cm360() const;
@@ -148,9 +168,16 @@ public:
     Q_INVOKABLE void enableSimulateMode(bool enable);
     bool isSimulating() const { return m_simulateMode; }
     
+    // Event-time clock (Δt from InputState::timestamp). The time source only
+    // stamps events without a timestamp; swap it in tests and replay.
+    // Call from the thread that runs process().
+    void setTimeSource(TimeSource source) { m_clock.setTimeSource(std::move(source)); }
+    PipelineClock& clock() { return m_clock; }
+    
 signals:
     void settingsChanged();
     void inputProcessed(const InputState& finalState);
+    void batchProcessed(int count);
     void pipelineRecalculated();
     void inputAuthorityChanged();
     void latencyChanged();
@@ -160,10 +187,31 @@ private slots:
     void onSubComponentChanged();
     
 private:
+    // Runs all pipeline stages over the first n entries of m_batch in place.
+    // Shared by process() and processBatch() so both paths are bit-identical.
+    void runStages(size_t n, const PipelineParams& params);
+    
+    // Build a PipelineParams from the current settings and publish it to the
+    // hook thread. Called by every setter (GUI thread).
+    void publishParams();
+    
+    // Publish a processed event/batch. latencyMs < 0 leaves the latency
+    // unchanged. On the owner thread the signals are emitted directly;
+    // from the hook or worker thread they are posted to the owner thread,
+    // with at most one notification in flight (counts are accumulated until
+    // delivery; the state is the one that posted the notification).
+    void publishResult(const InputState& last, int count, double latencyMs);
+    
+    // Hook-thread view of the settings
+    RcuCell<PipelineParams> m_params;
+    uint64_t m_stateEpoch = 0;          // Last epoch requested (GUI thread)
+    uint64_t m_appliedStateEpoch = 0;   // Last epoch applied (hook thread)
+    
     // Components
     std::unique_ptr<VelocityCurve> m_velocityCurve;
     std::unique_ptr<HostNormalizer> m_hostNormalizer;
     std::unique_ptr<EmulatorTranslator> m_emulatorTranslator;
+    std::unique_ptr<DRCS> m_drcs;  // Step 8 when enabled (replaces the drag limiter)
     
     // Direct parameters
     double m_sensitivityX = 1.0;
@@ -177,9 +225,11 @@ private:
     
     // Time-based smoothing (extended range 0-200ms)
     double m_smoothingMs = 16.0;     // UI value in ms (0-200)
+    
+    // Hook-thread filter state (reset via PipelineParams::stateEpoch)
     double m_prevDeltaX = 0.0;
     double m_prevDeltaY = 0.0;
-    QElapsedTimer m_smoothingTimer;
+    PipelineClock m_clock;
     
     // Slow zone (1-100%)
     double m_slowZonePercent = 20.0;  // Default 20% - headshot sweet spot
@@ -189,14 +239,44 @@ private:
     // ========== INPUT AUTHORITY STATE ==========
     bool m_inputAuthorityEnabled = false;  // OFF by default (safe mode)
     bool m_adbMode = false;                // OFF by default (Desktop/Assistive)
-    double m_latencyMs = 0.0;
+    std::atomic<double> m_latencyMs{0.0};  // Written by the processing thread
     bool m_safeZoneClampEnabled = true;    // ON by default (recommended)
     int m_presetConfidence = 0;            // 0=Native, 1=Scaled, 2=Mismatch
     QElapsedTimer m_latencyTimer;
     
-    // Repetition Drag Limiter history buffer
-    std::deque<std::pair<double, double>> m_dragHistory;
-    static constexpr size_t DRAG_HISTORY_SIZE = 8;
+    // Cross-thread notification state (see publishResult())
+    std::atomic<bool> m_notifyPending{false};
+    std::atomic<int> m_pendingCount{0};
+    
+    // Structure-of-arrays working set for runStages(). Grown on demand and
+    // never shrunk, so steady-state processing does not allocate.
+    struct BatchBuffers {
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> rawX;      // Input counts (DRCS detection)
+        std::vector<double> rawY;
+        std::vector<double> velocity;
+        std::vector<double> dtMs;      // Δt since previous event (fractional ms)
+        std::vector<double> lambda;    // Smoothing weights e^(-Δt/τ)
+        
+        void ensureCapacity(size_t n) {
+            if (x.size() >= n) return;
+            x.resize(n);
+            y.resize(n);
+            rawX.resize(n);
+            rawY.resize(n);
+            velocity.resize(n);
+            dtMs.resize(n);
+            lambda.resize(n);
+        }
+    };
+    BatchBuffers m_batch;
+    
+    // Repetition Drag Limiter (Step 8 while DRCS is disabled): only the
+    // previous smoothed delta matters, so no history container
+    double m_dragLastX = 0.0;
+    double m_dragLastY = 0.0;
+    int m_dragHistoryCount = 0;      // Saturates at 2 (limiter engages)
     static constexpr double DRAG_SIMILARITY_THRESHOLD = 0.95;
     static constexpr double DRAG_DAMPING = 0.85;
     
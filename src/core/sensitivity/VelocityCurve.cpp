@@ -1,5 +1,6 @@
 #include "VelocityCurve.h"
 #include <cmath>
+#include <algorithm>
 #include <QDebug>
 
 namespace NeoZ {
@@ -7,56 +8,156 @@ namespace NeoZ {
 VelocityCurve::VelocityCurve(QObject* parent)
     : QObject(parent)
 {
+    // Connected before anything else so the table is current by the time
+    // other curveChanged listeners run
+    connect(this, &VelocityCurve::curveChanged, this, &VelocityCurve::rebuildTable);
+    
     applyPreset(Linear);
 }
 
 double VelocityCurve::apply(double velocity) const
 {
-    if (m_preset == Linear) {
-        return 1.0;
-    }
-    
-    return interpolate(velocity);
+    auto table = m_table.read();
+    return table->evaluate(velocity);
+}
+
+VelocityCurve::Shape VelocityCurve::shape() const
+{
+    Shape s;
+    s.linear = (m_preset == Linear);
+    s.lowThreshold = m_lowThreshold;
+    s.highThreshold = m_highThreshold;
+    s.lowMultiplier = m_lowMultiplier;
+    s.midMultiplier = m_midMultiplier;
+    s.highMultiplier = m_highMultiplier;
+    return s;
 }
 
 double VelocityCurve::interpolate(double velocity) const
 {
+    return shape().evaluate(velocity);
+}
+
+double VelocityCurve::Shape::evaluate(double velocity) const
+{
+    if (linear) {
+        return 1.0;
+    }
+    
     // Below low threshold: use low multiplier
-    if (velocity <= m_lowThreshold) {
-        return m_lowMultiplier;
+    if (velocity <= lowThreshold) {
+        return lowMultiplier;
     }
     
     // Above high threshold: use high multiplier
-    if (velocity >= m_highThreshold) {
-        return m_highMultiplier;
+    if (velocity >= highThreshold) {
+        return highMultiplier;
     }
     
     // In between: smooth S-curve interpolation
     // Normalized position in the transition zone [0, 1]
-    double t = (velocity - m_lowThreshold) / (m_highThreshold - m_lowThreshold);
-    
-    // Smoothstep function for S-curve: 3t² - 2t³
-    double s = t * t * (3.0 - 2.0 * t);
+    double t = (velocity - lowThreshold) / (highThreshold - lowThreshold);
     
-    // Two-stage interpolation:
+    // Two-stage smoothstep (3t² - 2t³) interpolation:
     // [low -> mid] for t in [0, 0.5]
     // [mid -> high] for t in [0.5, 1]
     if (t < 0.5) {
         double localT = t * 2.0; // Remap to [0, 1]
         double localS = localT * localT * (3.0 - 2.0 * localT);
-        return m_lowMultiplier + (m_midMultiplier - m_lowMultiplier) * localS;
+        return lowMultiplier + (midMultiplier - lowMultiplier) * localS;
     } else {
         double localT = (t - 0.5) * 2.0; // Remap to [0, 1]
         double localS = localT * localT * (3.0 - 2.0 * localT);
-        return m_midMultiplier + (m_highMultiplier - m_midMultiplier) * localS;
+        return midMultiplier + (highMultiplier - midMultiplier) * localS;
     }
 }
 
+double VelocityCurve::evaluateControlPoints(double velocity) const
+{
+    const QPointF& first = m_controlPoints.front();
+    const QPointF& last = m_controlPoints.back();
+    
+    if (velocity <= first.x()) return first.y();
+    if (velocity >= last.x()) return last.y();
+    
+    // Smoothstep between the two surrounding points (same segment shape
+    // as the preset curve's low→mid and mid→high halves)
+    auto upper = std::upper_bound(m_controlPoints.cbegin(), m_controlPoints.cend(), velocity,
+                                  [](double v, const QPointF& p) { return v < p.x(); });
+    const QPointF& b = *upper;
+    const QPointF& a = *(upper - 1);
+    
+    double span = b.x() - a.x();
+    if (span <= 0.0) return b.y();
+    
+    double localT = (velocity - a.x()) / span;
+    double localS = localT * localT * (3.0 - 2.0 * localT);
+    return a.y() + (b.y() - a.y()) * localS;
+}
+
+void VelocityCurve::rebuildTable()
+{
+    auto table = std::make_unique<Table>();
+    table->shape = shape();
+    
+    const bool hasPoints = m_controlPoints.size() >= 2;
+    table->useLut = m_lutEnabled || hasPoints;
+    
+    if (table->useLut) {
+        // Sample far enough that the last segment ends inside the table
+        double vMax = hasPoints ? m_controlPoints.back().x() : m_highThreshold;
+        vMax = std::max(vMax, 1e-6);
+        table->invStep = Table::SIZE / vMax;
+        
+        for (int i = 0; i <= Table::SIZE; ++i) {
+            double v = vMax * static_cast<double>(i) / Table::SIZE;
+            table->values[i] = hasPoints ? evaluateControlPoints(v) : table->shape.evaluate(v);
+        }
+    }
+    
+    m_table.publish(std::move(table));
+}
+
+void VelocityCurve::setLutEnabled(bool enabled)
+{
+    if (m_lutEnabled == enabled) return;
+    m_lutEnabled = enabled;
+    qDebug() << "[VelocityCurve] LUT mode:" << (enabled ? "ON" : "OFF");
+    emit curveChanged();
+}
+
+void VelocityCurve::setControlPoints(const QList<QPointF>& points)
+{
+    QList<QPointF> sorted = points;
+    std::sort(sorted.begin(), sorted.end(),
+              [](const QPointF& a, const QPointF& b) { return a.x() < b.x(); });
+    
+    if (sorted.size() < 2 || sorted.front().x() < 0.0) {
+        qWarning() << "[VelocityCurve] Ignoring control points: need >= 2 points at velocity >= 0";
+        return;
+    }
+    if (sorted == m_controlPoints) return;
+    
+    m_controlPoints = sorted;
+    m_preset = Custom;
+    qDebug() << "[VelocityCurve] Control points:" << sorted.size()
+             << "| Range:" << sorted.front().x() << "-" << sorted.back().x();
+    emit curveChanged();
+}
+
+void VelocityCurve::clearControlPoints()
+{
+    if (m_controlPoints.isEmpty()) return;
+    m_controlPoints.clear();
+    emit curveChanged();
+}
+
 void VelocityCurve::setLowThreshold(double v)
 {
     if (qFuzzyCompare(m_lowThreshold, v)) return;
     m_lowThreshold = v;
     m_preset = Custom;
+    m_controlPoints.clear();  // Back to the low/mid/high model
     emit curveChanged();
 }
 
@@ -65,6 +166,7 @@ void VelocityCurve::setHighThreshold(double v)
     if (qFuzzyCompare(m_highThreshold, v)) return;
     m_highThreshold = v;
     m_preset = Custom;
+    m_controlPoints.clear();  // Back to the low/mid/high model
     emit curveChanged();
 }
 
@@ -73,6 +175,7 @@ void VelocityCurve::setLowMultiplier(double v)
     if (qFuzzyCompare(m_lowMultiplier, v)) return;
     m_lowMultiplier = v;
     m_preset = Custom;
+    m_controlPoints.clear();  // Back to the low/mid/high model
     emit curveChanged();
 }
 
@@ -81,6 +184,7 @@ void VelocityCurve::setHighMultiplier(double v)
     if (qFuzzyCompare(m_highMultiplier, v)) return;
     m_highMultiplier = v;
     m_preset = Custom;
+    m_controlPoints.clear();  // Back to the low/mid/high model
     emit curveChanged();
 }
 
@@ -94,6 +198,11 @@ void VelocityCurve::applyPreset(CurvePreset preset)
 {
     m_preset = preset;
     
+    // Presets are defined by the low/mid/high model
+    if (preset != Custom) {
+        m_controlPoints.clear();
+    }
+    
     switch (preset) {
     case Linear:
         // No velocity adjustment
@@ -2,7 +2,11 @@
 #define NEOZ_VELOCITYCURVE_H
 
 #include <QObject>
+#include <QList>
+#include <QPointF>
+#include <array>
 #include <vector>
+#include "../perf/RcuCell.hpp"
 
 namespace NeoZ {
 
@@ -26,6 +30,8 @@ class VelocityCurve : public QObject
     Q_PROPERTY(double lowMultiplier READ lowMultiplier WRITE setLowMultiplier NOTIFY curveChanged)
     Q_PROPERTY(double highMultiplier READ highMultiplier WRITE setHighMultiplier NOTIFY curveChanged)
     Q_PROPERTY(CurvePreset preset READ preset WRITE setPreset NOTIFY curveChanged)
+    Q_PROPERTY(bool lutEnabled READ lutEnabled WRITE setLutEnabled NOTIFY curveChanged)
+    Q_PROPERTY(QList<QPointF> controlPoints READ controlPoints WRITE setControlPoints NOTIFY curveChanged)
     
 public:
     enum CurvePreset {
@@ -43,12 +49,67 @@ public:
     // Apply the curve to a velocity value, returns multiplier C(v)
     Q_INVOKABLE double apply(double velocity) const;
     
+    /**
+     * @brief Plain-data copy of the curve parameters for batch kernels.
+     * 
+     * evaluate() is the reference implementation of apply(); vectorized
+     * kernels must reproduce its operation order exactly.
+     */
+    struct Shape {
+        bool linear = true;
+        double lowThreshold = 0.5;
+        double highThreshold = 5.0;
+        double lowMultiplier = 1.0;
+        double midMultiplier = 1.0;
+        double highMultiplier = 1.0;
+        
+        double evaluate(double velocity) const;
+    };
+    Shape shape() const;
+    
+    /**
+     * @brief Immutable curve snapshot published to the hook thread.
+     * 
+     * Rebuilt on every curveChanged and swapped in atomically (RCU), so
+     * readers always see a complete curve. In LUT mode C(v) is sampled at
+     * SIZE + 1 evenly spaced velocities over [0, vMax] and looked up with
+     * linear interpolation: O(1), branch-free, clamped beyond vMax.
+     */
+    struct Table {
+        static constexpr int SIZE = 1024;
+        
+        Shape shape;               // Analytic model (used when !useLut)
+        bool useLut = false;       // LUT mode or control points active
+        double invStep = 0.0;      // SIZE / vMax
+        std::array<double, SIZE + 1> values{};
+        
+        double lookup(double velocity) const {
+            double x = velocity * invStep;
+            x = (x > 0.0) ? x : 0.0;
+            x = (x < SIZE) ? x : static_cast<double>(SIZE);
+            int i = static_cast<int>(x);
+            i = (i < SIZE - 1) ? i : SIZE - 1;
+            double frac = x - static_cast<double>(i);
+            return values[i] + (values[i + 1] - values[i]) * frac;
+        }
+        
+        double evaluate(double velocity) const {
+            return useLut ? lookup(velocity) : shape.evaluate(velocity);
+        }
+    };
+    using TableGuard = RcuCell<Table>::ReadGuard;
+    
+    // Lock-free read of the current curve; hold for one event or one batch
+    TableGuard snapshot() const { return m_table.read(); }
+    
     // Getters
     double lowThreshold() const { return m_lowThreshold; }
     double highThreshold() const { return m_highThreshold; }
     double lowMultiplier() const { return m_lowMultiplier; }
     double highMultiplier() const { return m_highMultiplier; }
     CurvePreset preset() const { return m_preset; }
+    bool lutEnabled() const { return m_lutEnabled; }
+    QList<QPointF> controlPoints() const { return m_controlPoints; }
     
     // Setters
     void setLowThreshold(double v);
@@ -56,6 +117,12 @@ public:
     void setLowMultiplier(double v);
     void setHighMultiplier(double v);
     void setPreset(CurvePreset preset);
+    void setLutEnabled(bool enabled);
+    
+    // User-defined curve: (velocity, multiplier) points joined by smoothstep
+    // segments. Needs at least two points; implies Custom preset and LUT mode.
+    void setControlPoints(const QList<QPointF>& points);
+    Q_INVOKABLE void clearControlPoints();
     
     // Apply preset values
     Q_INVOKABLE void applyPreset(CurvePreset preset);
@@ -67,6 +134,12 @@ private:
     // Smooth interpolation between low and high multipliers
     double interpolate(double velocity) const;
     
+    // Reference evaluation of user control points (GUI thread only)
+    double evaluateControlPoints(double velocity) const;
+    
+    // Build and publish a new Table (connected to curveChanged)
+    void rebuildTable();
+    
     // Curve parameters
     double m_lowThreshold = 0.5;    // Velocity below this uses lowMultiplier
     double m_highThreshold = 5.0;   // Velocity above this uses highMultiplier
@@ -75,6 +148,12 @@ private:
     double m_midMultiplier = 1.0;   // Multiplier at mid velocity (baseline)
     
     CurvePreset m_preset = Linear;
+    
+    // LUT mode and user control points (sorted by velocity)
+    bool m_lutEnabled = false;
+    QList<QPointF> m_controlPoints;
+    
+    RcuCell<Table> m_table;
 };
 
 } // namespace NeoZ
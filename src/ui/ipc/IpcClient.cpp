@@ -1,6 +1,7 @@
 #include "IpcClient.h"
 #include <QDebug>
 #include <QDateTime>
+#include <QJsonArray>
 
 namespace NeoZ {
 
@@ -28,6 +29,7 @@ bool IpcClient::connect(const QString& endpoint)
     }
     
     m_endpoint = endpoint;
+    m_framing = MessageFraming::Mode::Json;  // Until the new server agrees otherwise
     m_socket = new QLocalSocket(this);
     
     QObject::connect(m_socket, &QLocalSocket::connected, this, &IpcClient::onConnected);
@@ -89,10 +91,23 @@ void IpcClient::onDisconnected()
 
 void IpcClient::onReadyRead()
 {
-    while (m_socket && m_socket->bytesAvailable() > 0) {
-        QByteArray data = m_socket->readLine();
-        if (!data.isEmpty()) {
-            processMessage(data);
+    while (m_socket) {
+        QJsonObject msg;
+        QString error;
+        auto result = MessageFraming::read(m_socket, &msg, &error);
+        
+        if (result == MessageFraming::ReadResult::Incomplete) {
+            break;
+        } else if (result == MessageFraming::ReadResult::Message) {
+            processMessage(msg);
+        } else if (result == MessageFraming::ReadResult::Malformed) {
+            if (!error.isEmpty()) {
+                qWarning() << "[IpcClient] Invalid message:" << error;
+            }
+        } else {
+            qWarning() << "[IpcClient] Corrupt stream:" << error;
+            m_socket->disconnectFromServer();
+            break;
         }
     }
 }
@@ -113,20 +128,15 @@ void IpcClient::attemptReconnect()
     }
 }
 
-void IpcClient::processMessage(const QByteArray& data)
+void IpcClient::processMessage(const QJsonObject& msg)
 {
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
-    
-    if (error.error != QJsonParseError::NoError) {
-        qWarning() << "[IpcClient] Invalid JSON:" << error.errorString();
-        return;
-    }
-    
-    QJsonObject msg = doc.object();
     QString type = msg["type"].toString();
     QString id = msg["id"].toString();
     
+    if (type == "Welcome") {
+        negotiateFraming(msg);
+    }
+    
     // Check for pending request response
     if (!id.isEmpty() && m_pendingRequests.contains(id)) {
         PendingRequest& pending = m_pendingRequests[id];
@@ -167,11 +177,30 @@ void IpcClient::send(const QJsonObject& msg)
         return;
     }
     
-    QByteArray data = QJsonDocument(msg).toJson(QJsonDocument::Compact) + "\n";
-    m_socket->write(data);
+    m_socket->write(MessageFraming::encode(msg, m_framing));
     m_socket->flush();
 }
 
+void IpcClient::negotiateFraming(const QJsonObject& welcome)
+{
+    // Older servers don't advertise framings: stay on JSON
+    const QString wanted = MessageFraming::modeName(m_preferredFraming);
+    if (m_preferredFraming == m_framing || !welcome["framings"].toArray().contains(wanted)) {
+        return;
+    }
+    
+    QJsonObject setFraming;
+    setFraming["type"] = "SetFraming";
+    setFraming["framing"] = wanted;
+    const MessageFraming::Mode mode = m_preferredFraming;
+    request(setFraming, [this, mode](const QJsonObject& response) {
+        if (response["success"].toBool()) {
+            m_framing = mode;
+            qDebug() << "[IpcClient] Framing:" << MessageFraming::modeName(mode);
+        }
+    });
+}
+
 void IpcClient::request(const QJsonObject& request, ResponseCallback callback, int timeoutMs)
 {
     if (!isConnected()) {
@@ -8,6 +8,7 @@
 #include <QHash>
 #include <QTimer>
 #include <functional>
+#include "../../core/ipc/MessageFraming.h"
 
 namespace NeoZ {
 
@@ -19,6 +20,8 @@ namespace NeoZ {
  * - Request/response correlation via message ID
  * - Async and sync message patterns
  * - Connection state management
+ * - Binary framing: upgrades to length-prefixed CBOR when the server's
+ *   Welcome advertises it (JSON otherwise)
  */
 class IpcClient : public QObject
 {
@@ -82,6 +85,12 @@ public:
      */
     void setAutoReconnect(bool enabled, int intervalMs = 2000);
     
+    /**
+     * @brief Framing to request from the server (Json disables negotiation)
+     */
+    void setPreferredFraming(MessageFraming::Mode mode) { m_preferredFraming = mode; }
+    MessageFraming::Mode framing() const { return m_framing; }
+    
 signals:
     void connectionChanged();
     void latencyChanged();
@@ -98,7 +107,8 @@ private slots:
     void attemptReconnect();
     
 private:
-    void processMessage(const QByteArray& data);
+    void processMessage(const QJsonObject& msg);
+    void negotiateFraming(const QJsonObject& welcome);
     QString generateId();
     
     QLocalSocket* m_socket = nullptr;
@@ -121,6 +131,10 @@ private:
     bool m_autoReconnect = true;
     int m_reconnectInterval = 2000;
     
+    // Framing (what we send; incoming frames are auto-detected)
+    MessageFraming::Mode m_framing = MessageFraming::Mode::Json;
+    MessageFraming::Mode m_preferredFraming = MessageFraming::Mode::Cbor;
+    
     // ID generation
     quint64 m_idCounter = 0;
 };
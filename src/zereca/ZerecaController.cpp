@@ -20,6 +20,13 @@ void ZerecaController::initializeSubsystems()
     // System A - Enforcement
     m_targetState = new TargetStateManager(this);
     m_flightRecorder = new FlightRecorder(this);
+    if (m_flightRecorder->openPersistent() && m_flightRecorder->recoveredAfterCrash()) {
+        // Previous run was killed before it could dump; keep its last minutes.
+        // Nothing is failing right now, so write the readable format
+        m_flightRecorder->dumpToDisk("recovered_after_crash", FlightRecorder::DumpFormat::Json);
+        addLogEntry("WARNING", QString("Recovered %1 flight records from an unclean shutdown")
+                                   .arg(m_flightRecorder->recoveredCount()));
+    }
     m_stateReconciler = new StateReconciler(m_targetState, this);
     m_emergencyRollback = new EmergencyRollback(m_targetState, m_flightRecorder, this);
     m_telemetryReader = new TelemetryReader(this);
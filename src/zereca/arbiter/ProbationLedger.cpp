@@ -2,21 +2,32 @@
 #include "../types/ContextHash.h"
 #include <QDir>
 #include <QFile>
+#include <QSaveFile>
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QStandardPaths>
 #include <QDebug>
 #include <QMutexLocker>
+#include <QThread>
+#include <cstring>
 
 namespace Zereca {
 
 ProbationLedger::ProbationLedger(QObject* parent)
+    : ProbationLedger(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation), parent)
+{
+}
+
+ProbationLedger::ProbationLedger(const QString& storageDir, QObject* parent)
     : QObject(parent)
 {
-    m_storagePath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) 
-                    + "/zereca_probation.json";
-    QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    static_assert(sizeof(WalHeader) == 8, "WalHeader must not contain padding");
+    static_assert(sizeof(WalRecord) == 40, "WalRecord must not contain padding");
+    
+    m_storagePath = storageDir + "/zereca_probation.json";
+    m_walPath = storageDir + "/zereca_probation.wal";
+    QDir().mkpath(storageDir);
     
     load();
 }
@@ -24,19 +35,34 @@ ProbationLedger::ProbationLedger(QObject* parent)
 ProbationLedger::~ProbationLedger()
 {
     save();
+    delete m_table.load();
 }
 
 bool ProbationLedger::isOnProbation(uint64_t configHash, const SystemContext& currentContext) const
 {
-    QMutexLocker locker(&m_mutex);
+    ReadGuard guard(this);
     
-    auto it = m_entries.find(configHash);
-    if (it == m_entries.end()) {
+    const ProbationEntry* entry = guard.table()->find(configHash);
+    if (!entry) {
         return false;  // Not on probation
     }
     
     // Check if resurrection is allowed
-    return !canResurrect(*it, currentContext);
+    return !canResurrect(*entry, currentContext, QDateTime::currentMSecsSinceEpoch());
+}
+
+std::vector<bool> ProbationLedger::isOnProbation(const std::vector<uint64_t>& configHashes,
+                                                 const SystemContext& currentContext) const
+{
+    ReadGuard guard(this);
+    const uint64_t now = QDateTime::currentMSecsSinceEpoch();
+    
+    std::vector<bool> blocked(configHashes.size(), false);
+    for (size_t i = 0; i < configHashes.size(); ++i) {
+        const ProbationEntry* entry = guard.table()->find(configHashes[i]);
+        blocked[i] = entry && !canResurrect(*entry, currentContext, now);
+    }
+    return blocked;
 }
 
 void ProbationLedger::addToProbation(uint64_t configHash, Severity severity, const SystemContext& context)
@@ -59,10 +85,11 @@ void ProbationLedger::addToProbation(uint64_t configHash, Severity severity, con
     }
     
     m_entries[configHash] = entry;
+    publishTable();
+    logMutation(WalOp::Put, entry);
     
     locker.unlock();
     
-    save();
     emit entryAdded(configHash, severity);
     emit entriesChanged(m_entries.size());
     
@@ -72,11 +99,10 @@ void ProbationLedger::addToProbation(uint64_t configHash, Severity severity, con
 
 std::optional<ProbationEntry> ProbationLedger::getEntry(uint64_t configHash) const
 {
-    QMutexLocker locker(&m_mutex);
+    ReadGuard guard(this);
     
-    auto it = m_entries.find(configHash);
-    if (it != m_entries.end()) {
-        return *it;
+    if (const ProbationEntry* entry = guard.table()->find(configHash)) {
+        return *entry;
     }
     return std::nullopt;
 }
@@ -86,8 +112,11 @@ void ProbationLedger::clearEntry(uint64_t configHash)
     QMutexLocker locker(&m_mutex);
     
     if (m_entries.remove(configHash) > 0) {
+        publishTable();
+        ProbationEntry removed;
+        removed.configHash = configHash;
+        logMutation(WalOp::Clear, removed);
         locker.unlock();
-        save();
         emit entryCleared(configHash);
         emit entriesChanged(m_entries.size());
         qDebug() << "[Zereca] Cleared probation entry:" << configHash;
@@ -99,9 +128,13 @@ void ProbationLedger::clearAll()
     QMutexLocker locker(&m_mutex);
     
     m_entries.clear();
+    publishTable();
+    // Logged first: until the log is truncated, replaying it must still
+    // end empty, whichever snapshot it is replayed over
+    appendWal(WalOp::ClearAll, ProbationEntry());
+    compact();   // Empty snapshot, empty log
     
     locker.unlock();
-    save();
     emit entriesChanged(0);
     
     qWarning() << "[Zereca] All probation entries cleared (manual reset)";
@@ -127,7 +160,41 @@ int ProbationLedger::entryCount() const
     return m_entries.size();
 }
 
+int ProbationLedger::walRecordCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_walRecords;
+}
+
 bool ProbationLedger::load()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    
+    const bool haveSnapshot = loadSnapshot();
+    bool clean = true;
+    const int replayed = replayWal(&clean);
+    publishTable();
+    
+    if (!clean) {
+        // Drop the bad tail: appending after it would misalign every record
+        compact();
+    } else if (!openWal()) {
+        qWarning() << "[Zereca] Probation log unavailable, saving full snapshots";
+    }
+    
+    qDebug() << "[Zereca] Loaded" << m_entries.size() << "probation entries"
+             << "(" << replayed << "log records replayed)";
+    return haveSnapshot || replayed > 0;
+}
+
+bool ProbationLedger::save()
+{
+    QMutexLocker locker(&m_mutex);
+    return compact();
+}
+
+bool ProbationLedger::loadSnapshot()
 {
     QFile file(m_storagePath);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -143,9 +210,6 @@ bool ProbationLedger::load()
         return false;
     }
     
-    QMutexLocker locker(&m_mutex);
-    m_entries.clear();
-    
     QJsonArray entries = doc.array();
     for (const auto& val : entries) {
         QJsonObject obj = val.toObject();
@@ -160,14 +224,11 @@ bool ProbationLedger::load()
         m_entries[entry.configHash] = entry;
     }
     
-    qDebug() << "[Zereca] Loaded" << m_entries.size() << "probation entries";
     return true;
 }
 
-bool ProbationLedger::save()
+bool ProbationLedger::writeSnapshot()
 {
-    QMutexLocker locker(&m_mutex);
-    
     QJsonArray entries;
     for (const auto& entry : m_entries) {
         QJsonObject obj;
@@ -180,9 +241,8 @@ bool ProbationLedger::save()
         entries.append(obj);
     }
     
-    locker.unlock();
-    
-    QFile file(m_storagePath);
+    // Replaced atomically: a crash mid-write leaves the old snapshot + log
+    QSaveFile file(m_storagePath);
     if (!file.open(QIODevice::WriteOnly)) {
         qWarning() << "[Zereca] Failed to save probation ledger";
         return false;
@@ -190,12 +250,244 @@ bool ProbationLedger::save()
     
     QJsonDocument doc(entries);
     file.write(doc.toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning() << "[Zereca] Failed to save probation ledger";
+        return false;
+    }
+    
+    return true;
+}
+
+static uint16_t walChecksum(const void* record, size_t size)
+{
+    return qChecksum(QByteArrayView(static_cast<const char*>(record), static_cast<qsizetype>(size)));
+}
+
+int ProbationLedger::replayWal(bool* clean)
+{
+    m_walRecords = 0;
+    *clean = true;
+    
+    QFile file(m_walPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;   // No log yet
+    }
+    const QByteArray data = file.readAll();
     file.close();
     
+    WalHeader header;
+    if (data.size() < static_cast<qsizetype>(sizeof(header))) {
+        *clean = false;
+        return 0;
+    }
+    std::memcpy(&header, data.constData(), sizeof(header));
+    if (std::memcmp(header.magic, WAL_MAGIC, sizeof(header.magic)) != 0
+        || header.version != WAL_VERSION || header.recordSize != sizeof(WalRecord)) {
+        qWarning() << "[Zereca] Unrecognised probation log ignored";
+        *clean = false;
+        return 0;
+    }
+    
+    qsizetype offset = sizeof(header);
+    while (offset + static_cast<qsizetype>(sizeof(WalRecord)) <= data.size()) {
+        WalRecord rec;
+        std::memcpy(&rec, data.constData() + offset, sizeof(rec));
+        const uint16_t stored = rec.checksum;
+        rec.checksum = 0;
+        if (walChecksum(&rec, sizeof(rec)) != stored) {
+            break;   // Torn or corrupt; nothing after it can be trusted
+        }
+        
+        if (rec.op == static_cast<uint8_t>(WalOp::Put)) {
+            ProbationEntry entry;
+            entry.configHash = rec.configHash;
+            entry.lastFailureTs = rec.lastFailureTs;
+            entry.severity = static_cast<Severity>(rec.severity);
+            entry.driverVersion = rec.driverVersion;
+            entry.osBuild = rec.osBuild;
+            entry.backoff = rec.backoff;
+            m_entries[entry.configHash] = entry;
+        } else if (rec.op == static_cast<uint8_t>(WalOp::Clear)) {
+            m_entries.remove(rec.configHash);
+        } else if (rec.op == static_cast<uint8_t>(WalOp::ClearAll)) {
+            m_entries.clear();
+        } else {
+            break;
+        }
+        
+        offset += sizeof(WalRecord);
+        ++m_walRecords;
+    }
+    
+    if (offset != data.size()) {
+        qWarning() << "[Zereca] Probation log truncated after" << m_walRecords << "records";
+        *clean = false;
+    }
+    return m_walRecords;
+}
+
+bool ProbationLedger::resetWal()
+{
+    m_wal.reset();
+    m_walRecords = 0;
+    
+    auto file = std::make_unique<QFile>(m_walPath);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        return false;
+    }
+    
+    WalHeader header;
+    std::memcpy(header.magic, WAL_MAGIC, sizeof(header.magic));
+    header.version = WAL_VERSION;
+    header.recordSize = sizeof(WalRecord);
+    if (file->write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+    
+    m_wal = std::move(file);
+    return true;
+}
+
+bool ProbationLedger::openWal()
+{
+    if (!QFile::exists(m_walPath)) {
+        return resetWal();
+    }
+    
+    auto file = std::make_unique<QFile>(m_walPath);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered)) {
+        return false;
+    }
+    m_wal = std::move(file);
+    return true;
+}
+
+bool ProbationLedger::appendWal(WalOp op, const ProbationEntry& entry)
+{
+    WalRecord rec = {};
+    rec.op = static_cast<uint8_t>(op);
+    rec.severity = static_cast<uint8_t>(entry.severity);
+    rec.backoff = entry.backoff;
+    rec.configHash = entry.configHash;
+    rec.lastFailureTs = entry.lastFailureTs;
+    rec.driverVersion = entry.driverVersion;
+    rec.osBuild = entry.osBuild;
+    rec.checksum = walChecksum(&rec, sizeof(rec));
+    
+    // One sequential write
+    if (!m_wal || m_wal->write(reinterpret_cast<const char*>(&rec), sizeof(rec)) != sizeof(rec)) {
+        return false;
+    }
+    ++m_walRecords;
+    return true;
+}
+
+void ProbationLedger::logMutation(WalOp op, const ProbationEntry& entry)
+{
+    // Without a usable log fall back to a full snapshot
+    if (!appendWal(op, entry)) {
+        compact();
+        return;
+    }
+    
+    if (m_walRecords >= COMPACT_MIN_RECORDS && m_walRecords >= 2 * m_entries.size()) {
+        compact();
+    }
+}
+
+bool ProbationLedger::compact()
+{
+    // Snapshot first: if truncating the log then fails, replaying it is harmless
+    if (!writeSnapshot()) {
+        return false;
+    }
+    if (!resetWal()) {
+        // A stale log must not be replayed over a newer snapshot
+        QFile::remove(m_walPath);
+        qWarning() << "[Zereca] Failed to reset probation log";
+    }
     return true;
 }
 
-bool ProbationLedger::canResurrect(const ProbationEntry& entry, const SystemContext& currentContext) const
+static uint64_t mixHash(uint64_t h)
+{
+    // splitmix64 finaliser: config hashes are XORs of small values
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+ProbationLedger::Table* ProbationLedger::Table::build(const QHash<uint64_t, ProbationEntry>& entries)
+{
+    size_t capacity = 8;
+    while (capacity < 2 * static_cast<size_t>(entries.size())) {
+        capacity *= 2;
+    }
+    
+    auto* table = new Table;
+    table->slots.resize(capacity);
+    const size_t mask = capacity - 1;
+    for (const auto& entry : entries) {
+        size_t i = mixHash(entry.configHash) & mask;
+        while (table->slots[i].occupied) {
+            i = (i + 1) & mask;
+        }
+        table->slots[i].entry = entry;
+        table->slots[i].occupied = true;
+    }
+    return table;
+}
+
+const ProbationEntry* ProbationLedger::Table::find(uint64_t configHash) const
+{
+    // At most half full, so an empty slot always ends the probe
+    const size_t mask = slots.size() - 1;
+    for (size_t i = mixHash(configHash) & mask; slots[i].occupied; i = (i + 1) & mask) {
+        if (slots[i].entry.configHash == configHash) {
+            return &slots[i].entry;
+        }
+    }
+    return nullptr;
+}
+
+ProbationLedger::ReadGuard::ReadGuard(const ProbationLedger* ledger)
+    : m_ledger(ledger)
+{
+    // Count ourselves in the current epoch, then load. If the epoch flipped
+    // in between, a writer may already have checked that counter: retry.
+    for (;;) {
+        m_epoch = m_ledger->m_readEpoch.load(std::memory_order_seq_cst);
+        m_ledger->m_readers[m_epoch].fetch_add(1, std::memory_order_seq_cst);
+        if (m_ledger->m_readEpoch.load(std::memory_order_seq_cst) == m_epoch) break;
+        m_ledger->m_readers[m_epoch].fetch_sub(1, std::memory_order_release);
+    }
+    m_table = m_ledger->m_table.load(std::memory_order_seq_cst);
+}
+
+ProbationLedger::ReadGuard::~ReadGuard()
+{
+    m_ledger->m_readers[m_epoch].fetch_sub(1, std::memory_order_release);
+}
+
+void ProbationLedger::publishTable()
+{
+    const Table* old = m_table.exchange(Table::build(m_entries), std::memory_order_seq_cst);
+    
+    // New readers go to the other epoch; once the current one drains,
+    // nobody can still hold the old table
+    const int epoch = m_readEpoch.load(std::memory_order_relaxed);
+    m_readEpoch.store(epoch ^ 1, std::memory_order_seq_cst);
+    while (m_readers[epoch].load(std::memory_order_seq_cst) != 0) {
+        QThread::yieldCurrentThread();
+    }
+    delete old;
+}
+
+bool ProbationLedger::canResurrect(const ProbationEntry& entry, const SystemContext& currentContext,
+                                   uint64_t now)
 {
     // NEVER resurrect Severity 3 (BSOD)
     if (entry.severity == Severity::CRITICAL) {
@@ -204,7 +496,6 @@ bool ProbationLedger::canResurrect(const ProbationEntry& entry, const SystemCont
     
     // Severity 1 (FPS regression) - allow auto-retry after backoff
     if (entry.severity == Severity::LOW) {
-        uint64_t now = QDateTime::currentMSecsSinceEpoch();
         uint64_t baseBackoff = 5 * 60 * 1000;  // 5 minutes base
         uint64_t actualBackoff = static_cast<uint64_t>(baseBackoff * entry.backoff);
         return now > (entry.lastFailureTs + actualBackoff);
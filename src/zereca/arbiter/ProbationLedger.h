@@ -5,8 +5,12 @@
 #include <QObject>
 #include <QHash>
 #include <QMutex>
+#include <atomic>
+#include <memory>
 #include <vector>
 
+class QFile;
+
 namespace Zereca {
 
 /**
@@ -20,6 +24,23 @@ namespace Zereca {
  * - Severity 1 (FPS Regression): Auto-retry allowed
  * - Severity 2 (App Crash): Context shift only
  * - Severity 3 (BSOD): NEVER auto-retry, manual reset only
+ * 
+ * Persistence: a JSON snapshot plus an append-only binary log. Every
+ * mutation appends one fixed-size record (one sequential write, whatever
+ * the ledger size); once the log grows past COMPACT_MIN_RECORDS and twice
+ * the entry count it is folded into a new snapshot and truncated. load()
+ * replays snapshot + log. Log records carry the full resulting entry, so
+ * replaying a log already folded into the snapshot is harmless. clearAll()
+ * is logged too before it compacts, so a crash between the new snapshot
+ * and the log truncation cannot bring cleared entries back.
+ * 
+ * Reads: every mutation (under m_mutex) rebuilds an immutable
+ * open-addressing table and publishes it with one atomic pointer swap.
+ * isOnProbation() and getEntry() only load that pointer and probe, so
+ * arbiter threads never wait on a writer or on disk I/O. Readers count
+ * themselves in one of two epoch counters; a writer flips the epoch after
+ * the swap and waits for the old epoch to drain before freeing the table
+ * it replaced (the wait is on readers, never the other way round).
  */
 class ProbationLedger : public QObject
 {
@@ -28,6 +49,11 @@ class ProbationLedger : public QObject
     
 public:
     explicit ProbationLedger(QObject* parent = nullptr);
+    
+    /**
+     * @brief Ledger persisted under storageDir instead of the app data dir.
+     */
+    explicit ProbationLedger(const QString& storageDir, QObject* parent = nullptr);
     ~ProbationLedger() override;
     
     /**
@@ -38,6 +64,14 @@ public:
      */
     bool isOnProbation(uint64_t configHash, const SystemContext& currentContext) const;
     
+    /**
+     * @brief Check many configurations against one context in one call.
+     * All hashes are checked against the same table and timestamp.
+     * @return One flag per hash, true if that configuration should be blocked
+     */
+    std::vector<bool> isOnProbation(const std::vector<uint64_t>& configHashes,
+                                    const SystemContext& currentContext) const;
+    
     /**
      * @brief Add a configuration to probation.
      * @param configHash Hash of the optimization configuration
@@ -73,26 +107,105 @@ public:
     int entryCount() const;
     
     /**
-     * @brief Load probation ledger from disk.
+     * @brief Load probation ledger from disk (snapshot, then log replay).
+     * A torn or corrupt log tail is dropped and the ledger compacted.
      */
     bool load();
     
     /**
      * @brief Save probation ledger to disk.
+     * Writes a full snapshot and truncates the log (compaction).
      */
     bool save();
     
+    /**
+     * @brief Records in the log since the last compaction.
+     */
+    int walRecordCount() const;
+    
+    static constexpr int COMPACT_MIN_RECORDS = 1024;
+    
 signals:
     void entriesChanged(int count);
     void entryAdded(uint64_t configHash, Severity severity);
     void entryCleared(uint64_t configHash);
     
 private:
-    bool canResurrect(const ProbationEntry& entry, const SystemContext& currentContext) const;
+    enum class WalOp : uint8_t {
+        Put = 1,      // Entry added or updated (full entry stored)
+        Clear = 2,    // Entry removed
+        ClearAll = 3  // Every entry before it removed (manual reset)
+    };
+    
+    // Log file: WalHeader, then WalRecords back to back (little-endian)
+    struct WalHeader {
+        char magic[4];            // "ZPWL"
+        uint16_t version;
+        uint16_t recordSize;
+    };
+    
+    struct WalRecord {
+        uint8_t op;
+        uint8_t severity;
+        uint16_t checksum;        // CRC-16 of the record with this field zeroed
+        float backoff;
+        uint64_t configHash;
+        uint64_t lastFailureTs;
+        uint64_t driverVersion;
+        uint64_t osBuild;
+    };
+    
+    static constexpr char WAL_MAGIC[4] = {'Z', 'P', 'W', 'L'};
+    static constexpr uint16_t WAL_VERSION = 1;
+    
+    // Immutable snapshot of m_entries for lock-free readers
+    struct Table {
+        struct Slot {
+            ProbationEntry entry;
+            bool occupied = false;
+        };
+        std::vector<Slot> slots;   // Power-of-two size, linear probing, load <= 1/2
+        
+        static Table* build(const QHash<uint64_t, ProbationEntry>& entries);
+        const ProbationEntry* find(uint64_t configHash) const;
+    };
+    
+    // Pins the published table for the duration of a read
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const ProbationLedger* ledger);
+        ~ReadGuard();
+        const Table* table() const { return m_table; }
+    private:
+        const ProbationLedger* m_ledger;
+        const Table* m_table = nullptr;
+        int m_epoch = 0;
+    };
+    
+    static bool canResurrect(const ProbationEntry& entry, const SystemContext& currentContext,
+                             uint64_t now);
+    void publishTable();   // Caller holds m_mutex
+    
+    // Callers hold m_mutex
+    bool loadSnapshot();
+    bool writeSnapshot();
+    int replayWal(bool* clean);
+    bool resetWal();
+    bool openWal();
+    bool appendWal(WalOp op, const ProbationEntry& entry);
+    void logMutation(WalOp op, const ProbationEntry& entry);
+    bool compact();
     
     mutable QMutex m_mutex;
     QHash<uint64_t, ProbationEntry> m_entries;
     QString m_storagePath;
+    QString m_walPath;
+    std::unique_ptr<QFile> m_wal;
+    int m_walRecords = 0;
+    
+    std::atomic<const Table*> m_table{nullptr};
+    std::atomic<int> m_readEpoch{0};
+    mutable std::atomic<int> m_readers[2] = {};   // Readers in flight, per epoch
 };
 
 } // namespace Zereca
@@ -1,41 +1,177 @@
 #include "FlightRecorder.h"
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QLockFile>
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QDateTime>
 #include <QStandardPaths>
 #include <QDebug>
-#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 namespace Zereca {
 
+// The binary dump stores records as they sit in memory
+static_assert(sizeof(StateChangeRecord) == 48, "StateChangeRecord layout is part of the dump format");
+static_assert(sizeof(FlightRecorder::DumpHeader) == 32, "DumpHeader must not contain padding");
+
+static void syncToDevice(QFile& file)
+{
+#ifdef Q_OS_WIN
+    _commit(file.handle());
+#else
+    ::fsync(file.handle());
+#endif
+}
+
 FlightRecorder::FlightRecorder(QObject* parent)
     : QObject(parent)
 {
     m_dumpDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/zereca_dumps";
     QDir().mkpath(m_dumpDir);
     
-    m_buffer.reserve(1000);  // Pre-allocate for typical usage
+    // Allocated once; record() and binary dumps never allocate
+    m_heapRing = std::make_unique<RingHeader>();
+    m_heapSlots = std::make_unique<Slot[]>(MAX_RECORDS);
+    m_ring = m_heapRing.get();
+    m_slots = m_heapSlots.get();
+    m_dumpBuffer = std::make_unique<char[]>(DUMP_BUFFER_SIZE);
 }
 
 FlightRecorder::~FlightRecorder()
 {
-    // Optionally dump on shutdown
+    closePersistent();
+}
+
+bool FlightRecorder::openPersistent(const QString& path)
+{
+    if (isPersistent()) return true;
+    
+    const QString ringPath = path.isEmpty() ? m_dumpDir + "/flight_recorder.ring" : path;
+    QDir().mkpath(QFileInfo(ringPath).absolutePath());
+    
+    // Recovery rewrites the ring, so only one process may own the file.
+    // A lock left by a killed process is detected as stale and taken over.
+    auto lock = std::make_unique<QLockFile>(ringPath + ".lock");
+    lock->setStaleLockTime(0);
+    if (!lock->tryLock(0)) {
+        qWarning() << "[Zereca] FlightRecorder ring in use by another process:" << ringPath;
+        return false;
+    }
+    
+    auto file = std::make_unique<QFile>(ringPath);
+    if (!file->open(QIODevice::ReadWrite)) {
+        qWarning() << "[Zereca] Failed to open flight recorder ring:" << ringPath;
+        return false;
+    }
+    
+    // A file of another size, version or layout is started over
+    bool valid = file->size() == RING_FILE_SIZE;
+    if (!valid && !file->resize(RING_FILE_SIZE)) {
+        qWarning() << "[Zereca] Failed to size flight recorder ring:" << ringPath;
+        return false;
+    }
+    
+    uchar* mapping = file->map(0, RING_FILE_SIZE);
+    if (!mapping) {
+        qWarning() << "[Zereca] Failed to map flight recorder ring:" << ringPath;
+        return false;
+    }
+    
+    auto* ring = reinterpret_cast<RingHeader*>(mapping);
+    auto* slots = reinterpret_cast<Slot*>(mapping + sizeof(RingHeader));
+    valid = valid
+            && std::memcmp(ring->magic, RING_MAGIC, sizeof(ring->magic)) == 0
+            && ring->version == RING_VERSION
+            && ring->recordSize == sizeof(StateChangeRecord)
+            && ring->capacity == MAX_RECORDS;
+    
+    // Collect before switching over: what this run has recorded so far,
+    // then what the previous run left in the file
+    const std::vector<StateChangeRecord> current = allRecords();
+    std::vector<StateChangeRecord> recovered;
+    bool crashed = false;
+    
+    m_ring = ring;
+    m_slots = slots;
+    if (valid) {
+        crashed = ring->cleanShutdown == 0;
+        recovered = allRecords();
+    }
+    
+    // Rebuild from scratch: a writer killed mid-record leaves a slot that the
+    // writer one lap later would wait on forever. Everything worth keeping
+    // was copied out above and is appended again below.
+    std::memset(mapping, 0, RING_FILE_SIZE);
+    std::memcpy(ring->magic, RING_MAGIC, sizeof(ring->magic));
+    ring->version = RING_VERSION;
+    ring->recordSize = sizeof(StateChangeRecord);
+    ring->capacity = MAX_RECORDS;
+    
+    for (const auto& rec : recovered) record(rec);
+    for (const auto& rec : current) record(rec);
+    
+    m_ringLock = std::move(lock);
+    m_ringFile = std::move(file);
+    m_mapping = mapping;
+    m_heapSlots.reset();
+    m_heapRing.reset();
+    m_recoveredCount = static_cast<int>(recovered.size());
+    m_recoveredAfterCrash = crashed;
+    
+    qDebug() << "[Zereca] FlightRecorder ring mapped:" << ringPath
+             << "(" << recovered.size() << "records recovered"
+             << (crashed ? ", previous run did not shut down cleanly)" : ")");
+    return true;
+}
+
+void FlightRecorder::closePersistent()
+{
+    if (!m_mapping) return;
+    
+    m_ring->cleanShutdown = 1;
+    m_ringFile->unmap(m_mapping);
+    m_ringFile->close();
+    m_mapping = nullptr;
+    m_ring = nullptr;
+    m_slots = nullptr;
+    m_ringFile.reset();
+    m_ringLock.reset();
 }
 
 void FlightRecorder::record(const StateChangeRecord& entry)
 {
-    QMutexLocker locker(&m_mutex);
+    const uint64_t n = m_ring->head.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = m_slots[n & (MAX_RECORDS - 1)];
     
-    // Add new record
-    m_buffer.push_back(entry);
+    // The writer one lap behind must publish first, or it would overwrite us.
+    // Only reachable if a writer stalls for MAX_RECORDS records.
+    const uint64_t previous = n >= MAX_RECORDS ? 2 * (n - MAX_RECORDS) + 2 : 0;
+    while (slot.seq.load(std::memory_order_acquire) != previous) {
+        QThread::yieldCurrentThread();
+    }
     
-    // Prune old records
-    pruneOldRecords();
+    uint64_t words[RECORD_WORDS] = {};
+    std::memcpy(words, &entry, sizeof(StateChangeRecord));
     
-    emit recordCountChanged(static_cast<int>(m_buffer.size()));
+    slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < RECORD_WORDS; ++i) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.seq.store(2 * n + 2, std::memory_order_release);
+    
+    emit recordCountChanged(recordCount());
 }
 
 void FlightRecorder::record(uint32_t component, uint64_t oldVal, uint64_t newVal,
@@ -53,32 +189,21 @@ void FlightRecorder::record(uint32_t component, uint64_t oldVal, uint64_t newVal
     record(entry);
 }
 
-QString FlightRecorder::dumpToDisk(const QString& reason)
+QString FlightRecorder::dumpToDisk(const QString& reason, DumpFormat format)
 {
-    QMutexLocker locker(&m_mutex);
-    
     QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+    
+    if (format == DumpFormat::Binary) {
+        QString path = m_dumpDir + "/" + QString("flight_recorder_%1.zfr").arg(timestamp);
+        return writeBinaryDump(path, reason);
+    }
+    
+    const std::vector<StateChangeRecord> snapshot = allRecords();
+    
     QString filename = QString("flight_recorder_%1.json").arg(timestamp);
     QString path = m_dumpDir + "/" + filename;
     
-    QJsonObject root;
-    root["dump_reason"] = reason;
-    root["dump_timestamp"] = QDateTime::currentMSecsSinceEpoch();
-    root["record_count"] = static_cast<int>(m_buffer.size());
-    
-    QJsonArray records;
-    for (const auto& rec : m_buffer) {
-        QJsonObject obj;
-        obj["timestamp"] = static_cast<qint64>(rec.timestamp);
-        obj["component"] = static_cast<int>(rec.component);
-        obj["old_val"] = static_cast<qint64>(rec.oldVal);
-        obj["new_val"] = static_cast<qint64>(rec.newVal);
-        obj["expected_gain"] = rec.expectedGain;
-        obj["actual_delta"] = rec.actualDelta;
-        obj["rollback_reason"] = rec.rollbackReason;
-        records.append(obj);
-    }
-    root["records"] = records;
+    QJsonObject root = dumpToJson(reason, QDateTime::currentMSecsSinceEpoch(), snapshot);
     
     QFile file(path);
     if (file.open(QIODevice::WriteOnly)) {
@@ -95,57 +220,200 @@ QString FlightRecorder::dumpToDisk(const QString& reason)
     return QString();
 }
 
-std::vector<StateChangeRecord> FlightRecorder::recentRecords(size_t count) const
+QString FlightRecorder::writeBinaryDump(const QString& path, const QString& reason)
 {
-    QMutexLocker locker(&m_mutex);
+    // A second concurrent dump gets its own buffer rather than waiting
+    std::unique_ptr<char[]> fallback;
+    const bool reserved = !m_dumpBusy.test_and_set(std::memory_order_acquire);
+    if (!reserved) {
+        fallback = std::make_unique<char[]>(DUMP_BUFFER_SIZE);
+    }
+    char* buffer = reserved ? m_dumpBuffer.get() : fallback.get();
     
-    if (count >= m_buffer.size()) {
-        return m_buffer;
+    const QByteArray reasonUtf8 = reason.toUtf8().left(MAX_REASON_BYTES);
+    const size_t reasonPadded = (static_cast<size_t>(reasonUtf8.size()) + 7) & ~size_t(7);
+    char* records = buffer + sizeof(DumpHeader) + reasonPadded;
+    const size_t count = copyRecords(reinterpret_cast<StateChangeRecord*>(records), MAX_RECORDS);
+    
+    DumpHeader header = {};
+    std::memcpy(header.magic, DUMP_MAGIC, sizeof(header.magic));
+    header.version = DUMP_VERSION;
+    header.recordSize = sizeof(StateChangeRecord);
+    header.recordCount = static_cast<uint32_t>(count);
+    header.reasonLength = static_cast<uint32_t>(reasonUtf8.size());
+    header.dumpTimestamp = static_cast<uint64_t>(QDateTime::currentMSecsSinceEpoch());
+    std::memcpy(buffer, &header, sizeof(header));
+    std::memset(buffer + sizeof(DumpHeader), 0, reasonPadded);
+    std::memcpy(buffer + sizeof(DumpHeader), reasonUtf8.constData(), reasonUtf8.size());
+    
+    const qint64 size = static_cast<qint64>(sizeof(DumpHeader) + reasonPadded + count * sizeof(StateChangeRecord));
+    
+    QFile file(path);
+    bool ok = file.open(QIODevice::WriteOnly | QIODevice::Unbuffered)
+              && file.write(buffer, size) == size;
+    if (ok) {
+        syncToDevice(file);
     }
+    file.close();
+    
+    if (reserved) {
+        m_dumpBusy.clear(std::memory_order_release);
+    }
+    
+    if (!ok) {
+        qWarning() << "[Zereca] Failed to create flight recorder dump";
+        return QString();
+    }
+    
+    qDebug() << "[Zereca] FlightRecorder dump created:" << path << "(" << count << "records)";
+    emit dumpCreated(path, reason);
+    return path;
+}
+
+bool FlightRecorder::decodeDump(const QByteArray& data, DumpContents* out, QString* error)
+{
+    auto fail = [error](const QString& message) {
+        if (error) *error = message;
+        return false;
+    };
+    
+    if (data.size() < static_cast<qsizetype>(sizeof(DumpHeader))) {
+        return fail("file too short for a dump header");
+    }
+    
+    DumpHeader header;
+    std::memcpy(&header, data.constData(), sizeof(header));
+    if (std::memcmp(header.magic, DUMP_MAGIC, sizeof(header.magic)) != 0) {
+        return fail("not a flight recorder dump (bad magic)");
+    }
+    if (header.version != DUMP_VERSION) {
+        return fail(QString("unsupported dump version %1").arg(header.version));
+    }
+    if (header.recordSize != sizeof(StateChangeRecord)) {
+        return fail(QString("record size %1, expected %2").arg(header.recordSize).arg(sizeof(StateChangeRecord)));
+    }
+    if (header.reasonLength > MAX_REASON_BYTES) {
+        return fail("reason too long");
+    }
+    
+    const size_t reasonPadded = (header.reasonLength + 7) & ~size_t(7);
+    const size_t recordsOffset = sizeof(DumpHeader) + reasonPadded;
+    const size_t expected = recordsOffset + size_t(header.recordCount) * sizeof(StateChangeRecord);
+    
+    // A dump cut short by the failure still yields its complete records
+    size_t count = header.recordCount;
+    if (static_cast<size_t>(data.size()) < expected) {
+        if (static_cast<size_t>(data.size()) < recordsOffset) {
+            return fail("truncated before the first record");
+        }
+        count = (static_cast<size_t>(data.size()) - recordsOffset) / sizeof(StateChangeRecord);
+        if (error) *error = QString("truncated: %1 of %2 records").arg(count).arg(header.recordCount);
+    }
+    
+    out->reason = QString::fromUtf8(data.constData() + sizeof(DumpHeader), header.reasonLength);
+    out->dumpTimestamp = static_cast<qint64>(header.dumpTimestamp);
+    out->records.resize(count);
+    std::memcpy(out->records.data(), data.constData() + recordsOffset, count * sizeof(StateChangeRecord));
+    return true;
+}
+
+QJsonObject FlightRecorder::dumpToJson(const QString& reason, qint64 dumpTimestamp,
+                                       const std::vector<StateChangeRecord>& records)
+{
+    QJsonObject root;
+    root["dump_reason"] = reason;
+    root["dump_timestamp"] = dumpTimestamp;
+    root["record_count"] = static_cast<int>(records.size());
     
-    return std::vector<StateChangeRecord>(m_buffer.end() - count, m_buffer.end());
+    QJsonArray array;
+    for (const auto& rec : records) {
+        QJsonObject obj;
+        obj["timestamp"] = static_cast<qint64>(rec.timestamp);
+        obj["component"] = static_cast<int>(rec.component);
+        obj["old_val"] = static_cast<qint64>(rec.oldVal);
+        obj["new_val"] = static_cast<qint64>(rec.newVal);
+        obj["expected_gain"] = rec.expectedGain;
+        obj["actual_delta"] = rec.actualDelta;
+        obj["rollback_reason"] = rec.rollbackReason;
+        array.append(obj);
+    }
+    root["records"] = array;
+    return root;
+}
+
+std::vector<StateChangeRecord> FlightRecorder::recentRecords(size_t count) const
+{
+    return snapshot(count);
 }
 
 std::vector<StateChangeRecord> FlightRecorder::allRecords() const
 {
-    QMutexLocker locker(&m_mutex);
-    return m_buffer;
+    return snapshot(MAX_RECORDS);
 }
 
 void FlightRecorder::clear()
 {
-    QMutexLocker locker(&m_mutex);
-    m_buffer.clear();
+    m_ring->tail.store(m_ring->head.load(std::memory_order_acquire), std::memory_order_release);
     emit recordCountChanged(0);
 }
 
 int FlightRecorder::recordCount() const
 {
-    QMutexLocker locker(&m_mutex);
-    return static_cast<int>(m_buffer.size());
+    const uint64_t head = m_ring->head.load(std::memory_order_relaxed);
+    const uint64_t tail = m_ring->tail.load(std::memory_order_relaxed);
+    return static_cast<int>(std::min<uint64_t>(head - std::min(head, tail), MAX_RECORDS));
 }
 
-void FlightRecorder::pruneOldRecords()
+bool FlightRecorder::readSlot(uint64_t n, StateChangeRecord& out) const
 {
-    // Already under lock from caller
+    const Slot& slot = m_slots[n & (MAX_RECORDS - 1)];
     
-    uint64_t now = QDateTime::currentMSecsSinceEpoch();
-    uint64_t cutoff = now - MAX_BUFFER_DURATION_MS;
+    const uint64_t before = slot.seq.load(std::memory_order_acquire);
+    if (before != 2 * n + 2) {
+        return false;  // Not published yet, being rewritten, or already overwritten
+    }
     
-    // Remove records older than 5 minutes
-    auto it = m_buffer.begin();
-    while (it != m_buffer.end() && it->timestamp < cutoff) {
-        ++it;
+    uint64_t words[RECORD_WORDS];
+    for (size_t i = 0; i < RECORD_WORDS; ++i) {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != before) {
+        return false;  // Overwritten while copying
     }
     
-    if (it != m_buffer.begin()) {
-        m_buffer.erase(m_buffer.begin(), it);
+    std::memcpy(&out, words, sizeof(StateChangeRecord));
+    return true;
+}
+
+size_t FlightRecorder::copyRecords(StateChangeRecord* out, size_t count) const
+{
+    const uint64_t head = m_ring->head.load(std::memory_order_acquire);
+    uint64_t first = std::max(m_ring->tail.load(std::memory_order_acquire),
+                              head > MAX_RECORDS ? head - MAX_RECORDS : 0);
+    if (head - std::min(head, first) > count) {
+        first = head - count;
     }
     
-    // Enforce hard cap
-    while (m_buffer.size() > MAX_RECORDS) {
-        m_buffer.erase(m_buffer.begin());
+    // Same 5 minute window the dump has always covered
+    const uint64_t cutoff = static_cast<uint64_t>(QDateTime::currentMSecsSinceEpoch()) - MAX_BUFFER_DURATION_MS;
+    
+    size_t written = 0;
+    StateChangeRecord rec;
+    for (uint64_t n = first; n < head; ++n) {
+        if (readSlot(n, rec) && rec.timestamp >= cutoff) {
+            std::memcpy(out + written, &rec, sizeof(rec));
+            ++written;
+        }
     }
+    return written;
+}
+
+std::vector<StateChangeRecord> FlightRecorder::snapshot(size_t count) const
+{
+    std::vector<StateChangeRecord> result(std::min(count, MAX_RECORDS));
+    result.resize(copyRecords(result.data(), result.size()));
+    return result;
 }
 
 } // namespace Zereca
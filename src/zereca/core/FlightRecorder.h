@@ -3,9 +3,15 @@
 
 #include "../types/ZerecaTypes.h"
 #include <QObject>
-#include <QMutex>
-#include <vector>
+#include <QByteArray>
+#include <QJsonObject>
 #include <QString>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class QFile;
+class QLockFile;
 
 namespace Zereca {
 
@@ -16,6 +22,23 @@ namespace Zereca {
  * On failure (crash, thermal, BSOD), the buffer is dumped to disk
  * for post-mortem analysis.
  * 
+ * The buffer is a preallocated power-of-two ring. record() is lock-free
+ * for any number of writer threads: it claims a sequence number with one
+ * fetch_add and publishes the slot with a per-slot sequence (seqlock).
+ * Readers copy slots and keep only those whose sequence was stable, so a
+ * snapshot never blocks a writer; slots being written at that moment are
+ * simply left out.
+ * 
+ * In persistent mode (openPersistent) the same ring lives in a shared
+ * memory-mapped file instead of the heap. record() still only touches
+ * memory, but the pages belong to the OS page cache, so whatever was
+ * recorded survives the process being killed and is recovered by the next
+ * openPersistent() on that file.
+ * 
+ * Binary dumps (.zfr) are not human-readable: decoding them needs the
+ * zereca_dumpdecode CLI, built with -DZERECA_BUILD_TOOLS=ON. Dumps taken
+ * outside a failure path should use DumpFormat::Json.
+ * 
  * Purpose:
  * - User trust (transparent operation)
  * - Support (debugging)
@@ -42,13 +65,85 @@ public:
                 float expectedGain = 0.0f, float actualDelta = 0.0f,
                 uint8_t rollbackReason = 0);
     
+    enum class DumpFormat {
+        Binary,   ///< Header + raw record array, one write (failure path)
+        Json      ///< Indented JSON for direct reading
+    };
+    
     /**
      * @brief Dump all records to disk.
-     * Called automatically on failure.
+     * Called automatically on failure. The binary dump is assembled in a
+     * buffer allocated up front and written with a single unbuffered write
+     * plus a flush to the device, so it neither allocates nor formats text
+     * while the system is going down. Decode it with zereca_dumpdecode.
      * @param reason Reason for the dump
+     * @param format Binary (.zfr) or JSON (.json)
      * @return Path to the dump file
      */
-    QString dumpToDisk(const QString& reason);
+    QString dumpToDisk(const QString& reason, DumpFormat format = DumpFormat::Binary);
+    
+    /**
+     * @brief Binary dump layout: DumpHeader, the reason (UTF-8, zero-padded
+     * to 8 bytes), then recordCount StateChangeRecords exactly as held in
+     * memory (little-endian, 48 bytes each).
+     */
+    struct DumpHeader {
+        char magic[4];            ///< "ZFRD"
+        uint16_t version;
+        uint16_t recordSize;      ///< sizeof(StateChangeRecord) of the writer
+        uint32_t recordCount;
+        uint32_t reasonLength;    ///< Bytes, before padding
+        uint64_t dumpTimestamp;   ///< ms since epoch
+        uint64_t reserved;
+    };
+    
+    struct DumpContents {
+        QString reason;
+        qint64 dumpTimestamp = 0;
+        std::vector<StateChangeRecord> records;
+    };
+    
+    /**
+     * @brief Parse a binary dump (offline tooling).
+     * A dump cut short keeps its complete records; *error then says so.
+     */
+    static bool decodeDump(const QByteArray& data, DumpContents* out, QString* error = nullptr);
+    
+    /**
+     * @brief JSON form shared by the JSON dump and the decoder.
+     */
+    static QJsonObject dumpToJson(const QString& reason, qint64 dumpTimestamp,
+                                  const std::vector<StateChangeRecord>& records);
+    
+    static constexpr char DUMP_MAGIC[4] = {'Z', 'F', 'R', 'D'};
+    static constexpr uint16_t DUMP_VERSION = 1;
+    static constexpr int MAX_REASON_BYTES = 256;
+    
+    /**
+     * @brief Move the ring into a memory-mapped file.
+     * Records already in the file (the previous run) are recovered, minus
+     * any a killed writer left half-written and any older than
+     * MAX_BUFFER_DURATION_MS, followed by the records held so far.
+     * Must be called before other threads start recording.
+     * Durable against process death, not power loss: pages are not synced.
+     * @param path Ring file; defaults to flight_recorder.ring in the dump directory
+     * @return false if the file is locked by another process or can't be
+     *         mapped; the recorder then stays on the heap
+     */
+    bool openPersistent(const QString& path = QString());
+    
+    bool isPersistent() const { return m_mapping != nullptr; }
+    
+    /**
+     * @brief True if the file opened by openPersistent() was not closed
+     * cleanly, i.e. the previous run crashed or was killed.
+     */
+    bool recoveredAfterCrash() const { return m_recoveredAfterCrash; }
+    
+    /**
+     * @brief Records recovered from the file by openPersistent().
+     */
+    int recoveredCount() const { return m_recoveredCount; }
     
     /**
      * @brief Get recent records (last N entries).
@@ -67,7 +162,9 @@ public:
     void clear();
     
     /**
-     * @brief Get the number of records currently stored.
+     * @brief Get the number of records currently held by the ring.
+     * O(1); snapshots and dumps additionally drop records older than
+     * MAX_BUFFER_DURATION_MS.
      */
     int recordCount() const;
     
@@ -77,19 +174,64 @@ public:
     static constexpr uint64_t MAX_BUFFER_DURATION_MS = 5 * 60 * 1000;
     
     /**
-     * @brief Maximum number of records (prevents unbounded growth).
+     * @brief Ring capacity (power of two; oldest records are overwritten).
      */
-    static constexpr size_t MAX_RECORDS = 10000;
+    static constexpr size_t MAX_RECORDS = 16384;
+    static_assert((MAX_RECORDS & (MAX_RECORDS - 1)) == 0, "MAX_RECORDS must be a power of two");
     
 signals:
     void recordCountChanged(int count);
     void dumpCreated(const QString& path, const QString& reason);
     
 private:
-    void pruneOldRecords();
+    // Record stored as relaxed atomic words so torn reads are detected, not UB
+    static constexpr size_t RECORD_WORDS = (sizeof(StateChangeRecord) + 7) / 8;
+    
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq{0};   // 2*(n+1): record n published; odd: being written
+        std::atomic<uint64_t> words[RECORD_WORDS];
+    };
+    
+    // Ring bookkeeping; the start of the ring file in persistent mode
+    struct alignas(64) RingHeader {
+        char magic[4] = {};             // "ZFRR" once the file is initialised
+        uint16_t version = 0;
+        uint16_t recordSize = 0;
+        uint32_t capacity = 0;
+        uint32_t cleanShutdown = 0;     // Set by the destructor, cleared on open
+        alignas(64) std::atomic<uint64_t> head{0};   // Next sequence number to claim
+        alignas(64) std::atomic<uint64_t> tail{0};   // First sequence number after clear()
+    };
+    
+    static constexpr char RING_MAGIC[4] = {'Z', 'F', 'R', 'R'};
+    static constexpr uint16_t RING_VERSION = 1;
+    static constexpr qint64 RING_FILE_SIZE = sizeof(RingHeader) + MAX_RECORDS * sizeof(Slot);
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Mapped ring needs address-free atomics");
+    
+    bool readSlot(uint64_t n, StateChangeRecord& out) const;
+    size_t copyRecords(StateChangeRecord* out, size_t count) const;
+    std::vector<StateChangeRecord> snapshot(size_t count) const;
+    QString writeBinaryDump(const QString& path, const QString& reason);
+    
+    static constexpr size_t DUMP_BUFFER_SIZE = sizeof(DumpHeader) + MAX_REASON_BYTES
+                                             + MAX_RECORDS * sizeof(StateChangeRecord);
+    
+    void closePersistent();
+    
+    // Either the heap storage below or the mapped file
+    RingHeader* m_ring = nullptr;
+    Slot* m_slots = nullptr;
+    std::unique_ptr<RingHeader> m_heapRing;
+    std::unique_ptr<Slot[]> m_heapSlots;
+    
+    std::unique_ptr<QFile> m_ringFile;
+    std::unique_ptr<QLockFile> m_ringLock;
+    uchar* m_mapping = nullptr;
+    bool m_recoveredAfterCrash = false;
+    int m_recoveredCount = 0;
     
-    mutable QMutex m_mutex;
-    std::vector<StateChangeRecord> m_buffer;
+    std::unique_ptr<char[]> m_dumpBuffer;           // Reserved for the failure path
+    std::atomic_flag m_dumpBusy = ATOMIC_FLAG_INIT;
     QString m_dumpDir;
 };
 
@@ -0,0 +1,66 @@
+/**
+ * zereca_dumpdecode - Convert binary flight recorder dumps to JSON
+ *
+ * Binary dumps (.zfr) are written by FlightRecorder::dumpToDisk on the
+ * failure path; this turns one into the same JSON the recorder writes in
+ * JSON mode:
+ *
+ *   zereca_dumpdecode <dump.zfr> [--out=<file.json>]
+ */
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+
+#include "core/FlightRecorder.h"
+
+#include <cstdio>
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QString inPath;
+    QString outPath;
+    bool usage = false;
+    for (const QString& arg : app.arguments().mid(1)) {
+        if (arg.startsWith("--out=")) outPath = arg.mid(6);
+        else if (inPath.isEmpty() && !arg.startsWith("--")) inPath = arg;
+        else usage = true;
+    }
+    if (usage || inPath.isEmpty()) {
+        std::fprintf(stderr, "usage: zereca_dumpdecode <dump.zfr> [--out=<file.json>]\n");
+        return 2;
+    }
+
+    QFile in(inPath);
+    if (!in.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "cannot read %s\n", qPrintable(inPath));
+        return 1;
+    }
+
+    Zereca::FlightRecorder::DumpContents dump;
+    QString error;
+    if (!Zereca::FlightRecorder::decodeDump(in.readAll(), &dump, &error)) {
+        std::fprintf(stderr, "%s: %s\n", qPrintable(inPath), qPrintable(error));
+        return 1;
+    }
+    if (!error.isEmpty()) {
+        std::fprintf(stderr, "%s: warning: %s\n", qPrintable(inPath), qPrintable(error));
+    }
+
+    const QByteArray json = QJsonDocument(Zereca::FlightRecorder::dumpToJson(
+        dump.reason, dump.dumpTimestamp, dump.records)).toJson(QJsonDocument::Indented);
+
+    if (outPath.isEmpty()) {
+        std::fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+    } else {
+        QFile out(outPath);
+        if (!out.open(QIODevice::WriteOnly)) {
+            std::fprintf(stderr, "cannot write %s\n", qPrintable(outPath));
+            return 1;
+        }
+        out.write(json);
+    }
+    return 0;
+}
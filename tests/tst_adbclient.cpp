@@ -0,0 +1,452 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QSemaphore>
+#include <QHash>
+
+#include "core/adb/AdbSocketClient.h"
+#include "core/adb/AdbDeviceTracker.h"
+
+using NeoZ::AdbSocketClient;
+using NeoZ::AdbDeviceTracker;
+
+/**
+ * @brief Minimal adb server speaking the smart-socket protocol.
+ *
+ * Runs on its own thread so the client's blocking calls can be exercised.
+ * Knows one device ("emulator-5554"), answers shell:/exec: with canned
+ * output and keeps sync: files in memory. track-devices plays a short
+ * script: device online, then offline, then unplugged.
+ */
+class FakeAdbServer : public QThread
+{
+public:
+    static constexpr const char* SERIAL = "emulator-5554";
+
+    quint16 port() const { return m_port; }
+
+    void startAndWait()
+    {
+        start();
+        m_ready.acquire();
+    }
+
+    void shutdown()
+    {
+        quit();
+        wait();
+    }
+
+protected:
+    void run() override
+    {
+        QTcpServer server;
+        server.listen(QHostAddress::LocalHost, 0);
+        m_port = server.serverPort();
+        QObject::connect(&server, &QTcpServer::newConnection, [&]() {
+            while (QTcpSocket* socket = server.nextPendingConnection()) {
+                auto* state = new Connection{socket};
+                QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, state]() { onData(*state); });
+                QObject::connect(socket, &QTcpSocket::disconnected, socket, [socket, state]() {
+                    delete state;
+                    socket->deleteLater();
+                });
+            }
+        });
+        m_ready.release();
+        exec();
+    }
+
+private:
+    enum class Mode { Host, Device, Sync };
+
+    struct Connection {
+        QTcpSocket* socket;
+        QByteArray buffer;
+        Mode mode = Mode::Host;
+        QByteArray sendPath;
+        QByteArray sendData;
+    };
+
+    static QByteArray le32(quint32 v)
+    {
+        QByteArray out;
+        for (int i = 0; i < 4; ++i) out.append(static_cast<char>((v >> (8 * i)) & 0xFF));
+        return out;
+    }
+
+    static quint32 readLe32(const QByteArray& b, int at)
+    {
+        const auto* u = reinterpret_cast<const uchar*>(b.constData() + at);
+        return quint32(u[0]) | quint32(u[1]) << 8 | quint32(u[2]) << 16 | quint32(u[3]) << 24;
+    }
+
+    static QByteArray listing(const QByteArray& list)
+    {
+        return QByteArray::number(list.size(), 16).rightJustified(4, '0') + list;
+    }
+
+    static QByteArray fail(const QByteArray& message)
+    {
+        return "FAIL" + QByteArray::number(message.size(), 16).rightJustified(4, '0') + message;
+    }
+
+    void onData(Connection& c)
+    {
+        c.buffer += c.socket->readAll();
+        if (c.mode == Mode::Sync) {
+            handleSync(c);
+            return;
+        }
+
+        while (c.buffer.size() >= 4) {
+            int len = c.buffer.left(4).toInt(nullptr, 16);
+            if (c.buffer.size() < 4 + len) return;
+            QByteArray request = c.buffer.mid(4, len);
+            c.buffer.remove(0, 4 + len);
+
+            if (request == "host:version") {
+                c.socket->write("OKAY00040029");
+            } else if (request == "host:devices") {
+                QByteArray list = QByteArray(SERIAL) + "\tdevice\n";
+                c.socket->write("OKAY" + QByteArray::number(list.size(), 16).rightJustified(4, '0') + list);
+            } else if (request == "host:devices-l") {
+                c.socket->write("OKAY" + listing(QByteArray(SERIAL) + "          device product:sdk model:Pixel_7 transport_id:1\n"));
+            } else if (request == "host:track-devices-l") {
+                c.socket->write("OKAY" + listing(QByteArray(SERIAL) + "          device product:sdk model:Pixel_7 transport_id:1\n"));
+                QTcpSocket* socket = c.socket;
+                QTimer::singleShot(50, socket, [socket]() {
+                    socket->write(listing(QByteArray(SERIAL) + "          offline transport_id:1\n"));
+                });
+                QTimer::singleShot(100, socket, [socket]() { socket->write(listing("")); });
+                return;
+            } else if (request.startsWith("host:transport:")) {
+                if (request.mid(15) != SERIAL) {
+                    c.socket->write(fail("device '" + request.mid(15) + "' not found"));
+                    c.socket->disconnectFromHost();
+                    return;
+                }
+                c.socket->write("OKAY");
+                c.mode = Mode::Device;
+            } else if (c.mode == Mode::Device && request.startsWith("shell:")) {
+                QByteArray cmd = request.mid(6);
+                c.socket->write("OKAY");
+                c.socket->write(cmd == "echo hello" ? QByteArray("hello\n") : "ran:" + cmd + "\n");
+                c.socket->disconnectFromHost();
+                return;
+            } else if (c.mode == Mode::Device && request.startsWith("exec:")) {
+                c.socket->write("OKAY");
+                c.socket->write(QByteArray("\x00\x01\x02\xff", 4));
+                c.socket->disconnectFromHost();
+                return;
+            } else if (c.mode == Mode::Device && request == "sync:") {
+                c.socket->write("OKAY");
+                c.mode = Mode::Sync;
+                handleSync(c);
+                return;
+            } else {
+                c.socket->write(fail("unknown service"));
+                c.socket->disconnectFromHost();
+                return;
+            }
+        }
+    }
+
+    void handleSync(Connection& c)
+    {
+        while (c.buffer.size() >= 8) {
+            QByteArray id = c.buffer.left(4);
+            quint32 len = readLe32(c.buffer, 4);
+            // DONE carries mtime in the length slot, no payload
+            quint32 payloadLen = id == "DONE" ? 0 : len;
+            if (static_cast<quint32>(c.buffer.size()) < 8 + payloadLen) return;
+            QByteArray payload = c.buffer.mid(8, payloadLen);
+            c.buffer.remove(0, 8 + payloadLen);
+
+            if (id == "STAT") {
+                bool exists = m_files.contains(payload);
+                c.socket->write("STAT" + le32(exists ? 0100644 : 0)
+                                + le32(exists ? m_files[payload].size() : 0) + le32(m_mtimes.value(payload)));
+            } else if (id == "RECV") {
+                if (payload == "/oversized") {
+                    // Claims far more than one packet may carry, then stalls
+                    c.socket->write("DATA" + le32(0x7fffffff));
+                    continue;
+                }
+                if (!m_files.contains(payload)) {
+                    QByteArray msg = "No such file";
+                    c.socket->write("FAIL" + le32(msg.size()) + msg);
+                    continue;
+                }
+                const QByteArray& data = m_files[payload];
+                for (int off = 0; off < data.size(); off += 3) {   // Tiny chunks exercise reassembly
+                    QByteArray chunk = data.mid(off, 3);
+                    c.socket->write("DATA" + le32(chunk.size()) + chunk);
+                }
+                c.socket->write("DONE" + le32(0));
+            } else if (id == "SEND") {
+                c.sendPath = payload.left(payload.lastIndexOf(','));
+                c.sendData.clear();
+            } else if (id == "DATA") {
+                c.sendData += payload;
+            } else if (id == "DONE") {
+                m_files[c.sendPath] = c.sendData;
+                m_mtimes[c.sendPath] = len;
+                c.socket->write("OKAY" + le32(0));
+            } else if (id == "QUIT") {
+                c.socket->disconnectFromHost();
+                return;
+            }
+        }
+    }
+
+    QSemaphore m_ready;
+    quint16 m_port = 0;
+    QHash<QByteArray, QByteArray> m_files;   // Server thread only
+    QHash<QByteArray, quint32> m_mtimes;
+};
+
+class TestAdbSocketClient : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase()
+    {
+        m_server.startAndWait();
+        m_client.setServer("127.0.0.1", m_server.port());
+    }
+
+    void cleanupTestCase()
+    {
+        m_server.shutdown();
+    }
+
+    void testEncodeRequest()
+    {
+        QCOMPARE(AdbSocketClient::encodeRequest("host:version"), QByteArray("000chost:version"));
+    }
+
+    void testHostServices()
+    {
+        QCOMPARE(m_client.serverVersion(), 41);
+
+        bool ok = false;
+        auto devices = m_client.devices(2000, &ok);
+        QVERIFY(ok);
+        QCOMPARE(devices.size(), 1);
+        QCOMPARE(devices[0].serial, QString(FakeAdbServer::SERIAL));
+        QCOMPARE(devices[0].state, QString("device"));
+        QCOMPARE(devices[0].model, QString("Pixel_7"));
+    }
+
+    void testParseDevices()
+    {
+        auto devices = AdbSocketClient::parseDevices(
+            "emulator-5554\tdevice\n"
+            "127.0.0.1:5555         offline transport_id:4\n"
+            "0123456789ABCDEF       no permissions (user in plugdev group; are your udev rules wrong?); "
+            "see [http://developer.android.com/tools/device.html] usb:1-1 transport_id:2\n"
+            "R58M123               unauthorized usb:2-1 product:a51 model:SM_A515F device:a51 transport_id:3\n"
+            "\n");
+        QCOMPARE(devices.size(), 4);
+        QCOMPARE(devices[0].state, QString("device"));
+        QCOMPARE(devices[1].state, QString("offline"));
+        QCOMPARE(devices[1].transportId, QString("4"));
+        QCOMPARE(devices[2].serial, QString("0123456789ABCDEF"));
+        QVERIFY(devices[2].state.startsWith("no permissions (user in plugdev group;"));
+        QVERIFY(devices[2].state.endsWith("device.html]"));
+        QCOMPARE(devices[2].transportId, QString("2"));
+        QCOMPARE(devices[3].state, QString("unauthorized"));
+        QCOMPARE(devices[3].model, QString("SM_A515F"));
+        QCOMPARE(devices[3].product, QString("a51"));
+    }
+
+    void testServerAvailabilityCached()
+    {
+        FakeAdbServer server;
+        server.startAndWait();
+        AdbSocketClient client;
+        client.setServer("127.0.0.1", server.port());
+        QVERIFY(client.isServerAvailable());
+
+        // Within the TTL the answer comes from the cache, without a round trip
+        server.shutdown();
+        QVERIFY(client.isServerAvailable());
+
+        // A failed connection refreshes it right away
+        QTest::qWait(100);   // Pooled sockets notice the server is gone
+        QVERIFY(!client.shell(FakeAdbServer::SERIAL, "echo hello", 500).ok);
+        QVERIFY(!client.isServerAvailable());
+
+        client.setServer("127.0.0.1", m_server.port());
+        QVERIFY(client.isServerAvailable());
+    }
+
+    void testShellAndExec()
+    {
+        // Several round trips: later ones come from the warm pool
+        for (int i = 0; i < 5; ++i) {
+            auto reply = m_client.shell(FakeAdbServer::SERIAL, "echo hello");
+            QVERIFY2(reply.ok, qPrintable(reply.error));
+            QCOMPARE(reply.data, QByteArray("hello\n"));
+            QCoreApplication::processEvents();
+        }
+
+        auto raw = m_client.exec(FakeAdbServer::SERIAL, "screencap");
+        QVERIFY(raw.ok);
+        QCOMPARE(raw.data, QByteArray("\x00\x01\x02\xff", 4));
+    }
+
+    void testUnknownDeviceFails()
+    {
+        auto reply = m_client.shell("missing-device", "echo hello");
+        QVERIFY(!reply.ok);
+        QVERIFY(reply.error.contains("not found"));
+    }
+
+    void testShellAsync()
+    {
+        bool done = false;
+        AdbSocketClient::Reply result;
+        m_client.shellAsync(FakeAdbServer::SERIAL, "wm size", [&](const AdbSocketClient::Reply& r) {
+            result = r;
+            done = true;
+        });
+        QTRY_VERIFY(done);
+        QVERIFY(result.ok);
+        QCOMPARE(result.data, QByteArray("ran:wm size\n"));
+    }
+
+    void testSyncRoundTrip()
+    {
+        const QString path = "/data/local/tmp/neoz.bin";
+        QVERIFY(!m_client.stat(FakeAdbServer::SERIAL, path).mode);
+
+        QByteArray payload;
+        for (int i = 0; i < 1000; ++i) payload.append(static_cast<char>(i * 7));
+        auto pushed = m_client.push(FakeAdbServer::SERIAL, payload, path);
+        QVERIFY2(pushed.ok, qPrintable(pushed.error));
+
+        auto st = m_client.stat(FakeAdbServer::SERIAL, path);
+        QVERIFY(st.ok);
+        QCOMPARE(st.size, quint32(payload.size()));
+
+        auto pulled = m_client.pull(FakeAdbServer::SERIAL, path);
+        QVERIFY(pulled.ok);
+        QCOMPARE(pulled.data, payload);
+
+        QVERIFY(!m_client.pull(FakeAdbServer::SERIAL, "/missing").ok);
+
+        // A DATA length above SYNC_CHUNK is a protocol error, not a read to wait on
+        QElapsedTimer timer;
+        timer.start();
+        auto oversized = m_client.pull(FakeAdbServer::SERIAL, "/oversized");
+        QVERIFY(!oversized.ok);
+        QVERIFY(oversized.data.isEmpty());
+        QVERIFY(timer.elapsed() < 3000);
+    }
+
+    void testPushCached()
+    {
+        const QString path = "/data/local/tmp/job.sh";
+        QByteArray script = "echo hi\n";
+        bool uploaded = false;
+
+        QVERIFY(m_client.pushCached(FakeAdbServer::SERIAL, script, path, 0755, &uploaded).ok);
+        QVERIFY(uploaded);
+        QVERIFY(m_client.pushCached(FakeAdbServer::SERIAL, script, path, 0755, &uploaded).ok);
+        QVERIFY(!uploaded);   // Same content, device copy untouched
+
+        // Same content with another mode has to go up again
+        QVERIFY(m_client.pushCached(FakeAdbServer::SERIAL, script, path, 0644, &uploaded).ok);
+        QVERIFY(uploaded);
+        QVERIFY(m_client.pushCached(FakeAdbServer::SERIAL, script, path, 0644, &uploaded).ok);
+        QVERIFY(!uploaded);
+
+        script += "echo bye\n";
+        QVERIFY(m_client.pushCached(FakeAdbServer::SERIAL, script, path, 0755, &uploaded).ok);
+        QVERIFY(uploaded);
+        QCOMPARE(m_client.pull(FakeAdbServer::SERIAL, path).data, script);
+
+        m_client.forgetPushed(FakeAdbServer::SERIAL);
+        QVERIFY(m_client.pushCached(FakeAdbServer::SERIAL, script, path, 0755, &uploaded).ok);
+        QVERIFY(uploaded);
+    }
+
+    void testDeviceTracker()
+    {
+        AdbDeviceTracker tracker;
+        QSignalSpy added(&tracker, &AdbDeviceTracker::deviceAdded);
+        QSignalSpy changed(&tracker, &AdbDeviceTracker::deviceStateChanged);
+        QSignalSpy removed(&tracker, &AdbDeviceTracker::deviceRemoved);
+
+        tracker.setServer("127.0.0.1", m_server.port());
+        tracker.start();
+
+        QTRY_COMPARE(added.count(), 1);
+        QVERIFY(tracker.isTracking());
+        QCOMPARE(added[0][0].toString(), QString(FakeAdbServer::SERIAL));
+        QCOMPARE(added[0][1].toString(), QString("device"));
+        QCOMPARE(tracker.device(FakeAdbServer::SERIAL).model, QString("Pixel_7"));
+
+        QTRY_COMPARE(changed.count(), 1);
+        QCOMPARE(changed[0][1].toString(), QString("device"));
+        QCOMPARE(changed[0][2].toString(), QString("offline"));
+
+        QTRY_COMPARE(removed.count(), 1);
+        QVERIFY(tracker.devices().isEmpty());
+
+        tracker.stop();
+        QVERIFY(!tracker.isTracking());
+    }
+
+    void testDeviceTrackerParse()
+    {
+        const auto devices = AdbDeviceTracker::parseDeviceList(
+            "emulator-5554          device product:sdk model:Pixel_7 transport_id:1\n"
+            "0123456789ABCDEF       no permissions (missing udev rules? user is in the plugdev group); "
+            "see [http://developer.android.com/tools/device.html] usb:1-1 transport_id:2\n");
+        QCOMPARE(devices.size(), 2);
+        QCOMPARE(devices["emulator-5554"].model, QString("Pixel_7"));
+        QVERIFY(devices["0123456789ABCDEF"].state.startsWith("no permissions (missing udev rules?"));
+        QCOMPARE(devices["0123456789ABCDEF"].transportId, QString("2"));
+    }
+
+    void testDeviceTrackerRefused()
+    {
+        // A server that answers FAIL: one backoff step per refusal
+        QTcpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+        int attempts = 0;
+        connect(&server, &QTcpServer::newConnection, this, [&]() {
+            while (QTcpSocket* socket = server.nextPendingConnection()) {
+                ++attempts;
+                connect(socket, &QTcpSocket::readyRead, socket, [socket]() {
+                    socket->readAll();
+                    socket->write("FAIL0004nope");
+                });
+                connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+
+        AdbDeviceTracker tracker;
+        tracker.setServer("127.0.0.1", server.serverPort());
+        tracker.start();
+
+        // Attempts at 0, 250 and 750 ms; a doubled step would skip the third
+        QTest::qWait(1100);
+        QCOMPARE(attempts, 3);
+        QVERIFY(!tracker.isTracking());
+        tracker.stop();
+    }
+
+private:
+    FakeAdbServer m_server;
+    AdbSocketClient m_client;
+};
+
+QTEST_MAIN(TestAdbSocketClient)
+#include "tst_adbclient.moc"
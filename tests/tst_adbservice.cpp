@@ -0,0 +1,199 @@
+#include <QtTest>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+
+#include "adb_service/AdbService.h"
+#include "adb_service/AdbDeviceWorker.h"
+
+using NeoZ::AdbDeviceWorker;
+using NeoZ::AdbService;
+
+/**
+ * @brief Unit tests for AdbService request handling
+ *
+ * The same stand-in adb as tst_adbshell runs the device shell locally.
+ *
+ * - Worker: tickets echoed in requestFinished, one request timing out
+ *   without failing the requests queued behind it, a failed pidof fetch
+ *   reported as a failure rather than "not running"
+ * - Service: client ids echoed on responses, out-of-band Ping replies
+ */
+class TestAdbService : public QObject
+{
+    Q_OBJECT
+
+private:
+    QTemporaryDir m_dir;
+    QString m_adb;
+
+    static QJsonObject execute(const QString& command, int timeoutMs)
+    {
+        QJsonObject request;
+        request["type"] = "Execute";
+        request["command"] = command;
+        request["timeoutMs"] = timeoutMs;
+        return request;
+    }
+
+private slots:
+    void initTestCase()
+    {
+#ifdef Q_OS_WIN
+        QSKIP("Needs a POSIX sh to stand in for the device shell");
+#endif
+        QVERIFY(m_dir.isValid());
+        m_adb = m_dir.filePath("adb");
+
+        // `adb -s <serial> shell <command>` -> run <command> locally
+        QFile script(m_adb);
+        QVERIFY(script.open(QIODevice::WriteOnly));
+        script.write("#!/bin/sh\nshift 3\nexec /bin/sh -c \"$*\"\n");
+        script.close();
+        QVERIFY(script.setPermissions(script.permissions() | QFileDevice::ExeOwner));
+    }
+
+    void testWorkerTickets()
+    {
+        AdbDeviceWorker worker("fake-device", m_adb);
+        QSignalSpy spy(&worker, &AdbDeviceWorker::requestFinished);
+
+        QJsonObject batch;
+        batch["type"] = "ExecuteBatch";
+        batch["commands"] = QJsonArray({"echo a", "(exit 4)"});
+        worker.handleRequest(41, execute("echo hi", 5000));
+        worker.handleRequest(42, batch);
+        QJsonObject unknown;
+        unknown["type"] = "Reboot";
+        worker.handleRequest(43, unknown);
+
+        QTRY_COMPARE(spy.count(), 3);
+        QHash<quint64, QJsonObject> responses;
+        for (const QList<QVariant>& args : spy) {
+            responses.insert(args[0].toULongLong(), args[1].toJsonObject());
+        }
+        QCOMPARE(responses.size(), 3);
+        QCOMPARE(responses[41]["result"].toString(), QString("hi"));
+        QVERIFY(responses[41]["success"].toBool());
+        QCOMPARE(responses[42]["results"].toArray()[0].toString(), QString("a"));
+        QCOMPARE(responses[42]["exitCodes"].toArray()[1].toInt(), 4);
+        QVERIFY(!responses[43]["success"].toBool());
+    }
+
+    void testWorkerRequestTimeout()
+    {
+        AdbDeviceWorker worker("fake-device", m_adb);
+        QSignalSpy spy(&worker, &AdbDeviceWorker::requestFinished);
+
+        // The second request waits behind the sleep for longer than its own
+        // timeout: only time spent running counts against it
+        QElapsedTimer timer;
+        timer.start();
+        worker.handleRequest(1, execute("sleep 2", 300));
+        worker.handleRequest(2, execute("echo after", 1000));
+
+        QTRY_COMPARE(spy.count(), 1);
+        QVERIFY(timer.elapsed() < 1500);
+        QCOMPARE(spy[0][0].toULongLong(), quint64(1));
+        const QJsonObject timedOut = spy[0][1].toJsonObject();
+        QVERIFY(!timedOut["success"].toBool());
+        QVERIFY(timedOut["timedOut"].toBool());
+
+        QTRY_COMPARE_WITH_TIMEOUT(spy.count(), 2, 5000);
+        QCOMPARE(spy[1][0].toULongLong(), quint64(2));
+        const QJsonObject after = spy[1][1].toJsonObject();
+        QVERIFY(after["success"].toBool());
+        QCOMPARE(after["result"].toString(), QString("after"));
+        QVERIFY(!after.contains("timedOut"));
+    }
+
+    void testWorkerIsFreeFireRunning()
+    {
+        QJsonObject request;
+        request["type"] = "IsFreeFireRunning";
+
+        AdbDeviceWorker worker("fake-device", m_adb);
+        QSignalSpy spy(&worker, &AdbDeviceWorker::requestFinished);
+        worker.handleRequest(1, request);
+        QTRY_COMPARE(spy.count(), 1);
+        const QJsonObject notRunning = spy[0][1].toJsonObject();
+        QVERIFY(notRunning["success"].toBool());
+        QVERIFY(!notRunning["running"].toBool());
+
+        // A pidof that takes the device shell down with it: the query fails
+        QVERIFY(QDir(m_dir.path()).mkpath("broken/bin"));
+        QFile pidof(m_dir.filePath("broken/bin/pidof"));
+        QVERIFY(pidof.open(QIODevice::WriteOnly));
+        pidof.write("#!/bin/sh\nkill -9 $PPID\n");
+        pidof.close();
+        QVERIFY(pidof.setPermissions(pidof.permissions() | QFileDevice::ExeOwner));
+        QFile adb(m_dir.filePath("broken/adb"));
+        QVERIFY(adb.open(QIODevice::WriteOnly));
+        adb.write("#!/bin/sh\nshift 3\nPATH=\"" + m_dir.filePath("broken/bin").toUtf8()
+                  + ":$PATH\" exec /bin/sh -c \"$*\"\n");
+        adb.close();
+        QVERIFY(adb.setPermissions(adb.permissions() | QFileDevice::ExeOwner));
+
+        AdbDeviceWorker broken("fake-device", adb.fileName());
+        QSignalSpy brokenSpy(&broken, &AdbDeviceWorker::requestFinished);
+        broken.handleRequest(2, request);
+        QTRY_COMPARE_WITH_TIMEOUT(brokenSpy.count(), 1, 10000);
+        const QJsonObject failed = brokenSpy[0][1].toJsonObject();
+        QVERIFY(!failed["success"].toBool());
+        QVERIFY(!failed["running"].toBool());
+        QVERIFY(!failed["error"].toString().isEmpty());
+    }
+
+    void testServiceEchoesIds()
+    {
+        AdbService service;
+        service.setAdbPath(m_adb);
+        QVERIFY(service.start(0));
+        QVERIFY(service.port() != 0);
+
+        QTcpSocket socket;
+        socket.connectToHost(QHostAddress::LocalHost, service.port());
+        QVERIFY(socket.waitForConnected(3000));
+
+        QList<QJsonObject> responses;
+        connect(&socket, &QTcpSocket::readyRead, this, [&]() {
+            while (socket.canReadLine()) {
+                responses << QJsonDocument::fromJson(socket.readLine()).object();
+            }
+        });
+        auto send = [&](QJsonObject request, const QJsonValue& id) {
+            request["deviceId"] = "fake-device";
+            if (!id.isUndefined()) request["id"] = id;
+            socket.write(QJsonDocument(request).toJson(QJsonDocument::Compact) + "\n");
+        };
+
+        send(execute("sleep 1; echo slow", 5000), "slow");
+        QJsonObject ping;
+        ping["type"] = "Ping";
+        send(ping, 7);
+        send(execute("echo fast", 5000), "fast");
+        send(execute("echo anonymous", 5000), QJsonValue::Undefined);
+
+        QTRY_COMPARE_WITH_TIMEOUT(responses.size(), 4, 10000);
+
+        // Ping is answered inline, ahead of the device's queue
+        QCOMPARE(responses[0]["id"].toInt(), 7);
+
+        QHash<QString, QJsonObject> byId;
+        for (const QJsonObject& response : responses) {
+            byId.insert(response.contains("id") ? response["id"].toVariant().toString() : QString(), response);
+        }
+        QCOMPARE(byId.size(), 4);
+        QCOMPARE(byId["slow"]["result"].toString(), QString("slow"));
+        QCOMPARE(byId["fast"]["result"].toString(), QString("fast"));
+        QCOMPARE(byId[QString()]["result"].toString(), QString("anonymous"));
+    }
+};
+
+QTEST_MAIN(TestAdbService)
+#include "tst_adbservice.moc"
@@ -0,0 +1,360 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+#include <atomic>
+
+#include "core/adb/AdbShellSession.h"
+#include "core/adb/AdbConnection.h"
+
+using NeoZ::AdbConnection;
+using NeoZ::AdbShellSession;
+
+/**
+ * @brief Unit tests for the multiplexed adb shell
+ *
+ * A script standing in for the adb binary runs the "device" shell with the
+ * local /bin/sh, so sessions exercise the real framing end to end.
+ *
+ * - Sentinel parsing: trailing newlines, exit codes, marker look-alikes,
+ *   printf directives, empty commands, stderr on its own channel
+ * - Multiplexing: pipelined async commands complete in order around
+ *   synchronous ones
+ * - Per-command timeouts that leave the session and its queue alone
+ * - Session loss and reconnect
+ * - AdbConnection used from another thread
+ * - getCached(): hit / stale / coalesced / miss / failure counters, stale
+ *   values served while refreshing, failures cached for NEGATIVE_TTL_MS only
+ */
+class TestAdbShell : public QObject
+{
+    Q_OBJECT
+
+private:
+    QTemporaryDir m_dir;
+    QString m_adb;
+
+    void startSession(AdbShellSession& session)
+    {
+        session.setAdbPath(m_adb);
+        session.setDeviceId("fake-device");
+        QVERIFY(session.ensureRunning());
+    }
+
+    // A command whose output the test controls
+    QString valueCommand(const QString& value)
+    {
+        QFile file(m_dir.filePath("value"));
+        if (file.open(QIODevice::WriteOnly)) file.write(value.toUtf8());
+        return "cat '" + m_dir.filePath("value") + "'";
+    }
+
+private slots:
+    void initTestCase()
+    {
+#ifdef Q_OS_WIN
+        QSKIP("Needs a POSIX sh to stand in for the device shell");
+#endif
+        QVERIFY(m_dir.isValid());
+        m_adb = m_dir.filePath("adb");
+
+        // `adb -s <serial> shell <command>` -> run <command> locally
+        QFile script(m_adb);
+        QVERIFY(script.open(QIODevice::WriteOnly));
+        script.write("#!/bin/sh\nshift 3\nexec /bin/sh -c \"$*\"\n");
+        script.close();
+        QVERIFY(script.setPermissions(script.permissions() | QFileDevice::ExeOwner));
+    }
+
+    void testSentinelParsing()
+    {
+        AdbShellSession session;
+        startSession(session);
+
+        AdbShellSession::Result r = session.execute("printf abc");
+        QVERIFY(r.ok);
+        QCOMPARE(r.output, QString("abc"));
+        QCOMPARE(r.exitCode, 0);
+
+        r = session.execute("echo abc");
+        QCOMPARE(r.output, QString("abc\n"));
+
+        r = session.execute("(exit 7)");
+        QVERIFY(r.ok);
+        QCOMPARE(r.exitCode, 7);
+        QVERIFY(r.output.isEmpty());
+
+        // Marker look-alikes and printf directives pass through untouched
+        r = session.execute("printf 'x__NEOZ_END_99_0__'; echo ' 50%d %1'");
+        QVERIFY(r.ok);
+        QCOMPARE(r.output, QString("x__NEOZ_END_99_0__ 50%d %1\n"));
+
+        r = session.execute("   ");
+        QVERIFY(r.ok);
+        QCOMPARE(r.exitCode, 0);
+        QVERIFY(r.output.isEmpty());
+
+        // stderr is captured separately and never leaks into stdout
+        r = session.execute("echo out; echo oops >&2; false");
+        QVERIFY(r.ok);
+        QCOMPARE(r.output, QString("out\n"));
+        QCOMPARE(r.error, QString("oops\n"));
+        QCOMPARE(r.exitCode, 1);
+
+        r = session.execute("echo quiet");
+        QVERIFY(r.error.isEmpty());
+        QCOMPARE(session.restartCount(), quint64(0));
+    }
+
+    void testMultiplexing()
+    {
+        AdbShellSession session;
+        startSession(session);
+
+        constexpr int COUNT = 50;
+        QList<int> order;
+        QStringList outputs;
+        for (int i = 0; i < COUNT; ++i) {
+            session.submit(QString("echo %1").arg(i), [&order, &outputs, i](const AdbShellSession::Result& r) {
+                order << i;
+                outputs << r.output;
+            });
+        }
+
+        // A synchronous command queues behind them and pumps them through
+        AdbShellSession::Result r = session.execute("echo sync");
+        QCOMPARE(r.output, QString("sync\n"));
+        QCOMPARE(order.size(), COUNT);
+        for (int i = 0; i < COUNT; ++i) {
+            QCOMPARE(order[i], i);
+            QCOMPARE(outputs[i], QString::number(i) + "\n");
+        }
+
+        const QList<AdbShellSession::Result> all = session.executeAll({"echo a", "echo b >&2", "(exit 3)"});
+        QCOMPARE(all.size(), 3);
+        QCOMPARE(all[0].output, QString("a\n"));
+        QVERIFY(all[1].output.isEmpty());
+        QCOMPARE(all[1].error, QString("b\n"));
+        QCOMPARE(all[2].exitCode, 3);
+
+        QCOMPARE(session.pendingCount(), 0);
+        QCOMPARE(session.restartCount(), quint64(0));
+    }
+
+    void testSessionLost()
+    {
+        AdbShellSession session;
+        startSession(session);
+
+        // Exits the shell itself: the command fails with the reason
+        AdbShellSession::Result r = session.execute("exit 3");
+        QVERIFY(!r.ok);
+        QVERIFY(!r.error.isEmpty());
+        QVERIFY(!session.isRunning());
+
+        // Reconnects once the backoff has passed
+        QTest::qWait(1100);
+        r = session.execute("echo back");
+        QVERIFY(r.ok);
+        QCOMPARE(r.output, QString("back\n"));
+        QCOMPARE(session.restartCount(), quint64(1));
+    }
+
+    void testCommandTimeout()
+    {
+        AdbShellSession session;
+        startSession(session);
+
+        // Times out alone; the command queued behind it waits its turn and
+        // its own clock only starts once the sleep is done
+        QElapsedTimer timer;
+        timer.start();
+        AdbShellSession::Result slow;
+        AdbShellSession::Result next;
+        qint64 slowMs = -1;
+        session.submit("sleep 1", [&](const AdbShellSession::Result& r) {
+            slow = r;
+            slowMs = timer.elapsed();
+        }, 200);
+        session.submit("echo next", [&](const AdbShellSession::Result& r) { next = r; }, 300);
+
+        QTRY_VERIFY(slowMs >= 0);
+        QVERIFY(slowMs < 900);
+        QVERIFY(slow.timedOut);
+        QVERIFY(!slow.ok);
+        QTRY_COMPARE(next.output, QString("next\n"));
+        QVERIFY(!next.timedOut);
+
+        // Synchronous callers time out the same way, without a restart
+        AdbShellSession::Result r = session.execute("sleep 1", 200);
+        QVERIFY(r.timedOut);
+        QVERIFY(session.isRunning());
+        r = session.execute("echo after");
+        QVERIFY(r.ok);
+        QCOMPARE(r.output, QString("after\n"));
+
+        QCOMPARE(session.pendingCount(), 0);
+        QCOMPARE(session.restartCount(), quint64(0));
+    }
+
+    void testConnectionFromOtherThread()
+    {
+        QTest::failOnWarning(QRegularExpression("thread", QRegularExpression::CaseInsensitiveOption));
+
+        AdbConnection conn;
+        conn.setAdbPath(m_adb);
+        QVERIFY(conn.connect("fake-device"));
+
+        // Stopped shell: the next command has to start it, on the owner thread
+        conn.session()->setDeviceId("fake-device-2");
+        QVERIFY(!conn.session()->isRunning());
+
+        QString result;
+        bool ok = false;
+        QThread* caller = QThread::create([&]() { result = conn.execute("echo hi", 5000, &ok); });
+        caller->start();
+        QTRY_VERIFY(caller->isFinished());
+        delete caller;
+
+        QVERIFY(ok);
+        QCOMPARE(result, QString("hi"));
+        QVERIFY(conn.session()->isRunning());
+
+        QString asyncResult;
+        QThread* callbackThread = nullptr;
+        caller = QThread::create([&]() {
+            conn.executeAsync("echo async", [&](const QString& r) {
+                asyncResult = r;
+                callbackThread = QThread::currentThread();
+            });
+        });
+        caller->start();
+        QTRY_COMPARE(asyncResult, QString("async"));
+        QCOMPARE(callbackThread, thread());
+        caller->wait();
+        delete caller;
+    }
+
+    void testCacheHitsAndMisses()
+    {
+        AdbConnection conn;
+        conn.setAdbPath(m_adb);
+        QVERIFY(conn.connect("fake-device"));
+
+        const QString cmd = valueCommand("v1");
+        bool ok = false;
+        QCOMPARE(conn.getCached(cmd, 5000, &ok), QString("v1"));
+        QVERIFY(ok);
+        QCOMPARE(conn.getCached(cmd, 5000), QString("v1"));
+        QCOMPARE(conn.cacheStats().misses, quint64(1));
+        QCOMPARE(conn.cacheStats().hits, quint64(1));
+
+        // Other threads are forwarded to the owner and share the entry
+        std::atomic<int> matched{0};
+        QList<QThread*> callers;
+        for (int i = 0; i < 4; ++i) {
+            callers << QThread::create([&]() {
+                if (conn.getCached(cmd, 5000) == "v1") matched++;
+            });
+            callers.last()->start();
+        }
+        for (QThread* t : callers) {
+            QTRY_VERIFY(t->isFinished());
+            delete t;
+        }
+        QCOMPARE(matched.load(), 4);
+
+        const AdbConnection::CacheStats stats = conn.cacheStats();
+        QCOMPARE(stats.misses, quint64(1));
+        QCOMPARE(stats.hits, quint64(5));
+        QCOMPARE(stats.failures, quint64(0));
+    }
+
+    void testCacheCoalesced()
+    {
+        AdbConnection conn;
+        conn.setAdbPath(m_adb);
+        QVERIFY(conn.connect("fake-device"));
+
+        const QString cmd = valueCommand("v1");
+        QStringList values;
+        for (int i = 0; i < 3; ++i) {
+            conn.getCachedAsync(cmd, 5000, [&values](const QString& value, bool ok) {
+                if (ok) values << value;
+            });
+        }
+        QCOMPARE(conn.cacheStats().misses, quint64(1));
+        QCOMPARE(conn.cacheStats().coalesced, quint64(2));
+        QTRY_COMPARE(values.size(), 3);
+        QCOMPARE(values, QStringList({"v1", "v1", "v1"}));
+
+        // A synchronous caller joins an async fetch in flight
+        conn.invalidateCache();
+        valueCommand("v2");
+        conn.getCachedAsync(cmd, 5000, [&values](const QString& value, bool) { values << value; });
+        QCOMPARE(conn.getCached(cmd, 5000), QString("v2"));
+        QCOMPARE(values.size(), 4);
+        QCOMPARE(values.last(), QString("v2"));
+
+        const AdbConnection::CacheStats stats = conn.cacheStats();
+        QCOMPARE(stats.misses, quint64(2));
+        QCOMPARE(stats.coalesced, quint64(3));
+    }
+
+    void testCacheServesStale()
+    {
+        AdbConnection conn;
+        conn.setAdbPath(m_adb);
+        QVERIFY(conn.connect("fake-device"));
+
+        const QString cmd = valueCommand("v1");
+        QCOMPARE(conn.getCached(cmd, 200), QString("v1"));
+
+        // Past the TTL but inside the stale window: old value now, refresh behind it
+        valueCommand("v2");
+        QTest::qWait(250);
+        QCOMPARE(conn.getCached(cmd, 200), QString("v1"));
+        QCOMPARE(conn.cacheStats().staleHits, quint64(1));
+        QCOMPARE(conn.cacheStats().misses, quint64(2));
+        QTRY_COMPARE(conn.getCached(cmd, 200), QString("v2"));
+
+        // Past the stale window it is a plain miss again
+        valueCommand("v3");
+        QTest::qWait(700);
+        const quint64 staleHits = conn.cacheStats().staleHits;
+        QCOMPARE(conn.getCached(cmd, 200), QString("v3"));
+        QCOMPARE(conn.cacheStats().staleHits, staleHits);
+    }
+
+    void testCacheNegativeTtl()
+    {
+        AdbConnection conn;
+        conn.setAdbPath(m_adb);
+        QVERIFY(conn.connect("fake-device"));
+
+        // Kills the shell: the fetch fails and the failure is cached
+        bool ok = true;
+        QCOMPARE(conn.getCached("exit 3", 5000, &ok), QString());
+        QVERIFY(!ok);
+        QCOMPARE(conn.cacheStats().failures, quint64(1));
+        QCOMPARE(conn.cacheStats().misses, quint64(1));
+
+        ok = true;
+        conn.getCached("exit 3", 5000, &ok);
+        QVERIFY(!ok);
+        QCOMPARE(conn.cacheStats().hits, quint64(1));
+        QCOMPARE(conn.cacheStats().misses, quint64(1));
+
+        // Held for NEGATIVE_TTL_MS (1 s), not the 5 s asked for, and never served stale
+        QTest::qWait(1100);
+        conn.getCached("exit 3", 5000, &ok);
+        const AdbConnection::CacheStats stats = conn.cacheStats();
+        QCOMPARE(stats.misses, quint64(2));
+        QCOMPARE(stats.staleHits, quint64(0));
+        QCOMPARE(stats.failures, quint64(2));
+    }
+};
+
+QTEST_MAIN(TestAdbShell)
+#include "tst_adbshell.moc"
@@ -0,0 +1,418 @@
+#include <QtTest>
+#include <QtEndian>
+#include <QFile>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QVideoFrame>
+#include <QVideoFrameFormat>
+#include <algorithm>
+#include <utility>
+
+#include "core/aim/CrosshairDetector.h"
+#include "core/aim/CrosshairStream.h"
+
+using NeoZ::CrosshairDetector;
+using NeoZ::CrosshairStream;
+
+namespace {
+
+struct Yuv {
+    uchar y, u, v;
+};
+
+constexpr Yuv WHITE{235, 128, 128};
+constexpr Yuv RED{82, 90, 240};      // BT.601 limited range
+
+// Minimal H.264 Baseline writer: every frame one IDR slice of I_PCM
+// macroblocks, so tests get a real elementary stream without an encoder
+class H264Writer
+{
+public:
+    H264Writer(int width, int height)
+        : m_mbWidth(width / 16)
+        , m_mbHeight(height / 16)
+    {
+        // SPS: Baseline, level 3.0, POC type 2, no VUI
+        bits(66, 8); bits(0xC0, 8); bits(30, 8);
+        ue(0); ue(0); ue(2); ue(1); bit(0);
+        ue(m_mbWidth - 1); ue(m_mbHeight - 1);
+        bit(1); bit(1); bit(0); bit(0);
+        nal(0x67);
+
+        // PPS: CAVLC, one slice group, QP 26
+        ue(0); ue(0); bit(0); bit(0); ue(0); ue(0); ue(0);
+        bit(0); bits(0, 2); se(0); se(0); se(0);
+        bit(0); bit(0); bit(0);
+        nal(0x68);
+    }
+
+    void addFrame(const Yuv& color)
+    {
+        ue(0); ue(7); ue(0);          // first_mb_in_slice, slice_type I, pps id
+        bits(0, 4);                   // frame_num
+        ue(m_idrPicId++ % 2);         // Consecutive IDRs need different ids
+        bit(0); bit(0);               // dec_ref_pic_marking
+        se(0);                        // slice_qp_delta
+
+        for (int mb = 0; mb < m_mbWidth * m_mbHeight; ++mb) {
+            ue(25);                   // I_PCM
+            while (m_bitCount) bit(0);
+            m_rbsp.append(QByteArray(256, char(color.y)));
+            m_rbsp.append(QByteArray(64, char(color.u)));
+            m_rbsp.append(QByteArray(64, char(color.v)));
+        }
+        nal(0x65);
+    }
+
+    const QByteArray& data() const { return m_stream; }
+
+private:
+    void bit(int b)
+    {
+        m_current = uchar(m_current << 1 | (b & 1));
+        if (++m_bitCount == 8) {
+            m_rbsp.append(char(m_current));
+            m_current = 0;
+            m_bitCount = 0;
+        }
+    }
+
+    void bits(quint32 value, int count)
+    {
+        for (int i = count - 1; i >= 0; --i) bit(int(value >> i));
+    }
+
+    void ue(quint32 value)
+    {
+        const quint32 x = value + 1;
+        int length = 0;
+        while (x >> (length + 1)) ++length;
+        bits(0, length);
+        bits(x, length + 1);
+    }
+
+    void se(int value)
+    {
+        ue(value > 0 ? quint32(2 * value - 1) : quint32(-2 * value));
+    }
+
+    void nal(uchar header)
+    {
+        bit(1);                       // rbsp_trailing_bits
+        while (m_bitCount) bit(0);
+
+        m_stream.append(QByteArray("\0\0\0\1", 4));
+        m_stream.append(char(header));
+        int zeros = 0;
+        for (char c : std::as_const(m_rbsp)) {
+            if (zeros >= 2 && uchar(c) <= 3) {
+                m_stream.append(char(3));   // Emulation prevention
+                zeros = 0;
+            }
+            m_stream.append(c);
+            zeros = c == 0 ? zeros + 1 : 0;
+        }
+        m_rbsp.clear();
+    }
+
+    int m_mbWidth;
+    int m_mbHeight;
+    int m_idrPicId = 0;
+    QByteArray m_rbsp;
+    QByteArray m_stream;
+    uchar m_current = 0;
+    int m_bitCount = 0;
+};
+
+// Gray level of a neutral-chroma pixel, as CrosshairStream converts it
+int lumaToGray(int y)
+{
+    return std::clamp((298 * (y - 16) + 128) >> 8, 0, 255);
+}
+
+} // namespace
+
+/**
+ * @brief Unit tests for the crosshair capture backends
+ *
+ * - Raw screencap: header parsing (size, pixel format, limits) and the
+ *   12- / 16-byte header length derived from the total size
+ * - Sampling floor: 16 ms with raw capture, 30 ms on the PNG path
+ * - Video stream: center crops from NV12 / YUV420P / packed RGB frames,
+ *   a generated .h264 file replayed end to end, the same stream over a
+ *   socket with a pause in it (a gap is not the end), undecodable input
+ *   reported as an error rather than a normal end of stream
+ */
+class TestCrosshair : public QObject
+{
+    Q_OBJECT
+
+private:
+    // 8x6 frame, luma 16 + 10x + 20y, neutral chroma except the 2x2 block
+    // at (2..3, 2..3), which is red
+    static QVideoFrame yuvFrame(QVideoFrameFormat::PixelFormat format)
+    {
+        QVideoFrame frame(QVideoFrameFormat(QSize(8, 6), format));
+        if (!frame.map(QVideoFrame::WriteOnly)) return {};
+
+        for (int y = 0; y < 6; ++y) {
+            uchar* row = frame.bits(0) + y * frame.bytesPerLine(0);
+            for (int x = 0; x < 8; ++x) row[x] = uchar(16 + 10 * x + 20 * y);
+        }
+        for (int cy = 0; cy < 3; ++cy) {
+            for (int cx = 0; cx < 4; ++cx) {
+                const bool red = cx == 1 && cy == 1;
+                const uchar u = red ? RED.u : 128;
+                const uchar v = red ? RED.v : 128;
+                if (format == QVideoFrameFormat::Format_NV12) {
+                    uchar* uv = frame.bits(1) + cy * frame.bytesPerLine(1) + cx * 2;
+                    uv[0] = u;
+                    uv[1] = v;
+                } else {
+                    frame.bits(1)[cy * frame.bytesPerLine(1) + cx] = u;
+                    frame.bits(2)[cy * frame.bytesPerLine(2) + cx] = v;
+                }
+            }
+        }
+        frame.unmap();
+        return frame;
+    }
+
+    static void verifyYuvCrop(const QImage& crop)
+    {
+        // 2x2 from an 8x6 frame starts at (3, 2)
+        QCOMPARE(crop.size(), QSize(2, 2));
+        QCOMPARE(crop.format(), QImage::Format_RGB32);
+
+        const QRgb tinted = crop.pixel(0, 0);        // (3, 2): red chroma block
+        QVERIFY(qRed(tinted) > qGreen(tinted) + 50);
+        QVERIFY(qRed(tinted) > qBlue(tinted) + 50);
+
+        QCOMPARE(crop.pixel(1, 0), qRgb(lumaToGray(96), lumaToGray(96), lumaToGray(96)));     // (4, 2)
+        QCOMPARE(crop.pixel(1, 1), qRgb(lumaToGray(116), lumaToGray(116), lumaToGray(116)));  // (4, 3)
+        QVERIFY(qRed(crop.pixel(0, 1)) > qGreen(crop.pixel(0, 1)) + 50);                        // (3, 3)
+    }
+
+    static QByteArray rawHeader(quint32 width, quint32 height, quint32 format, quint32 colorSpace = 1)
+    {
+        QByteArray header(16, '\0');
+        qToLittleEndian(width, header.data());
+        qToLittleEndian(height, header.data() + 4);
+        qToLittleEndian(format, header.data() + 8);
+        qToLittleEndian(colorSpace, header.data() + 12);
+        return header;
+    }
+
+private slots:
+    // ========================================
+    // Raw Capture Tests
+    // ========================================
+
+    void testParseRawHeader()
+    {
+        CrosshairDetector::RawLayout layout = CrosshairDetector::parseRawHeader(rawHeader(1080, 2400, 1));
+        QVERIFY(layout.isValid());
+        QCOMPARE(layout.width, 1080);
+        QCOMPARE(layout.height, 2400);
+        QCOMPARE(layout.bytesPerPixel, 4);
+        QCOMPARE(layout.format, QImage::Format_RGBA8888);
+
+        // Older devices: 12-byte header, no color space field
+        layout = CrosshairDetector::parseRawHeader(rawHeader(720, 1280, 2).left(12));
+        QVERIFY(layout.isValid());
+        QCOMPARE(layout.format, QImage::Format_RGBX8888);
+
+        layout = CrosshairDetector::parseRawHeader(rawHeader(1920, 1080, 5));
+        QCOMPARE(layout.format, QImage::Format_ARGB32);   // BGRA_8888 in memory
+        QCOMPARE(layout.width, 1920);
+
+        // RGB_565, truncated, absurd or empty geometry: unsupported
+        QVERIFY(!CrosshairDetector::parseRawHeader(rawHeader(1080, 2400, 4)).isValid());
+        QVERIFY(!CrosshairDetector::parseRawHeader(rawHeader(1080, 2400, 1).left(11)).isValid());
+        QVERIFY(!CrosshairDetector::parseRawHeader(rawHeader(0x40000000, 2400, 1)).isValid());
+        QVERIFY(!CrosshairDetector::parseRawHeader(rawHeader(1080, 0, 1)).isValid());
+        QVERIFY(!CrosshairDetector::parseRawHeader(QByteArray()).isValid());
+    }
+
+    void testRawHeaderSize()
+    {
+        const CrosshairDetector::RawLayout layout = CrosshairDetector::parseRawHeader(rawHeader(1080, 2400, 1));
+        const qint64 pixels = qint64(1080) * 2400 * 4;
+
+        QCOMPARE(CrosshairDetector::rawHeaderSize(layout, pixels + 16), 16);
+        QCOMPARE(CrosshairDetector::rawHeaderSize(layout, pixels + 12), 12);
+
+        // Anything else means the layout guess is wrong (e.g. rotated mid-probe)
+        QCOMPARE(CrosshairDetector::rawHeaderSize(layout, pixels), 0);
+        QCOMPARE(CrosshairDetector::rawHeaderSize(layout, pixels + 14), 0);
+        QCOMPARE(CrosshairDetector::rawHeaderSize(layout, qint64(2400) * 1080 * 2 + 16), 0);
+        QCOMPARE(CrosshairDetector::rawHeaderSize(CrosshairDetector::RawLayout(), 16), 0);
+    }
+
+    void testSamplingFloor()
+    {
+        CrosshairDetector detector;
+        detector.setSamplingIntervalMs(1);
+        QCOMPARE(detector.samplingIntervalMs(), CrosshairDetector::MIN_INTERVAL_MS);
+        QCOMPARE(detector.effectiveSamplingIntervalMs(), CrosshairDetector::MIN_INTERVAL_MS);
+
+        // PNG capture keeps its own floor; the setting is remembered for raw
+        detector.setRawCaptureEnabled(false);
+        QCOMPARE(detector.samplingIntervalMs(), CrosshairDetector::MIN_INTERVAL_MS);
+        QCOMPARE(detector.effectiveSamplingIntervalMs(), CrosshairDetector::PNG_MIN_INTERVAL_MS);
+        detector.setSamplingIntervalMs(100);
+        QCOMPARE(detector.effectiveSamplingIntervalMs(), 100);
+
+        detector.setRawCaptureEnabled(true);
+        detector.setSamplingIntervalMs(20);
+        QCOMPARE(detector.effectiveSamplingIntervalMs(), 20);
+    }
+
+    // ========================================
+    // Video Stream Tests
+    // ========================================
+
+    void testCropNv12()
+    {
+        const QVideoFrame frame = yuvFrame(QVideoFrameFormat::Format_NV12);
+        QVERIFY(frame.isValid());
+        verifyYuvCrop(CrosshairStream::cropCenter(frame, 2));
+    }
+
+    void testCropYuv420p()
+    {
+        const QVideoFrame frame = yuvFrame(QVideoFrameFormat::Format_YUV420P);
+        QVERIFY(frame.isValid());
+        verifyYuvCrop(CrosshairStream::cropCenter(frame, 2));
+
+        // Larger than the frame: the whole frame
+        QCOMPARE(CrosshairStream::cropCenter(frame, 10).size(), QSize(8, 6));
+    }
+
+    void testCropRgb()
+    {
+        struct Case {
+            QVideoFrameFormat::PixelFormat format;
+            int r, g, b;                 // Byte offsets within a pixel
+        };
+        const Case cases[] = {
+            {QVideoFrameFormat::Format_BGRA8888, 2, 1, 0},
+            {QVideoFrameFormat::Format_RGBA8888, 0, 1, 2},
+            {QVideoFrameFormat::Format_XRGB8888, 1, 2, 3},
+        };
+
+        for (const Case& c : cases) {
+            QVideoFrame frame(QVideoFrameFormat(QSize(8, 6), c.format));
+            QVERIFY(frame.map(QVideoFrame::WriteOnly));
+            for (int y = 0; y < 6; ++y) {
+                uchar* row = frame.bits(0) + y * frame.bytesPerLine(0);
+                for (int x = 0; x < 8; ++x) {
+                    row[x * 4 + c.r] = uchar(x * 30);
+                    row[x * 4 + c.g] = uchar(y * 40);
+                    row[x * 4 + c.b] = uchar(200);
+                    row[x * 4 + (6 - c.r - c.g - c.b)] = 255;   // Alpha / padding
+                }
+            }
+            frame.unmap();
+
+            const QImage crop = CrosshairStream::cropCenter(frame, 2);
+            QCOMPARE(crop.size(), QSize(2, 2));
+            QCOMPARE(crop.pixel(0, 0), qRgb(90, 80, 200));     // (3, 2)
+            QCOMPARE(crop.pixel(1, 1), qRgb(120, 120, 200));   // (4, 3)
+        }
+    }
+
+    void testStreamFromFile()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        // 64x64 at the demuxer's default 25 fps: white, then red for 2 s
+        H264Writer writer(64, 64);
+        for (int i = 0; i < 10; ++i) writer.addFrame(WHITE);
+        for (int i = 0; i < 50; ++i) writer.addFrame(RED);
+        QFile file(dir.filePath("reticle.h264"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(writer.data());
+        file.close();
+
+        CrosshairDetector detector;
+        QSignalSpy states(&detector, &CrosshairDetector::aimAssistStateChanged);
+        QSignalSpy metrics(&detector, &CrosshairDetector::streamMetricsChanged);
+        QVERIFY(detector.startStreamFromFile(file.fileName()));
+
+        QTRY_VERIFY_WITH_TIMEOUT(detector.aimAssistActive(), 10000);
+        QCOMPARE(states.count(), 1);
+        QTRY_VERIFY_WITH_TIMEOUT(metrics.count() > 0, 5000);
+        QVERIFY(detector.streamFps() > 0.0);
+        QVERIFY(detector.classifyLatencyUs() > 0.0);
+        detector.stopDetection();
+    }
+
+    void testStreamFromSocket()
+    {
+        // Two bursts with a pause between them, then the producer closes
+        H264Writer writer(64, 64);
+        for (int i = 0; i < 20; ++i) writer.addFrame(WHITE);
+        const qsizetype firstBurst = writer.data().size();
+        for (int i = 0; i < 20; ++i) writer.addFrame(RED);
+        const QByteArray h264 = writer.data();
+
+        QTcpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+        QTcpSocket* producer = nullptr;
+        connect(&server, &QTcpServer::newConnection, this, [&]() {
+            producer = server.nextPendingConnection();
+            producer->write(h264.left(firstBurst));
+        });
+
+        auto* socket = new QTcpSocket;
+        socket->connectToHost(QHostAddress::LocalHost, server.serverPort());
+        QVERIFY(socket->waitForConnected(3000));
+
+        CrosshairStream stream;
+        QSignalSpy ended(&stream, &CrosshairStream::streamEnded);
+        QSignalSpy errors(&stream, &CrosshairStream::streamError);
+        QVERIFY(stream.startSocket(socket));
+
+        // Decoding starts on the first burst; the pause ends nothing
+        QTRY_VERIFY(producer != nullptr);
+        QTRY_VERIFY_WITH_TIMEOUT(stream.framesDecoded() > 0, 10000);
+        QTest::qWait(1000);
+        QCOMPARE(ended.count(), 0);
+        QCOMPARE(errors.count(), 0);
+        QVERIFY(stream.isRunning());
+
+        producer->write(h264.mid(firstBurst));
+        producer->disconnectFromHost();
+        QTRY_COMPARE_WITH_TIMEOUT(ended.count(), 1, 10000);
+        QCOMPARE(errors.count(), 0);
+        QCOMPARE(stream.framesDecoded(), quint64(40));   // Every frame, none dropped
+        stream.stop();
+    }
+
+    void testInvalidStream()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QFile file(dir.filePath("garbage.h264"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray(4096, 'x'));
+        file.close();
+
+        CrosshairStream stream;
+        QSignalSpy ended(&stream, &CrosshairStream::streamEnded);
+        QSignalSpy errors(&stream, &CrosshairStream::streamError);
+        QVERIFY(stream.startFile(file.fileName()));
+
+        QTRY_COMPARE_WITH_TIMEOUT(errors.count(), 1, 10000);
+        QTest::qWait(200);
+        QCOMPARE(errors.count(), 1);      // Error and InvalidMedia report once
+        QCOMPARE(ended.count(), 0);
+        QCOMPARE(stream.framesDecoded(), quint64(0));
+    }
+};
+
+QTEST_MAIN(TestCrosshair)
+#include "tst_crosshair.moc"
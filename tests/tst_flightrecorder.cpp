@@ -0,0 +1,210 @@
+#include <QtTest>
+#include <QDateTime>
+#include <QTemporaryDir>
+#include <QThread>
+#include <atomic>
+#include <set>
+
+#include "zereca/core/FlightRecorder.h"
+
+using Zereca::FlightRecorder;
+using Zereca::StateChangeRecord;
+
+/**
+ * @brief Unit tests for the Zereca flight recorder ring
+ *
+ * - Records come back in order, oldest ones overwritten past capacity
+ * - Concurrent writers lose nothing and never produce torn records
+ * - Snapshots taken while writers run only return complete records
+ * - Binary dumps decode back to the recorded data, even when truncated
+ * - A mapped ring left behind by a killed process is recovered on open
+ */
+class TestFlightRecorder : public QObject
+{
+    Q_OBJECT
+
+private:
+    static StateChangeRecord makeRecord(uint32_t component, uint64_t value)
+    {
+        StateChangeRecord rec;
+        rec.timestamp = QDateTime::currentMSecsSinceEpoch();
+        rec.component = component;
+        rec.oldVal = value;
+        rec.newVal = ~value;   // Lets a reader spot a torn copy
+        return rec;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);   // Dumps go to a test location
+    }
+
+    void testOrderAndWrap()
+    {
+        FlightRecorder recorder;
+        const uint64_t total = FlightRecorder::MAX_RECORDS + 100;
+        for (uint64_t i = 0; i < total; ++i) {
+            recorder.record(makeRecord(1, i));
+        }
+
+        QCOMPARE(recorder.recordCount(), int(FlightRecorder::MAX_RECORDS));
+
+        auto all = recorder.allRecords();
+        QCOMPARE(all.size(), FlightRecorder::MAX_RECORDS);
+        QCOMPARE(all.front().oldVal, uint64_t(100));
+        QCOMPARE(all.back().oldVal, total - 1);
+
+        auto recent = recorder.recentRecords(3);
+        QCOMPARE(recent.size(), size_t(3));
+        QCOMPARE(recent[0].oldVal, total - 3);
+
+        recorder.clear();
+        QCOMPARE(recorder.recordCount(), 0);
+        QVERIFY(recorder.allRecords().empty());
+        recorder.record(makeRecord(1, 7));
+        QCOMPARE(recorder.allRecords().size(), size_t(1));
+    }
+
+    void testOldRecordsExpire()
+    {
+        FlightRecorder recorder;
+        StateChangeRecord old = makeRecord(2, 1);
+        old.timestamp -= FlightRecorder::MAX_BUFFER_DURATION_MS + 1000;
+        recorder.record(old);
+        recorder.record(makeRecord(2, 2));
+
+        auto all = recorder.allRecords();
+        QCOMPARE(all.size(), size_t(1));
+        QCOMPARE(all[0].oldVal, uint64_t(2));
+    }
+
+    void testConcurrentWriters()
+    {
+        FlightRecorder recorder;
+        constexpr int WRITERS = 4;
+        constexpr uint64_t PER_WRITER = 3000;   // Fits without wrapping
+
+        std::atomic<bool> done{false};
+        std::atomic<int> torn{0};
+        QThread* reader = QThread::create([&]() {
+            while (!done.load()) {
+                for (const auto& rec : recorder.recentRecords(256)) {
+                    if (rec.newVal != ~rec.oldVal) torn++;
+                }
+            }
+        });
+        reader->start();
+
+        QList<QThread*> writers;
+        for (int w = 0; w < WRITERS; ++w) {
+            writers << QThread::create([&recorder, w]() {
+                for (uint64_t i = 0; i < PER_WRITER; ++i) {
+                    recorder.record(makeRecord(uint32_t(w), (uint64_t(w) << 32) | i));
+                }
+            });
+            writers.last()->start();
+        }
+        for (QThread* t : writers) {
+            t->wait();
+            delete t;
+        }
+        done = true;
+        reader->wait();
+        delete reader;
+
+        QCOMPARE(torn.load(), 0);
+
+        auto all = recorder.allRecords();
+        QCOMPARE(all.size(), size_t(WRITERS * PER_WRITER));
+        std::set<uint64_t> seen;
+        for (const auto& rec : all) {
+            seen.insert(rec.oldVal);
+        }
+        QCOMPARE(seen.size(), all.size());
+    }
+
+    void testBinaryDump()
+    {
+        FlightRecorder recorder;
+        for (uint64_t i = 0; i < 3; ++i) {
+            recorder.record(makeRecord(Zereca::Component::CPU_PARKING, i));
+        }
+
+        const QString path = recorder.dumpToDisk("thermal_runaway");
+        QVERIFY(path.endsWith(".zfr"));
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        const QByteArray data = file.readAll();
+        file.close();
+        QFile::remove(path);
+
+        FlightRecorder::DumpContents dump;
+        QString error;
+        QVERIFY2(FlightRecorder::decodeDump(data, &dump, &error), qPrintable(error));
+        QVERIFY(error.isEmpty());
+        QCOMPARE(dump.reason, QString("thermal_runaway"));
+        QCOMPARE(dump.records.size(), size_t(3));
+        QCOMPARE(dump.records[2].oldVal, uint64_t(2));
+        QCOMPARE(dump.records[2].component, Zereca::Component::CPU_PARKING);
+
+        const QJsonObject json = FlightRecorder::dumpToJson(dump.reason, dump.dumpTimestamp, dump.records);
+        QCOMPARE(json["record_count"].toInt(), 3);
+
+        // Cut mid-record: the complete ones survive
+        QVERIFY(FlightRecorder::decodeDump(data.left(data.size() - 10), &dump, &error));
+        QCOMPARE(dump.records.size(), size_t(2));
+        QVERIFY(!error.isEmpty());
+
+        QVERIFY(!FlightRecorder::decodeDump(QByteArray(64, 'x'), &dump));
+    }
+
+    void testPersistentRecovery()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString ringPath = dir.filePath("flight.ring");
+        const QString crashedPath = dir.filePath("crashed.ring");
+
+        {
+            FlightRecorder recorder;
+            recorder.record(makeRecord(1, 0));   // Heap record moves into the file
+            QVERIFY(recorder.openPersistent(ringPath));
+            QVERIFY(recorder.isPersistent());
+            QVERIFY(!recorder.recoveredAfterCrash());
+            QCOMPARE(recorder.recoveredCount(), 0);
+            for (uint64_t i = 1; i < 5; ++i) {
+                recorder.record(makeRecord(1, i));
+            }
+
+            // The file is owned while mapped
+            FlightRecorder other;
+            QVERIFY(!other.openPersistent(ringPath));
+            QVERIFY(!other.isPersistent());
+
+            // Copying the live file is what a kill leaves on disk
+            QVERIFY(QFile::copy(ringPath, crashedPath));
+        }
+
+        {
+            FlightRecorder recorder;
+            QVERIFY(recorder.openPersistent(crashedPath));
+            QVERIFY(recorder.recoveredAfterCrash());
+            QCOMPARE(recorder.recoveredCount(), 5);
+            auto all = recorder.allRecords();
+            QCOMPARE(all.size(), size_t(5));
+            QCOMPARE(all.front().oldVal, uint64_t(0));
+            QCOMPARE(all.back().newVal, ~uint64_t(4));
+            recorder.record(makeRecord(1, 5));
+        }
+
+        // Clean shutdown: records kept, no crash reported
+        FlightRecorder recorder;
+        QVERIFY(recorder.openPersistent(crashedPath));
+        QVERIFY(!recorder.recoveredAfterCrash());
+        QCOMPARE(recorder.recordCount(), 6);
+    }
+};
+
+QTEST_MAIN(TestFlightRecorder)
+#include "tst_flightrecorder.moc"
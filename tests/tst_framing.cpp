@@ -0,0 +1,114 @@
+#include <QtTest>
+#include <QBuffer>
+#include <QJsonArray>
+
+#include "core/ipc/MessageFraming.h"
+
+using NeoZ::MessageFraming;
+
+/**
+ * @brief Unit tests for the IPC / AdbService wire framing
+ *
+ * - JSON lines and CBOR frames decode to the same object
+ * - Both framings can be interleaved on one stream
+ * - Partial frames wait for more bytes; bad frames are skipped or fatal
+ */
+class TestMessageFraming : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QJsonObject telemetry()
+    {
+        QJsonObject msg;
+        msg["type"] = "Telemetry";
+        msg["id"] = "42";
+        msg["dx"] = 3;
+        msg["dy"] = -7;
+        msg["sensitivity"] = 1.25;
+        msg["aimAssist"] = true;
+        msg["history"] = QJsonArray{1, 2, 3};
+        return msg;
+    }
+
+private slots:
+    void testRoundTripBothFramings()
+    {
+        QByteArray stream = MessageFraming::encode(telemetry(), MessageFraming::Mode::Json)
+                          + MessageFraming::encode(telemetry(), MessageFraming::Mode::Cbor)
+                          + "\n"   // Stray blank line
+                          + MessageFraming::encode(telemetry(), MessageFraming::Mode::Json);
+
+        QBuffer buffer(&stream);
+        buffer.open(QIODevice::ReadOnly);
+
+        int messages = 0;
+        for (;;) {
+            QJsonObject msg;
+            auto result = MessageFraming::read(&buffer, &msg);
+            if (result == MessageFraming::ReadResult::Incomplete) break;
+            if (result == MessageFraming::ReadResult::Malformed) continue;
+            QCOMPARE(result, MessageFraming::ReadResult::Message);
+            QCOMPARE(msg, telemetry());
+            QCOMPARE(msg["dy"].toInt(), -7);
+            ++messages;
+        }
+        QCOMPARE(messages, 3);
+
+        // Binary framing is the smaller one
+        QVERIFY(MessageFraming::encode(telemetry(), MessageFraming::Mode::Cbor).size()
+                < MessageFraming::encode(telemetry(), MessageFraming::Mode::Json).size());
+    }
+
+    void testPartialFrame()
+    {
+        const QByteArray frame = MessageFraming::encode(telemetry(), MessageFraming::Mode::Cbor);
+
+        QJsonObject msg;
+        for (int split : {1, 3, MessageFraming::HEADER_SIZE, static_cast<int>(frame.size()) - 1}) {
+            QByteArray partial = frame.left(split);
+            QBuffer buffer(&partial);
+            buffer.open(QIODevice::ReadOnly);
+            QCOMPARE(MessageFraming::read(&buffer, &msg), MessageFraming::ReadResult::Incomplete);
+            QCOMPARE(buffer.pos(), qint64(0));   // Nothing consumed
+        }
+
+        QByteArray complete = frame;
+        QBuffer buffer(&complete);
+        buffer.open(QIODevice::ReadOnly);
+        QCOMPARE(MessageFraming::read(&buffer, &msg), MessageFraming::ReadResult::Message);
+        QCOMPARE(msg["type"].toString(), QString("Telemetry"));
+    }
+
+    void testBadFrames()
+    {
+        QByteArray stream = "{not json\n" + MessageFraming::encode(telemetry(), MessageFraming::Mode::Json);
+        QBuffer buffer(&stream);
+        buffer.open(QIODevice::ReadOnly);
+
+        QJsonObject msg;
+        QString error;
+        QCOMPARE(MessageFraming::read(&buffer, &msg, &error), MessageFraming::ReadResult::Malformed);
+        QVERIFY(!error.isEmpty());
+        QCOMPARE(MessageFraming::read(&buffer, &msg), MessageFraming::ReadResult::Message);
+
+        // An absurd length can't be skipped safely
+        QByteArray huge(1, MessageFraming::BINARY_MARKER);
+        huge.append("\x7f\xff\xff\xff", 4);
+        QBuffer hugeBuffer(&huge);
+        hugeBuffer.open(QIODevice::ReadOnly);
+        QCOMPARE(MessageFraming::read(&hugeBuffer, &msg), MessageFraming::ReadResult::Corrupt);
+    }
+
+    void testModeNames()
+    {
+        MessageFraming::Mode mode;
+        QVERIFY(MessageFraming::modeFromName("cbor", &mode));
+        QCOMPARE(mode, MessageFraming::Mode::Cbor);
+        QVERIFY(!MessageFraming::modeFromName("msgpack", &mode));
+        QCOMPARE(MessageFraming::supportedModes(), QStringList({"json", "cbor"}));
+    }
+};
+
+QTEST_MAIN(TestMessageFraming)
+#include "tst_framing.moc"
@@ -0,0 +1,211 @@
+#include <QtTest>
+#include <QThread>
+#include <atomic>
+#include <vector>
+
+#include "core/perf/SpscRing.hpp"
+#include "core/input/InputWorker.h"
+#include "core/sensitivity/SensitivityPipeline.h"
+
+using NeoZ::InputWorker;
+using NeoZ::SensitivityPipeline;
+using NeoZ::SpscRing;
+
+/**
+ * @brief Unit tests for the hook → worker hand-off
+ *
+ * - SpscRing: full/empty edges, index wraparound, two-thread ordering
+ * - InputWorker: start/stop lifecycle, drops when the ring is full,
+ *   correction injection, pipeline signals delivered on the owner thread
+ */
+class TestInputWorker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    // ========================================
+    // SpscRing Tests
+    // ========================================
+
+    void testRingFullEmpty()
+    {
+        SpscRing<int, 8> ring;
+        int value = -1;
+        QVERIFY(ring.empty());
+        QVERIFY(!ring.tryPop(value));
+        QCOMPARE(ring.popBulk(&value, 4), size_t(0));
+
+        for (int i = 0; i < 8; ++i) {
+            QVERIFY(ring.tryPush(i));
+        }
+        QVERIFY(!ring.tryPush(99));   // Full: rejected, nothing overwritten
+        QCOMPARE(ring.size(), size_t(8));
+
+        for (int i = 0; i < 8; ++i) {
+            QVERIFY(ring.tryPop(value));
+            QCOMPARE(value, i);
+        }
+        QVERIFY(ring.empty());
+        QVERIFY(!ring.tryPop(value));
+        QVERIFY(ring.tryPush(8));     // Space again after draining
+    }
+
+    void testRingWraparound()
+    {
+        SpscRing<int, 8> ring;
+        int next = 0;
+        int expected = 0;
+        int out[8];
+
+        // Uneven push/pop counts walk the indices across many wraps
+        for (int round = 0; round < 1000; ++round) {
+            const int pushes = 1 + round % 7;
+            for (int i = 0; i < pushes; ++i) {
+                QVERIFY(ring.tryPush(next++));
+            }
+            const size_t popped = ring.popBulk(out, 1 + round % 5);
+            for (size_t i = 0; i < popped; ++i) {
+                QCOMPARE(out[i], expected++);
+            }
+            while (ring.tryPop(out[0])) {
+                QCOMPARE(out[0], expected++);
+            }
+        }
+        QCOMPARE(expected, next);
+        QVERIFY(ring.empty());
+    }
+
+    void testRingTwoThreads()
+    {
+        constexpr int COUNT = 200000;
+        SpscRing<int, 64> ring;
+
+        QThread* producer = QThread::create([&ring]() {
+            for (int i = 0; i < COUNT; ++i) {
+                while (!ring.tryPush(i)) QThread::yieldCurrentThread();
+            }
+        });
+        producer->start();
+
+        int expected = 0;
+        bool ordered = true;
+        int out[16];
+        while (expected < COUNT) {
+            const size_t n = ring.popBulk(out, 16);
+            for (size_t i = 0; i < n; ++i) {
+                ordered &= (out[i] == expected++);
+            }
+        }
+        producer->wait();
+        delete producer;
+
+        QVERIFY(ordered);
+        QVERIFY(ring.empty());
+    }
+
+    // ========================================
+    // InputWorker Tests
+    // ========================================
+
+    void testStartStop()
+    {
+        SensitivityPipeline pipeline;
+        InputWorker worker(&pipeline, nullptr);
+        QVERIFY(!worker.isRunning());
+        worker.stop();                 // Not running: no-op
+
+        QVERIFY(worker.start());
+        QVERIFY(worker.isRunning());
+        QVERIFY(!worker.start());      // Already running
+        worker.stop();
+        worker.stop();
+        QVERIFY(!worker.isRunning());
+
+        // Restartable, and nothing submitted in between is lost
+        QVERIFY(worker.submit(1, 1));
+        QVERIFY(worker.start());
+        QTRY_COMPARE(worker.stats().processed, uint64_t(1));
+        worker.stop();
+
+        InputWorker orphan(nullptr, nullptr);
+        QVERIFY(!orphan.start());      // No pipeline
+    }
+
+    void testDropWhenFull()
+    {
+        SensitivityPipeline pipeline;
+        InputWorker worker(&pipeline, nullptr);
+
+        // Not started: the ring fills up and the next event is dropped
+        for (size_t i = 0; i < InputWorker::RING_CAPACITY; ++i) {
+            QVERIFY(worker.submit(1, 0));
+        }
+        QVERIFY(!worker.submit(1, 0));
+        QCOMPARE(worker.stats().dropped, uint64_t(1));
+        QCOMPARE(worker.stats().queueDepth, InputWorker::RING_CAPACITY);
+
+        QVERIFY(worker.start());
+        QTRY_COMPARE(worker.stats().processed, uint64_t(InputWorker::RING_CAPACITY));
+        QCOMPARE(worker.stats().queueDepth, size_t(0));
+        worker.stop();
+    }
+
+    void testInjectsCorrection()
+    {
+        SensitivityPipeline pipeline;
+        std::atomic<int> injected{0};
+        std::atomic<int> calls{0};
+        InputWorker worker(&pipeline, [&](int dx, int) {
+            injected += dx;
+            calls++;
+        });
+
+        // Input Authority OFF: passthrough, nothing to inject
+        QVERIFY(worker.start());
+        for (int i = 0; i < 100; ++i) worker.submit(10, 0);
+        QTRY_COMPARE(worker.stats().processed, uint64_t(100));
+        QCOMPARE(calls.load(), 0);
+
+        // ON with doubled sensitivity: the worker injects the difference
+        pipeline.setInputAuthorityEnabled(true);
+        pipeline.setSensitivityX(2.0);
+        for (int i = 0; i < 100; ++i) worker.submit(10, 0);
+        QTRY_COMPARE(worker.stats().processed, uint64_t(200));
+        worker.stop();
+        QVERIFY(calls.load() > 0);
+        QVERIFY(injected.load() != 0);
+    }
+
+    void testSignalsOnOwnerThread()
+    {
+        SensitivityPipeline pipeline;
+        pipeline.setInputAuthorityEnabled(true);
+
+        std::atomic<int> offThread{0};
+        int delivered = 0;
+        connect(&pipeline, &SensitivityPipeline::batchProcessed, this, [&](int count) {
+            if (QThread::currentThread() != thread()) offThread++;
+            delivered += count;
+        }, Qt::DirectConnection);
+        connect(&pipeline, &SensitivityPipeline::latencyChanged, this, [&]() {
+            if (QThread::currentThread() != thread()) offThread++;
+        }, Qt::DirectConnection);
+
+        InputWorker worker(&pipeline, nullptr);
+        QVERIFY(worker.start());
+        constexpr int COUNT = 5000;
+        for (int i = 0; i < COUNT; ++i) {
+            while (!worker.submit(i % 7 - 3, 2)) QThread::yieldCurrentThread();
+        }
+
+        // Every event is accounted for, even when notifications coalesce
+        QTRY_COMPARE(worker.stats().processed, uint64_t(COUNT));
+        worker.stop();
+        QTRY_COMPARE(delivered, COUNT);
+        QCOMPARE(offThread.load(), 0);
+        QVERIFY(pipeline.latencyMs() > 0.0);
+    }
+};
+
+QTEST_MAIN(TestInputWorker)
+#include "tst_inputworker.moc"
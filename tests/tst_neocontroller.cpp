@@ -359,6 +359,45 @@ private slots:
         QVERIFY(!running || running);
     }
 
+    void testJobStreamExitMarkerSplit()
+    {
+        // Native exec stream: script output, then printf '\n__NEOZ_EXIT_%d\n'
+        const QByteArray stream = "line one\nline two\n\n__NEOZ_EXIT_12\n";
+
+        // Every split point, then one byte per read
+        QList<QList<QByteArray>> reads;
+        for (int i = 0; i <= stream.size(); ++i) {
+            reads << QList<QByteArray>{stream.left(i), stream.mid(i)};
+        }
+        QList<QByteArray> bytes;
+        for (char c : stream) bytes << QByteArray(1, c);
+        reads << bytes;
+
+        for (const QList<QByteArray>& chunks : reads) {
+            QByteArray buffer;
+            QByteArray output;
+            int exitCode = -1;
+            for (const QByteArray& chunk : chunks) {
+                buffer += chunk;
+                output += NeoController::takeJobStreamOutput(buffer, &exitCode);
+                QVERIFY(!output.contains("__NEOZ"));
+            }
+            QCOMPARE(output, QByteArray("line one\nline two\n"));
+            QCOMPARE(exitCode, 12);
+            QVERIFY(buffer.isEmpty());
+        }
+
+        // Exit code split across reads: nothing is decided until the line ends
+        QByteArray buffer = "done\n\n__NEOZ_EXIT_1";
+        int exitCode = -1;
+        QCOMPARE(NeoController::takeJobStreamOutput(buffer, &exitCode), QByteArray());
+        QCOMPARE(exitCode, -1);
+        buffer += "2\n";
+        QCOMPARE(NeoController::takeJobStreamOutput(buffer, &exitCode), QByteArray("done\n"));
+        QCOMPARE(exitCode, 12);
+        QVERIFY(buffer.isEmpty());
+    }
+
     // ========================================
     // Emulator Identification Tests
     // ========================================
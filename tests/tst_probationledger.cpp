@@ -0,0 +1,228 @@
+#include <QtTest>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+#include <atomic>
+
+#include "zereca/arbiter/ProbationLedger.h"
+
+using Zereca::ProbationLedger;
+using Zereca::Severity;
+using Zereca::SystemContext;
+
+/**
+ * @brief Unit tests for the probation ledger persistence
+ *
+ * - Mutations land in the log and are replayed on the next load
+ * - A torn log tail is dropped without losing the records before it
+ * - The log is compacted into the snapshot once it grows
+ * - clearAll() survives a crash on either side of its snapshot write
+ * - Batch lookups match single lookups; readers run alongside writers
+ */
+class TestProbationLedger : public QObject
+{
+    Q_OBJECT
+
+private:
+    // What a killed process leaves behind: the files as they are right now
+    static void copyStorage(const QString& from, const QString& to)
+    {
+        for (const QString& name : {"zereca_probation.json", "zereca_probation.wal"}) {
+            QFile::remove(to + "/" + name);
+            if (QFile::exists(from + "/" + name)) {
+                QVERIFY(QFile::copy(from + "/" + name, to + "/" + name));
+            }
+        }
+    }
+
+    static SystemContext context()
+    {
+        SystemContext ctx;
+        ctx.gpuDriverVersion = 31;
+        ctx.osBuild = 22631;
+        return ctx;
+    }
+
+private slots:
+    void testLogReplay()
+    {
+        QTemporaryDir live, crashed;
+        QVERIFY(live.isValid() && crashed.isValid());
+
+        ProbationLedger ledger(live.path());
+        ledger.addToProbation(1, Severity::CRITICAL, context());
+        ledger.addToProbation(2, Severity::MEDIUM, context());
+        ledger.addToProbation(2, Severity::MEDIUM, context());
+        ledger.addToProbation(3, Severity::LOW, context());
+        ledger.clearEntry(3);
+        QCOMPARE(ledger.walRecordCount(), 5);
+        QVERIFY(!QFile::exists(live.filePath("zereca_probation.json")));   // Only the log was written
+
+        copyStorage(live.path(), crashed.path());
+        ProbationLedger recovered(crashed.path());
+        QCOMPARE(recovered.entryCount(), 2);
+        QVERIFY(!recovered.getEntry(3));
+        QCOMPARE(recovered.getEntry(2)->backoff, 2.0f);
+        QVERIFY(recovered.isOnProbation(1, context()));
+        QCOMPARE(recovered.walRecordCount(), 5);
+
+        // Appends continue after the replayed records
+        recovered.clearEntry(1);
+        QVERIFY(recovered.save());
+        QCOMPARE(recovered.walRecordCount(), 0);
+
+        ProbationLedger reloaded(crashed.path());
+        QCOMPARE(reloaded.entryCount(), 1);
+        QVERIFY(reloaded.getEntry(2));
+    }
+
+    void testTornTail()
+    {
+        QTemporaryDir live, crashed;
+        QVERIFY(live.isValid() && crashed.isValid());
+
+        ProbationLedger ledger(live.path());
+        ledger.addToProbation(7, Severity::MEDIUM, context());
+        ledger.addToProbation(8, Severity::MEDIUM, context());
+        copyStorage(live.path(), crashed.path());
+
+        QFile wal(crashed.filePath("zereca_probation.wal"));
+        QVERIFY(wal.open(QIODevice::ReadWrite));
+        const QByteArray data = wal.readAll();
+        wal.resize(data.size() - 10);   // Second record cut mid-write
+        wal.close();
+
+        ProbationLedger recovered(crashed.path());
+        QCOMPARE(recovered.entryCount(), 1);
+        QVERIFY(recovered.getEntry(7));
+        QCOMPARE(recovered.walRecordCount(), 0);   // Compacted on load
+
+        recovered.addToProbation(9, Severity::LOW, context());
+        QCOMPARE(recovered.walRecordCount(), 1);
+    }
+
+    void testCompaction()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        ProbationLedger ledger(dir.path());
+        for (int i = 0; i < ProbationLedger::COMPACT_MIN_RECORDS + 10; ++i) {
+            ledger.addToProbation(uint64_t(i % 512), Severity::MEDIUM, context());
+        }
+        QCOMPARE(ledger.walRecordCount(), 10);
+        QVERIFY(QFile::exists(dir.filePath("zereca_probation.json")));
+        QVERIFY(QFileInfo(dir.filePath("zereca_probation.wal")).size() < 4096);
+
+        QTemporaryDir copy;
+        copyStorage(dir.path(), copy.path());
+        ProbationLedger recovered(copy.path());
+        QCOMPARE(recovered.entryCount(), 512);
+        QCOMPARE(recovered.getEntry(0)->backoff, ledger.getEntry(0)->backoff);
+    }
+
+    void testClearAllCrashWindow()
+    {
+        QTemporaryDir live, oldSnapshot, emptySnapshot;
+        QVERIFY(live.isValid() && oldSnapshot.isValid() && emptySnapshot.isValid());
+
+        ProbationLedger ledger(live.path());
+        ledger.addToProbation(1, Severity::CRITICAL, context());
+        ledger.addToProbation(2, Severity::MEDIUM, context());
+        QVERIFY(ledger.save());
+        ledger.addToProbation(3, Severity::CRITICAL, context());
+        copyStorage(live.path(), oldSnapshot.path());
+
+        // A directory in the snapshot's place stops clearAll() before it
+        // truncates the log: the files look like a crash during compaction
+        QVERIFY(QFile::remove(live.filePath("zereca_probation.json")));
+        QVERIFY(QDir(live.path()).mkdir("zereca_probation.json"));
+        ledger.clearAll();
+        QCOMPARE(ledger.entryCount(), 0);
+
+        // Killed before the new snapshot landed: old snapshot + log
+        QFile::remove(oldSnapshot.filePath("zereca_probation.wal"));
+        QVERIFY(QFile::copy(live.filePath("zereca_probation.wal"), oldSnapshot.filePath("zereca_probation.wal")));
+        ProbationLedger beforeSnapshot(oldSnapshot.path());
+        QCOMPARE(beforeSnapshot.entryCount(), 0);
+        QVERIFY(!beforeSnapshot.isOnProbation(1, context()));
+
+        // Killed after it, before the log was truncated: empty snapshot + log
+        QFile snapshot(emptySnapshot.filePath("zereca_probation.json"));
+        QVERIFY(snapshot.open(QIODevice::WriteOnly));
+        snapshot.write("[]");
+        snapshot.close();
+        QVERIFY(QFile::copy(live.filePath("zereca_probation.wal"), emptySnapshot.filePath("zereca_probation.wal")));
+        ProbationLedger afterSnapshot(emptySnapshot.path());
+        QCOMPARE(afterSnapshot.entryCount(), 0);
+        QVERIFY(!afterSnapshot.isOnProbation(3, context()));
+    }
+
+    void testBatchLookup()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        ProbationLedger ledger(dir.path());
+        for (uint64_t hash = 0; hash < 100; hash += 3) {
+            ledger.addToProbation(hash, Severity::CRITICAL, context());
+        }
+        ledger.addToProbation(1000, Severity::LOW, context());   // Backoff not over yet
+        ledger.clearEntry(9);
+
+        std::vector<uint64_t> hashes;
+        for (uint64_t hash = 0; hash < 120; ++hash) {
+            hashes.push_back(hash);
+        }
+        hashes.push_back(1000);
+
+        const std::vector<bool> blocked = ledger.isOnProbation(hashes, context());
+        QCOMPARE(blocked.size(), hashes.size());
+        for (size_t i = 0; i < hashes.size(); ++i) {
+            QCOMPARE(blocked[i], ledger.isOnProbation(hashes[i], context()));
+        }
+        QVERIFY(blocked[0]);
+        QVERIFY(!blocked[1]);
+        QVERIFY(!blocked[9]);
+        QVERIFY(blocked.back());
+    }
+
+    void testReadersDuringWrites()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+
+        ProbationLedger ledger(dir.path());
+        ledger.addToProbation(42, Severity::CRITICAL, context());
+
+        std::atomic<bool> done{false};
+        std::atomic<int> misses{0};
+        QList<QThread*> readers;
+        for (int r = 0; r < 4; ++r) {
+            readers << QThread::create([&]() {
+                while (!done.load()) {
+                    if (!ledger.isOnProbation(42, context())) misses++;   // Never cleared
+                    ledger.isOnProbation({1, 2, 3, 42}, context());
+                }
+            });
+            readers.last()->start();
+        }
+
+        for (uint64_t hash = 100; hash < 400; ++hash) {
+            ledger.addToProbation(hash, Severity::MEDIUM, context());
+            if (hash % 2) ledger.clearEntry(hash - 1);
+        }
+        done = true;
+        for (QThread* t : readers) {
+            t->wait();
+            delete t;
+        }
+
+        QCOMPARE(misses.load(), 0);
+        QCOMPARE(ledger.entryCount(), 151);
+    }
+};
+
+QTEST_MAIN(TestProbationLedger)
+#include "tst_probationledger.moc"
@@ -0,0 +1,112 @@
+#include <QtTest>
+#include <QColor>
+#include <QImage>
+
+#include "core/aim/ReticleClassifier.h"
+
+#include <vector>
+
+using NeoZ::ReticleClassifier;
+
+/**
+ * @brief Unit tests for the crosshair ROI classifier
+ *
+ * - Integer red test agrees with the QColor HSV rule it replaced
+ * - SSE2 and scalar counts match for every span length / channel order
+ * - Ring and cross masks select the right pixels
+ */
+class TestReticleClassifier : public QObject
+{
+    Q_OBJECT
+
+private:
+    // The per-pixel rule CrosshairDetector used before the classifier
+    static bool hsvIsRed(const QColor& color)
+    {
+        int h = color.hue();
+        bool isRedHue = (h >= 0 && h <= 30) || (h >= 330 && h <= 360) || h == -1;
+        return isRedHue && color.saturation() > 100 && color.value() > 80
+            && color.red() > 150 && color.red() > color.green() + 50;
+    }
+
+private slots:
+    void testIntegerRuleMatchesHsv()
+    {
+        // Allow disagreement only in a thin band around the thresholds
+        int mismatches = 0;
+        int total = 0;
+        for (int r = 0; r < 256; r += 3) {
+            for (int g = 0; g < 256; g += 5) {
+                for (int b = 0; b < 256; b += 5) {
+                    ++total;
+                    if (hsvIsRed(QColor(r, g, b)) != ReticleClassifier::isRed(r, g, b)) ++mismatches;
+                }
+            }
+        }
+        QVERIFY2(mismatches * 100 < total, qPrintable(QString("%1 / %2").arg(mismatches).arg(total)));
+
+        QVERIFY(ReticleClassifier::isRed(230, 30, 30));
+        QVERIFY(!ReticleClassifier::isRed(240, 240, 240));   // White reticle
+        QVERIFY(!ReticleClassifier::isRed(230, 30, 200));    // Magenta
+        QVERIFY(!ReticleClassifier::isRed(230, 160, 30));    // Orange
+    }
+
+    void testSimdMatchesScalar()
+    {
+        std::vector<uchar> pixels(4 * 301);
+        quint32 seed = 7;
+        for (size_t i = 0; i < pixels.size(); ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            pixels[i] = static_cast<uchar>(seed >> 24);
+        }
+        // Every third pixel is a clear red, alternating between BGRA and RGBA
+        // byte order (a pixel can't be red in both: that would be magenta)
+        for (size_t px = 0; px < 301; px += 3) {
+            const bool bgra = px % 6 == 0;
+            pixels[px * 4 + 0] = bgra ? 20 : 220;
+            pixels[px * 4 + 1] = 20;
+            pixels[px * 4 + 2] = bgra ? 220 : 20;
+        }
+
+        for (auto order : {ReticleClassifier::ChannelOrder::Bgra, ReticleClassifier::ChannelOrder::Rgba}) {
+            QVERIFY(ReticleClassifier::countRedScalar(pixels.data(), 301, order) >= 50);
+            for (int n : {0, 1, 7, 8, 9, 15, 16, 17, 100, 301}) {
+                QCOMPARE(ReticleClassifier::countRed(pixels.data(), n, order),
+                         ReticleClassifier::countRedScalar(pixels.data(), n, order));
+            }
+        }
+    }
+
+    void testMasks()
+    {
+        ReticleClassifier classifier;
+        QCOMPARE(classifier.maskPixels(), 25);   // Default 5x5
+
+        classifier.setShape(ReticleClassifier::Style::Cross, 4, 3);
+        QCOMPARE(classifier.maskPixels(), 3 * 9 + 6 * 3);
+
+        // Red ring around a white center: a ring mask sees it, a small square does not
+        QImage image(41, 41, QImage::Format_RGB32);
+        image.fill(qRgb(240, 240, 240));
+        for (int y = 0; y < 41; ++y) {
+            for (int x = 0; x < 41; ++x) {
+                int d2 = (x - 20) * (x - 20) + (y - 20) * (y - 20);
+                if (d2 >= 7 * 7 && d2 <= 10 * 10) image.setPixel(x, y, qRgb(230, 25, 25));
+            }
+        }
+
+        classifier.setShape(ReticleClassifier::Style::Ring, 10, 3);
+        QVERIFY(classifier.isActive(image));
+
+        classifier.setShape(ReticleClassifier::Style::Square, 2);
+        QVERIFY(!classifier.isActive(image));
+
+        // Non-32-bit input goes through the ROI conversion path
+        QVERIFY(!classifier.isActive(image.convertToFormat(QImage::Format_RGB888)));
+        classifier.setShape(ReticleClassifier::Style::Ring, 10, 3);
+        QVERIFY(classifier.isActive(image.convertToFormat(QImage::Format_RGB888)));
+    }
+};
+
+QTEST_MAIN(TestReticleClassifier)
+#include "tst_reticle.moc"
@@ -1,8 +1,18 @@
 #include <QtTest>
 
 // Include sensitivity pipeline headers
+#include "core/sensitivity/SensitivityPipeline.h"
 #include "core/sensitivity/VelocityCurve.h"
 #include "core/sensitivity/SensitivityCalculator.h"
+#include "core/sensitivity/PipelineKernels.h"
+#include "core/sensitivity/PipelineClock.h"
+#include "core/input/InputRecording.h"
+#include "core/input/InputReplay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
 
 /**
  * @brief Unit tests for the Sensitivity Pipeline
@@ -224,6 +234,303 @@ private slots:
         
         QVERIFY(newSens < oldSens); // Higher res = lower sens to maintain feel
     }
+
+    // ========================================
+    // SIMD Kernel Tests
+    // ========================================
+    
+    void testKernelsBitIdenticalAcrossIsa()
+    {
+        using NeoZ::PipelineKernels;
+        
+        // Deterministic pseudo-random deltas and whole-ms Δt
+        const size_t n = 257;  // Odd length exercises the scalar tails
+        std::vector<double> rawX(n), rawY(n), dtMs(n);
+        for (size_t i = 0; i < n; ++i) {
+            rawX[i] = std::sin(i * 0.37) * 40.0;
+            rawY[i] = std::cos(i * 0.11) * 25.0;
+            dtMs[i] = static_cast<double>(i % 5);
+        }
+        
+        NeoZ::VelocityCurve curve;
+        curve.applyPreset(NeoZ::VelocityCurve::OneTap);
+        curve.setLowThreshold(0.01);
+        curve.setHighThreshold(0.05);
+        
+        auto run = [&](PipelineKernels::Isa isa) {
+            PipelineKernels::setIsaOverride(isa);
+            std::vector<double> x = rawX, y = rawY, v(n), lambda(n);
+            PipelineKernels::scaleAxes(x.data(), y.data(), n, 800.0, 1.0, 1.25, 1.3, 0.7);
+            PipelineKernels::applyCurve(x.data(), y.data(), v.data(), n, *curve.snapshot());
+            PipelineKernels::applySlowZone(x.data(), y.data(), v.data(), dtMs.data(), n, 100.0);
+            PipelineKernels::smoothingLambdas(dtMs.data(), lambda.data(), n, 42.0);
+            x.insert(x.end(), y.begin(), y.end());
+            x.insert(x.end(), v.begin(), v.end());
+            x.insert(x.end(), lambda.begin(), lambda.end());
+            return x;
+        };
+        
+        auto scalar = run(PipelineKernels::Isa::Scalar);
+        auto sse = run(PipelineKernels::Isa::SSE41);
+        auto avx = run(PipelineKernels::Isa::AVX2);
+        PipelineKernels::setIsaOverride(PipelineKernels::detected());
+        
+        QVERIFY(std::memcmp(scalar.data(), sse.data(), scalar.size() * sizeof(double)) == 0);
+        QVERIFY(std::memcmp(scalar.data(), avx.data(), scalar.size() * sizeof(double)) == 0);
+    }
+    
+    void testCurveLutMatchesAnalytic()
+    {
+        NeoZ::VelocityCurve curve;
+        curve.applyPreset(NeoZ::VelocityCurve::RedZone);
+        
+        // LUT mode: linear interpolation of the smoothstep stays very close
+        curve.setLutEnabled(true);
+        auto table = curve.snapshot();
+        QVERIFY(table->useLut);
+        for (double v = 0.0; v <= 8.0; v += 0.01) {
+            QVERIFY(std::abs(table->lookup(v) - table->shape.evaluate(v)) < 1e-5);
+        }
+        
+        // Clamped beyond the last sample
+        QCOMPARE(curve.apply(1000.0), curve.highMultiplier());
+    }
+    
+    void testCurveControlPoints()
+    {
+        NeoZ::VelocityCurve curve;
+        curve.setControlPoints({QPointF(3.0, 1.5), QPointF(0.0, 0.5), QPointF(1.0, 1.0)});
+        
+        QCOMPARE(curve.preset(), NeoZ::VelocityCurve::Custom);
+        QCOMPARE(curve.controlPoints().size(), 3);
+        QVERIFY(std::abs(curve.apply(0.0) - 0.5) < 1e-9);
+        QVERIFY(std::abs(curve.apply(0.5) - 0.75) < 1e-4);  // Smoothstep midpoint
+        QVERIFY(std::abs(curve.apply(1.0) - 1.0) < 1e-9);
+        QVERIFY(std::abs(curve.apply(10.0) - 1.5) < 1e-9);
+        
+        // Presets return to the low/mid/high model
+        curve.applyPreset(NeoZ::VelocityCurve::Linear);
+        QVERIFY(curve.controlPoints().isEmpty());
+        QCOMPARE(curve.apply(2.0), 1.0);
+    }
+    
+    void testKernelExpAccuracy()
+    {
+        // Vectorized exp must stay within a couple of ulp of std::exp
+        for (double x = -700.0; x <= 0.0; x += 0.173) {
+            double expected = std::exp(x);
+            double actual = NeoZ::PipelineKernels::expNonPositive(x);
+            QVERIFY(std::abs(actual - expected) <= expected * 4e-16);
+        }
+        QCOMPARE(NeoZ::PipelineKernels::expNonPositive(0.0), 1.0);
+        QCOMPARE(NeoZ::PipelineKernels::expNonPositive(-1000.0), 0.0);
+    }
+    
+    void testClockSubMillisecondDeltas()
+    {
+        // 8 kHz polling: Δt must be 0.125 ms, not 0 (or the 1 ms fallback)
+        NeoZ::PipelineClock clock;
+        NeoZ::InputState event;
+        event.timestamp = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(5'000'000));
+        QCOMPARE(clock.advance(event), 0.0);  // First event
+        event.timestamp += std::chrono::nanoseconds(125'000);
+        QCOMPARE(clock.advance(event), 0.125);
+        
+        // Unstamped events use the pluggable time source
+        int64_t fakeNow = 6'000'000;
+        clock.setTimeSource([&fakeNow]() { return fakeNow; });
+        NeoZ::InputState unstamped;
+        QCOMPARE(clock.advance(unstamped), 0.875);
+        fakeNow += 250'000;
+        QCOMPARE(clock.advance(unstamped), 0.25);
+    }
+    
+    // ========================================
+    // Input Recording Tests
+    // ========================================
+    
+    void testRecordingRoundTrip()
+    {
+        NeoZ::InputRecorder recorder;
+        const int64_t t0 = 1'000'000'000;
+        recorder.append(t0, 3, -2);
+        recorder.append(t0 + 125'000, -70000, 1);     // 8 kHz gap, large delta
+        recorder.append(t0 + 1'125'000, 0, 0);
+        QCOMPARE(recorder.eventCount(), uint64_t(3));
+        
+        NeoZ::InputRecording recording;
+        QVERIFY(recording.fromBytes(recorder.bytes()));
+        QCOMPARE(recording.eventCount(), uint64_t(3));
+        
+        auto events = recording.decodeAll();
+        QCOMPARE(events.size(), size_t(3));
+        QCOMPARE(events[1].deltaX, -70000.0);
+        QCOMPARE(events[1].deltaY, 1.0);
+        QCOMPARE(events[2].timestamp.time_since_epoch().count() - events[0].timestamp.time_since_epoch().count(),
+                 std::chrono::steady_clock::duration(std::chrono::nanoseconds(1'125'000)).count());
+        
+        // Truncated streams stop cleanly
+        std::vector<uint8_t> truncated = recorder.bytes();
+        truncated.resize(truncated.size() - 2);
+        NeoZ::InputRecording partial;
+        QVERIFY(partial.fromBytes(truncated));
+        QVERIFY(partial.decodeAll().size() < 3);
+    }
+    
+    void testRecordingFixedCapacity()
+    {
+        // A full recorder drops and counts instead of growing
+        NeoZ::InputRecorder recorder(256);
+        for (int i = 0; i < 1000; ++i) {
+            recorder.append(int64_t(i) * 1'000'000, i, -i);
+        }
+        QVERIFY(recorder.eventCount() > 0);
+        QVERIFY(recorder.eventCount() < 1000);
+        QCOMPARE(recorder.eventCount() + recorder.droppedCount(), uint64_t(1000));
+        QVERIFY(recorder.byteSize() <= recorder.capacity());
+        QCOMPARE(recorder.capacity(), size_t(256));
+        
+        NeoZ::InputRecording recording;
+        QVERIFY(recording.fromBytes(recorder.bytes()));
+        QCOMPARE(recording.decodeAll().size(), size_t(recorder.eventCount()));
+    }
+    
+    void testRecordReplayRoundTrip()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath("session.nzir");
+        
+        // Record into the mapped file, as the hook does
+        NeoZ::InputRecorder recorder;
+        QVERIFY(recorder.open(path, 1 << 16));
+        QVERIFY(recorder.isMapped());
+        int64_t ns = 5'000'000'000;
+        for (int i = 0; i < 2000; ++i) {
+            ns += 125'000 * (1 + i % 8);
+            recorder.append(ns, (i % 23) - 11, (i % 7) - 3);
+        }
+        
+        // Still open (as after a crash): everything recorded so far is readable
+        {
+            NeoZ::InputRecording live;
+            QVERIFY(live.open(path));
+            QCOMPARE(live.eventCount(), uint64_t(2000));
+            QCOMPARE(live.decodeAll().size(), size_t(2000));
+        }
+        
+        const size_t recordedBytes = recorder.byteSize();
+        QVERIFY(recorder.close());
+        QVERIFY(!recorder.isMapped());
+        QCOMPARE(QFileInfo(path).size(), qint64(recordedBytes));   // Trimmed
+        
+        NeoZ::InputRecording recording;
+        QVERIFY(recording.open(path));
+        const std::vector<NeoZ::InputState> events = recording.decodeAll();
+        QCOMPARE(events.size(), size_t(2000));
+        QCOMPARE(events.back().timestamp.time_since_epoch(),
+                 std::chrono::steady_clock::duration(std::chrono::nanoseconds(ns)));
+        
+        // Replay equals feeding the same events to process() directly
+        auto configure = [](NeoZ::SensitivityPipeline& p) {
+            p.setInputAuthorityEnabled(true);
+            p.setSensitivityX(1.4);
+            p.setSmoothingMs(30.0);
+        };
+        NeoZ::SensitivityPipeline replayed, direct, again;
+        configure(replayed);
+        configure(direct);
+        configure(again);
+        
+        std::vector<NeoZ::InputState> outputs;
+        const NeoZ::InputReplay::Result result = NeoZ::InputReplay::run(recording, replayed, &outputs);
+        QCOMPARE(result.events, uint64_t(2000));
+        QCOMPARE(outputs.size(), events.size());
+        for (size_t i = 0; i < events.size(); ++i) {
+            const NeoZ::InputState expected = direct.process(events[i]);
+            QVERIFY(std::memcmp(&outputs[i].deltaX, &expected.deltaX, sizeof(double)) == 0);
+            QVERIFY(std::memcmp(&outputs[i].deltaY, &expected.deltaY, sizeof(double)) == 0);
+        }
+        
+        // Deterministic across runs
+        QCOMPARE(NeoZ::InputReplay::run(recording, again).outputHash, result.outputHash);
+    }
+    
+    // ========================================
+    // Batch Path Tests
+    // ========================================
+    
+    void testBatchMatchesProcess()
+    {
+        // Same settings on both pipelines, non-trivial stages enabled
+        auto configure = [](NeoZ::SensitivityPipeline& p) {
+            p.setInputAuthorityEnabled(true);
+            p.setSensitivityX(1.3);
+            p.setSensitivityY(0.9);
+            p.setAxisMultiplierX(1.1);
+            p.setAxisMultiplierY(1.2);
+            p.setSmoothingMs(40.0);
+            p.setSlowZonePercent(35.0);
+        };
+        NeoZ::SensitivityPipeline single, batched;
+        configure(single);
+        configure(batched);
+        
+        // Deterministic 1-8 kHz stream with direction changes and idle gaps
+        std::vector<NeoZ::InputState> events(997);
+        int64_t ns = 1'000'000'000;
+        for (size_t i = 0; i < events.size(); ++i) {
+            ns += (i % 50 == 0) ? 30'000'000 : 125'000 * int64_t(1 + i % 8);
+            events[i].timestamp = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(ns));
+            events[i].deltaX = std::sin(i * 0.07) * (1 + i % 13);
+            events[i].deltaY = std::cos(i * 0.05) * (i % 5) - 1.0;
+        }
+        
+        std::vector<NeoZ::InputState> expected(events.size());
+        for (size_t i = 0; i < events.size(); ++i) {
+            expected[i] = single.process(events[i]);
+        }
+        
+        // Uneven chunking exercises state carried across batches
+        std::vector<NeoZ::InputState> actual(events.size());
+        const size_t chunks[] = {1, 7, 64, 3, 256};
+        size_t offset = 0;
+        for (size_t c = 0; offset < events.size(); ++c) {
+            const size_t n = std::min(chunks[c % 5], events.size() - offset);
+            batched.processBatch(std::span<const NeoZ::InputState>(events.data() + offset, n),
+                                 std::span<NeoZ::InputState>(actual.data() + offset, n));
+            offset += n;
+        }
+        
+        for (size_t i = 0; i < events.size(); ++i) {
+            QVERIFY(std::memcmp(&actual[i].deltaX, &expected[i].deltaX, sizeof(double)) == 0);
+            QVERIFY(std::memcmp(&actual[i].deltaY, &expected[i].deltaY, sizeof(double)) == 0);
+            QVERIFY(std::memcmp(&actual[i].velocity, &expected[i].velocity, sizeof(double)) == 0);
+            QCOMPARE(actual[i].timestamp, expected[i].timestamp);
+            QCOMPARE(actual[i].stage, expected[i].stage);
+        }
+    }
+    
+    void testPassthroughIsRaw()
+    {
+        // Input Authority OFF: raw deltas out, stage Raw on both paths
+        NeoZ::SensitivityPipeline pipeline;
+        NeoZ::InputState event;
+        event.deltaX = 3.0;
+        event.deltaY = -4.0;
+        event.stage = NeoZ::InputState::Final;
+        
+        const NeoZ::InputState single = pipeline.process(event);
+        QCOMPARE(single.deltaX, 3.0);
+        QCOMPARE(single.velocity, 5.0);
+        QCOMPARE(single.stage, NeoZ::InputState::Raw);
+        
+        NeoZ::InputState batched;
+        pipeline.processBatch(std::span<const NeoZ::InputState>(&event, 1), std::span<NeoZ::InputState>(&batched, 1));
+        QCOMPARE(batched.deltaY, -4.0);
+        QCOMPARE(batched.velocity, 5.0);
+        QCOMPARE(batched.stage, NeoZ::InputState::Raw);
+    }
 };
 
 QTEST_MAIN(TestSensitivityPipeline)